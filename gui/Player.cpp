@@ -292,6 +292,9 @@ Player::init_sound()
             return;
 #endif
 
+            _soundHandler->setDecodedSoundLimit(
+                    RcInitFile::getDefaultInstance().getSoundCacheLimit() * 1024);
+
         } catch (const SoundException& ex) {
             log_error(_("Could not create sound handler: %s."
                 " Will continue without sound."), ex.what());
@@ -0,0 +1,370 @@
+// bench.cpp: headless playback benchmark, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+// This program plays a movie as fast as possible without a window or an
+// audio device and prints how long each part of playback took as JSON:
+//
+//   gnash-bench [-n frames] [-p pixelformat] [-s scale] [-f] [-o file] movie
+//
+// The movie's own frame rate drives a ManualClock, so every run executes
+// exactly the same frames regardless of how fast the machine is.
+
+#ifdef HAVE_CONFIG_H
+#include "gnashconfig.h"
+#endif
+
+#ifndef RENDERER_AGG
+#error The benchmark requires the AGG renderer
+#endif
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <boost/intrusive_ptr.hpp>
+
+#ifndef HAVE_GETOPT_H
+#error The benchmark requires getopt.h
+#else
+#include <getopt.h>
+#endif
+
+#ifndef DREAMCAST
+#include <sys/resource.h>
+#endif
+
+#include "log.h"
+#include "rc.h"
+#include "URL.h"
+#include "GnashException.h"
+#include "ManualClock.h"
+#include "movie_root.h"
+#include "movie_definition.h"
+#include "MovieFactory.h"
+#include "RunResources.h"
+#include "StreamProvider.h"
+#include "NamingPolicy.h"
+#include "swf/TagLoadersTable.h"
+#include "swf/DefaultTagLoaders.h"
+#include "Renderer_agg.h"
+#include "snappingrange.h"
+#include "NullSoundHandler.h"
+#include "MediaHandler.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/// Microseconds elapsed since a time point.
+std::uint64_t
+since(const Clock::time_point& start)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now() - start).count();
+}
+
+/// The highest resident set size of this process, in KiB, or -1.
+long
+peakRSS()
+{
+#ifndef DREAMCAST
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) return usage.ru_maxrss;
+#endif
+    return -1;
+}
+
+/// Quote a string for JSON output.
+std::string
+quote(const std::string& s)
+{
+    std::string ret("\"");
+    for (const char c : s) {
+        switch (c) {
+            case '"':
+                ret += "\\\"";
+                break;
+            case '\\':
+                ret += "\\\\";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof buf, "\\u%04x", c);
+                    ret += buf;
+                }
+                else ret += c;
+        }
+    }
+    ret += '"';
+    return ret;
+}
+
+/// Time spent outside movie_root::advance(), in microseconds.
+struct FrameTimes
+{
+    FrameTimes()
+        :
+        invalidation(0),
+        rasterization(0),
+        sound(0),
+        total(0)
+    {}
+
+    std::uint64_t invalidation;
+    std::uint64_t rasterization;
+    std::uint64_t sound;
+    std::uint64_t total;
+};
+
+void
+usage(std::ostream& o)
+{
+    o << "Usage: gnash-bench [options] movie.swf\n"
+         "  -n frames   Number of frames to play (default 500)\n"
+         "  -p format   AGG pixel format (default as built)\n"
+         "  -s scale    Scale of the stage (default 1)\n"
+         "  -f          Render the whole stage every frame\n"
+         "  -o file     Write the results to a file instead of stdout\n"
+         "  -v          Print the log to stdout (use with -o)\n";
+}
+
+} // anonymous namespace
+
+int
+main(int argc, char* argv[])
+{
+    using namespace gnash;
+
+    std::ios::sync_with_stdio(false);
+
+    size_t frames = 500;
+#ifdef PIXELFORMAT_RGB565
+    std::string pixelFormat("RGB565");
+#else
+    std::string pixelFormat("RGBA32");
+#endif
+    float scale = 1.0f;
+    bool fullRedraw = false;
+    bool verbose = false;
+    std::string output;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:p:s:fo:vh")) != -1) {
+        switch (c) {
+            case 'n':
+                frames = std::strtoul(optarg, nullptr, 10);
+                break;
+            case 'p':
+                pixelFormat = optarg;
+                break;
+            case 's':
+                scale = std::strtof(optarg, nullptr);
+                break;
+            case 'f':
+                fullRedraw = true;
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            case 'h':
+                usage(std::cout);
+                return EXIT_SUCCESS;
+            default:
+                usage(std::cerr);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if (optind >= argc || !frames || scale <= 0) {
+        usage(std::cerr);
+        return EXIT_FAILURE;
+    }
+
+    const std::string infile = argv[optind];
+
+    LogFile& dbglogfile = LogFile::getDefaultInstance();
+    dbglogfile.setVerbosity(verbose ? 1 : 0);
+
+    RunResources runResources;
+
+    std::shared_ptr<SWF::TagLoadersTable> loaders(
+            std::make_shared<SWF::TagLoadersTable>());
+    addDefaultLoaders(*loaders);
+    runResources.setTagLoaders(loaders);
+
+    const URL url(infile);
+    if (url.protocol() == "file") {
+        RcInitFile::getDefaultInstance().addLocalSandboxPath(url.path());
+    }
+
+    std::unique_ptr<NamingPolicy> np(new IncrementalRename(url));
+    runResources.setStreamProvider(std::make_shared<StreamProvider>(
+                url, url, std::move(np)));
+
+    std::shared_ptr<media::MediaHandler> mediaHandler(
+            media::MediaFactory::instance().get(""));
+    runResources.setMediaHandler(mediaHandler);
+
+    // Mixing is done here, as the audio callback would do it.
+    std::shared_ptr<sound::sound_handler> soundHandler(
+            new sound::NullSoundHandler(mediaHandler.get()));
+    soundHandler->unpause();
+    runResources.setSoundHandler(soundHandler);
+
+    std::shared_ptr<Renderer_agg_base> renderer(
+            create_Renderer_agg(pixelFormat.c_str()));
+    if (!renderer) {
+        std::cerr << "Unsupported pixel format " << pixelFormat << "\n";
+        return EXIT_FAILURE;
+    }
+    runResources.setRenderer(renderer);
+
+    const Clock::time_point loadStart = Clock::now();
+
+    boost::intrusive_ptr<movie_definition> md;
+    try {
+        md = MovieFactory::makeMovie(url, runResources, nullptr, false);
+    }
+    catch (const GnashException& e) {
+        std::cerr << e.what() << "\n";
+    }
+    if (!md) {
+        std::cerr << "Could not load movie '" << infile << "'\n";
+        return EXIT_FAILURE;
+    }
+
+    // Parse the whole movie before starting, so that loading doesn't
+    // interfere with the timings.
+    md->completeLoad();
+    md->ensure_frame_loaded(md->get_frame_count());
+    const std::uint64_t loadTime = since(loadStart);
+
+    const size_t width = std::max<size_t>(1, md->get_width_pixels() * scale);
+    const size_t height = std::max<size_t>(1, md->get_height_pixels() * scale);
+    const size_t stride = width * ((renderer->getBytesPerPixel() * 8 + 7) / 8);
+
+    std::unique_ptr<unsigned char[]> buffer(
+            new unsigned char[stride * height]);
+    renderer->init_buffer(buffer.get(), stride * height, width, height, stride);
+    renderer->set_scale(scale, scale);
+
+    const float rate = md->get_frame_rate();
+    const unsigned int interval = rate > 0 ? std::max(1.0f, 1000 / rate) : 83;
+
+    // 44.1 kHz stereo, as the sound handler mixes it.
+    const unsigned int samplesPerFrame = 44100 * 2 * interval / 1000;
+    std::unique_ptr<std::int16_t[]> samples(
+            new std::int16_t[samplesPerFrame]);
+
+    movie_root::AdvanceTimes advanceTimes;
+    FrameTimes frameTimes;
+
+    {
+        ManualClock clock;
+        movie_root root(clock, runResources);
+
+        root.init(md.get(), MovieClip::MovieVariables());
+        root.set_background_alpha(1.0f);
+        root.setDimensions(width, height);
+        root.recordAdvanceTimes(&advanceTimes);
+
+        const Clock::time_point start = Clock::now();
+
+        for (size_t i = 0; i < frames; ++i) {
+
+            clock.advance(interval);
+            root.advance();
+
+            Clock::time_point t = Clock::now();
+
+            InvalidatedRanges ranges;
+            if (fullRedraw) ranges.setWorld();
+            else {
+                ranges.setSnapFactor(1.3f);
+                ranges.setSingleMode(false);
+                root.add_invalidated_bounds(ranges, false);
+                ranges.growBy(40.0f / scale);
+                ranges.combineRanges();
+            }
+            frameTimes.invalidation += since(t);
+
+            t = Clock::now();
+            if (!ranges.isNull()) {
+                renderer->set_invalidated_regions(ranges);
+                root.display();
+            }
+            frameTimes.rasterization += since(t);
+
+            t = Clock::now();
+            soundHandler->fetchSamples(samples.get(), samplesPerFrame);
+            frameTimes.sound += since(t);
+        }
+
+        frameTimes.total = since(start);
+        root.recordAdvanceTimes(nullptr);
+    }
+
+    MovieFactory::clear();
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output.c_str());
+        if (!file) {
+            std::cerr << "Could not write to '" << output << "'\n";
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+
+    const double seconds = frameTimes.total / 1e6;
+
+    out << "{\n"
+        << "  \"movie\": " << quote(infile) << ",\n"
+        << "  \"renderer\": \"agg\",\n"
+        << "  \"pixel_format\": " << quote(pixelFormat) << ",\n"
+        << "  \"width\": " << width << ",\n"
+        << "  \"height\": " << height << ",\n"
+        << "  \"frame_rate\": " << rate << ",\n"
+        << "  \"frames\": " << frames << ",\n"
+        << "  \"full_redraw\": " << (fullRedraw ? "true" : "false") << ",\n"
+        << "  \"load_us\": " << loadTime << ",\n"
+        << "  \"phases_us\": {\n"
+        << "    \"display_list\": " << advanceTimes.displayList << ",\n"
+        << "    \"actions\": " << advanceTimes.actions << ",\n"
+        << "    \"gc\": " << advanceTimes.collect << ",\n"
+        << "    \"invalidation\": " << frameTimes.invalidation << ",\n"
+        << "    \"rasterization\": " << frameTimes.rasterization << ",\n"
+        << "    \"sound\": " << frameTimes.sound << "\n"
+        << "  },\n"
+        << "  \"total_us\": " << frameTimes.total << ",\n"
+        << "  \"fps\": " << (seconds > 0 ? frames / seconds : 0) << ",\n"
+        << "  \"peak_rss_kb\": " << peakRSS() << "\n"
+        << "}\n";
+
+    return EXIT_SUCCESS;
+}
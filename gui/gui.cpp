@@ -1157,6 +1157,18 @@ Gui::getMovieInfo() const
                     std::make_pair(lbl + typ, ss.str()));
     }
 
+    // Allocation of the collectables; these are shared by all GCs.
+    GcArena::Stats as;
+    GcArena::getStats(as);
+
+    const std::string arenaLbl = "GC arena ";
+    for (auto& arenainfo : as) {
+        std::ostringstream ss;
+        ss << arenainfo.second;
+        firstLevelIter = tr->append_child(topIter,
+                    std::make_pair(arenaLbl + arenainfo.first, ss.str()));
+    }
+
     tr->sort(firstLevelIter.begin(), firstLevelIter.end());
 
     return tr;
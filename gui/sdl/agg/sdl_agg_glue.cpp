@@ -19,9 +19,13 @@
 //
 
 #include "sdl_agg_glue.h"
+#include "sdl_agg_scaler.h"
 #include "log.h"
+#include "rc.h"
 #include "Renderer.h"
 #include "Renderer_agg.h"
+#include <algorithm>
+#include <cstring>
 #include <cerrno>
 #include <ostream>
 
@@ -41,29 +45,17 @@ int toscaleup = 0;
 #endif
 
 
-/* alekmaul's scaler taken from mame4all */
-static inline void bitmap_scale(uint32_t startx, uint32_t starty, uint32_t viswidth, uint32_t visheight, uint32_t newwidth, uint32_t newheight,uint32_t pitchsrc,uint32_t pitchdest, uint16_t* src, uint16_t* dst)
+/* Copy a rectangle between surfaces of the same pixel format. */
+static inline void copy_rect(const SDL_Rect& rect, int bytes, const uint8_t* src, int pitchsrc, uint8_t* dst, int pitchdest)
 {
-    uint32_t W,H,ix,iy,x,y;
-    x=startx<<16;
-    y=starty<<16;
-    W=newwidth;
-    H=newheight;
-    ix=(viswidth<<16)/W;
-    iy=(visheight<<16)/H;
-
-    do 
+    src+=rect.y*pitchsrc+rect.x*bytes;
+    dst+=rect.y*pitchdest+rect.x*bytes;
+    for (int y=0; y<rect.h; ++y)
     {
-        uint16_t* buffer_mem=&src[(y>>16)*pitchsrc];
-        W=newwidth; x=startx<<16;
-        do 
-        {
-            *dst++=buffer_mem[x>>16];
-            x+=ix;
-        } while (--W);
+        memcpy(dst, src, rect.w*bytes);
+        src+=pitchsrc;
         dst+=pitchdest;
-        y+=iy;
-    } while (--H);
+    }
 }
 
 void Exit_App()
@@ -86,10 +78,15 @@ namespace gnash
 
 SdlAggGlue::SdlAggGlue()
 	:
-//_sdl_surface(nullptr),
+_sdl_surface(nullptr),
 _offscreenbuf(nullptr),
 _screen(nullptr),
-_agg_renderer(nullptr)
+_agg_renderer(nullptr),
+_scaled(false),
+_direct(false),
+_buffers(1),
+_cursorShown(false),
+_cursorStale(false)
 {
 //    GNASH_REPORT_FUNCTION;
 }
@@ -99,13 +96,11 @@ SdlAggGlue::~SdlAggGlue()
 //    GNASH_REPORT_FUNCTION;
     //SDL_FreeSurface(_sdl_surface);
 	//SDL_FreeSurface(_screen);
-	#ifdef OPENDINGUX
     if (_sdl_surface != nullptr)
     {
 		SDL_FreeSurface(_sdl_surface);
 		_sdl_surface = nullptr;
 	}
-	#endif
     if (rl_screen != nullptr)
     {
 		SDL_FreeSurface(rl_screen);
@@ -163,22 +158,22 @@ SdlAggGlue::prepDrawingArea(int width, int height, std::uint32_t sdl_flags)
     #if !defined(NOHIDEMOUSE)
     SDL_ShowCursor(SDL_DISABLE);
     #endif
-	_sdl_surface = SDL_CreateRGBSurface(SDL_HWSURFACE, width, height, _bpp, 0,0,0,0);
+	const std::uint32_t video_flags = SDL_HWSURFACE | (sdl_flags & SDL_DOUBLEBUF);
 	#ifdef OPENDINGUX
 	toscaleup = 0;
-	rl_screen = SDL_SetVideoMode(width, height, _bpp, SDL_HWSURFACE);
+	rl_screen = SDL_SetVideoMode(width, height, _bpp, video_flags);
 	if (!rl_screen)
 	{
-		rl_screen = SDL_SetVideoMode(width, height + 1, _bpp, SDL_HWSURFACE);
+		rl_screen = SDL_SetVideoMode(width, height + 1, _bpp, video_flags);
 		if (!rl_screen)
 		{
 			toscaleup = 1;
-			rl_screen = SDL_SetVideoMode(0, 0, _bpp, SDL_HWSURFACE);
+			rl_screen = SDL_SetVideoMode(0, 0, _bpp, video_flags);
 		}
 	}
 	#else
     //_screen = SDL_SetVideoMode(width, height, _bpp, sdl_flags | SDL_SWSURFACE);
-    rl_screen = SDL_SetVideoMode(0, 0, _bpp, SDL_HWSURFACE);
+    rl_screen = SDL_SetVideoMode(0, 0, _bpp, video_flags);
     #endif
 
 	SDL_Surface* tmp = SDL_LoadBMP("cursor.bmp"); /* Automatically frees the RWops struct for us */
@@ -192,6 +187,28 @@ SdlAggGlue::prepDrawingArea(int width, int height, std::uint32_t sdl_flags)
     hw_width = rl_screen->w;
     hw_height = rl_screen->h;
 
+	#ifdef OPENDINGUX
+	_scaled = toscaleup;
+	#else
+	_scaled = (hw_width != width || hw_height != height);
+	#endif
+	_buffers = (rl_screen->flags & SDL_DOUBLEBUF) ? 2 : 1;
+
+	if (_scaled)
+	{
+		const SdlAggScaler::Filter filter =
+			RcInitFile::getDefaultInstance().useSmoothScaling() ?
+			SdlAggScaler::FILTER_BILINEAR : SdlAggScaler::FILTER_NEAREST;
+		_scaler.reset(new SdlAggScaler(_bpp, width, height, hw_width,
+			hw_height, filter));
+	}
+
+	// A single unscaled screen can be rendered to directly instead of
+	// copying each frame to it.
+	_direct = !_scaled && _buffers == 1 && !SDL_MUSTLOCK(rl_screen) &&
+		rl_screen->format->BitsPerPixel == _bpp &&
+		rl_screen->pitch == width * depth_bytes;
+
     
     //_screen = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, _bpp, 0,0,0,0);
 
@@ -230,11 +247,19 @@ SdlAggGlue::prepDrawingArea(int width, int height, std::uint32_t sdl_flags)
 	#define CHUNK_SIZE (100 * 100 * depth_bytes)
 
 	int bufsize = static_cast<int>(width * height * depth_bytes / CHUNK_SIZE + 1) * CHUNK_SIZE;
-	_offscreenbuf = (unsigned char*)_sdl_surface->pixels;
+	if (_direct)
+	{
+		_offscreenbuf = (unsigned char*)rl_screen->pixels;
+	}
+	else
+	{
+		_sdl_surface = SDL_CreateRGBSurface(SDL_HWSURFACE, width, height, _bpp, 0,0,0,0);
+		_offscreenbuf = (unsigned char*)_sdl_surface->pixels;
+		stride = _sdl_surface->pitch;
+	}
 	Renderer_agg_base * renderer =
 	static_cast<Renderer_agg_base *>(_agg_renderer);
-	renderer->init_buffer(_offscreenbuf, bufsize, width, height,
-	width*((_bpp+7)/8));
+	renderer->init_buffer(_offscreenbuf, bufsize, width, height, stride);
 
 	/*
     _sdl_surface = SDL_CreateRGBSurfaceFrom((void *) _offscreenbuf, width, height,
@@ -251,6 +276,9 @@ SdlAggGlue::prepDrawingArea(int width, int height, std::uint32_t sdl_flags)
 void
 SdlAggGlue::setInvalidatedRegions(const InvalidatedRanges& ranges)
 {
+    // The cursor must not be left in a frame rendered on the screen.
+    if (_cursorShown) hideCursor();
+
     _agg_renderer->set_invalidated_regions(ranges);
     _drawbounds.clear();
     
@@ -270,75 +298,159 @@ SdlAggGlue::setInvalidatedRegions(const InvalidatedRanges& ranges)
 void
 SdlAggGlue::render()
 {
-    if (_drawbounds.empty()) return; // nothing to do..
-    
-    for (unsigned int bno=0; bno < _drawbounds.size(); bno++) {
-        geometry::Range2d<int>& bounds = _drawbounds[bno];
-        render(bounds.getMinX(), bounds.getMinY(),
-            bounds.getMaxX(), bounds.getMaxY() );
+    Rects rects;
+    rects.reserve(_drawbounds.size() + 2);
+
+    for (const geometry::Range2d<int>& bounds : _drawbounds) {
+        const SDL_Rect r = toScreen(bounds.getMinX(), bounds.getMinY(),
+            bounds.getMaxX(), bounds.getMaxY());
+        if (r.w && r.h) rects.push_back(r);
     }
+    present(rects);
 }
 
-int old_x, old_y;
-int firstime = 0;
 void
 SdlAggGlue::render(int minx, int miny, int maxx, int maxy)
 {
-    // Update only the invalidated rectangle
-   // SDL_BlitSurface(_sdl_surface, nullptr, _screen, nullptr);
-   
-   #ifdef OPENDINGUX
-	SDL_Rect clip = { minx, miny, maxx - minx, maxy - miny};
-	SDL_Rect position;
-	if (toscaleup == 1)
-	{
-	   bitmap_scale(0, 0, internal_width, internal_height, rl_screen->w, rl_screen->h, internal_width,0, (uint16_t*)_offscreenbuf, (uint16_t*)rl_screen->pixels);
-	   //SDL_SoftStretch(_sdl_surface, NULL, rl_screen, NULL);
-	   if (mouse_mode == 1)
-	   {
-			position.x = mouse_x;
-			position.y = mouse_y;
-			SDL_BlitSurface(cursor_sdl, nullptr, rl_screen, &position);
-		}
-		SDL_UpdateRect(rl_screen, 0, 0, 0, 0);
-	}
-	else
-	{
-		memcpy(rl_screen->pixels, _sdl_surface->pixels, (rl_screen->w * rl_screen->h) *2);
-		if (mouse_mode == 1)
-		{
-			SDL_SetClipRect(rl_screen, NULL);
-			position.x = mouse_x;
-			position.y = mouse_y;
-			SDL_BlitSurface(cursor_sdl, nullptr, rl_screen, &position);
-			SDL_UpdateRect(rl_screen, 0, 0, 0, 0);
-		}
-		else
-		{
-			SDL_SetClipRect(rl_screen, &clip);
-			SDL_UpdateRect(rl_screen, clip.x, clip.y, clip.w, clip.h);
-		}
-	}
-   #else
-   bitmap_scale(0, 0, internal_width, internal_height, rl_screen->w, rl_screen->h, internal_width,0, (uint16_t*)_offscreenbuf, (uint16_t*)rl_screen->pixels);
-   //SDL_SoftStretch(_sdl_surface, NULL, rl_screen, NULL);
-   if (mouse_mode == 1)
-   {
-		SDL_Rect position;
-		position.x = mouse_x;
-		position.y = mouse_y;
-		if (cursor_sdl)
-		SDL_BlitSurface(cursor_sdl, nullptr, rl_screen, &position);
-		else
-		{
-			position.w = 4;
-			position.h = 4;
-			SDL_FillRect(rl_screen, &position, 512);
-		}
-	}
-	SDL_Flip(rl_screen);
-	#endif
-    //SDL_UpdateRect(_screen, clip.x, clip.y, clip.w, clip.h);
+    Rects rects;
+    const SDL_Rect r = toScreen(minx, miny, maxx, maxy);
+    if (r.w && r.h) rects.push_back(r);
+    present(rects);
+}
+
+void
+SdlAggGlue::present(Rects& rects)
+{
+    if (_cursorShown) hideCursor();
+    if (_cursorStale) {
+        rects.push_back(_cursor);
+        _cursorStale = false;
+    }
+
+    // With two buffers, the one drawn now last showed the frame before
+    // the previous one, so it also misses the previous frame's changes.
+    Rects copies(rects);
+    if (_buffers > 1) {
+        copies.insert(copies.end(), _lastDamage.begin(), _lastDamage.end());
+    }
+
+    if (!_direct && !copies.empty()) {
+        if (SDL_MUSTLOCK(rl_screen)) SDL_LockSurface(rl_screen);
+        for (const SDL_Rect& r : copies) copyToScreen(r);
+        if (SDL_MUSTLOCK(rl_screen)) SDL_UnlockSurface(rl_screen);
+    }
+
+    showCursor(rects);
+
+    if (_buffers > 1) {
+        if (copies.empty() && rects.empty()) return;
+        _lastDamage.swap(rects);
+        SDL_Flip(rl_screen);
+        return;
+    }
+
+    if (rects.empty()) return;
+    SDL_UpdateRects(rl_screen, rects.size(), &rects.front());
+}
+
+void
+SdlAggGlue::copyToScreen(const SDL_Rect& rect)
+{
+    if (_scaler) {
+        _scaler->scale(rect, _sdl_surface->pixels, _sdl_surface->pitch,
+            rl_screen->pixels, rl_screen->pitch);
+        return;
+    }
+
+    copy_rect(rect, rl_screen->format->BytesPerPixel,
+        static_cast<const uint8_t*>(_sdl_surface->pixels),
+        _sdl_surface->pitch, static_cast<uint8_t*>(rl_screen->pixels),
+        rl_screen->pitch);
+}
+
+SDL_Rect
+SdlAggGlue::toScreen(int minx, int miny, int maxx, int maxy) const
+{
+    int x0 = minx, y0 = miny, x1 = maxx + 1, y1 = maxy + 1;
+    int w = std::min(internal_width, hw_width);
+    int h = std::min(internal_height, hw_height);
+
+    if (_scaled) {
+        // Include the screen pixels blended with the frame pixels
+        // around the rectangle, and round outwards.
+        x0 = (x0 - 1) * hw_width / internal_width - 1;
+        y0 = (y0 - 1) * hw_height / internal_height - 1;
+        x1 = ((x1 + 1) * hw_width + internal_width - 1) / internal_width + 1;
+        y1 = ((y1 + 1) * hw_height + internal_height - 1) / internal_height + 1;
+        w = hw_width;
+        h = hw_height;
+    }
+
+    x0 = std::max(x0, 0);
+    y0 = std::max(y0, 0);
+    x1 = std::min(x1, w);
+    y1 = std::min(y1, h);
+
+    SDL_Rect r;
+    r.x = x0;
+    r.y = y0;
+    r.w = std::max(x1 - x0, 0);
+    r.h = std::max(y1 - y0, 0);
+    return r;
+}
+
+void
+SdlAggGlue::hideCursor()
+{
+    if (_direct) {
+        const int bytes = rl_screen->format->BytesPerPixel;
+        SDL_Rect from = _cursor;
+        from.x = from.y = 0;
+        copy_rect(from, bytes,
+            reinterpret_cast<const uint8_t*>(&_underCursor.front()),
+            _cursor.w * bytes, static_cast<uint8_t*>(rl_screen->pixels) +
+            _cursor.y * rl_screen->pitch + _cursor.x * bytes,
+            rl_screen->pitch);
+    }
+    _cursorShown = false;
+    _cursorStale = true;
+}
+
+void
+SdlAggGlue::showCursor(Rects& rects)
+{
+    if (mouse_mode != 1) return;
+
+    SDL_Rect r;
+    r.x = mouse_x;
+    r.y = mouse_y;
+    r.w = std::max(0, std::min(cursor_sdl ? cursor_sdl->w : 4,
+                hw_width - mouse_x));
+    r.h = std::max(0, std::min(cursor_sdl ? cursor_sdl->h : 4,
+                hw_height - mouse_y));
+    if (!r.w || !r.h) return;
+
+    if (_direct) {
+        const int bytes = rl_screen->format->BytesPerPixel;
+        _underCursor.resize((r.w * r.h * bytes + 1) / 2);
+        SDL_Rect to = r;
+        to.x = to.y = 0;
+        copy_rect(to, bytes, static_cast<const uint8_t*>(rl_screen->pixels) +
+            r.y * rl_screen->pitch + r.x * bytes, rl_screen->pitch,
+            reinterpret_cast<uint8_t*>(&_underCursor.front()), r.w * bytes);
+    }
+
+    SDL_Rect position = r;
+    if (cursor_sdl) {
+        SDL_BlitSurface(cursor_sdl, nullptr, rl_screen, &position);
+    }
+    else {
+        SDL_FillRect(rl_screen, &position, 512);
+    }
+
+    _cursor = r;
+    _cursorShown = true;
+    rects.push_back(r);
 }
 
 } // namespace gnash
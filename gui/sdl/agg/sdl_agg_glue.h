@@ -19,12 +19,15 @@
 #include "sdl_glue.h"
 
 #include <vector>
+#include <memory>
 #include <SDL.h>
 #include <cstdint> // for boost::?int??_t
 
 namespace gnash
 {
 
+class SdlAggScaler;
+
 class SdlAggGlue : public SdlGlue
 {
   public:
@@ -36,9 +39,33 @@ class SdlAggGlue : public SdlGlue
     void setInvalidatedRegions(const InvalidatedRanges& ranges);
     bool prepDrawingArea(int width, int height, std::uint32_t sdl_flags);
     std::uint32_t maskFlags(std::uint32_t sdl_flags);
+
+    /// Show the invalidated regions of the last frame.
     void render();
+
+    /// Show a region of the frame, in frame pixels.
+    //
+    /// The mouse cursor is always updated too.
     void render(int minx, int miny, int maxx, int maxy);
+
   private:
+    typedef std::vector<SDL_Rect> Rects;
+
+    /// Show the given screen rectangles and the mouse cursor.
+    void present(Rects& rects);
+
+    /// Copy or scale a screen rectangle from the frame to the screen.
+    void copyToScreen(const SDL_Rect& rect);
+
+    /// The screen rectangle showing a rectangle of the frame.
+    SDL_Rect toScreen(int minx, int miny, int maxx, int maxy) const;
+
+    /// Remove the cursor from a frame rendered on the screen itself.
+    void hideCursor();
+
+    /// Draw the cursor if it is enabled, adding it to rects.
+    void showCursor(Rects& rects);
+
     SDL_Surface     *_sdl_surface;
     unsigned char   *_offscreenbuf;
     SDL_Surface     *_screen;
@@ -46,6 +73,34 @@ class SdlAggGlue : public SdlGlue
     
     geometry::Range2d<int> _validbounds;
     std::vector< geometry::Range2d<int> > _drawbounds;
+
+    /// Whether the frame is scaled to a screen of another size.
+    bool _scaled;
+
+    /// Scales the frame to the screen, if it is scaled.
+    std::unique_ptr<SdlAggScaler> _scaler;
+
+    /// Whether frames are rendered straight onto the screen.
+    bool _direct;
+
+    /// The number of screen buffers, 2 if flipping between two.
+    int _buffers;
+
+    /// The screen rectangles shown in the last frame. With two buffers,
+    /// these are out of date in the buffer drawn next.
+    Rects _lastDamage;
+
+    /// Where the cursor was last drawn.
+    SDL_Rect _cursor;
+
+    /// Whether the cursor is drawn on the screen.
+    bool _cursorShown;
+
+    /// Whether the screen must be updated where the cursor was.
+    bool _cursorStale;
+
+    /// The pixels under the cursor, when rendering onto the screen.
+    std::vector<std::uint16_t> _underCursor;
 };
 
 }
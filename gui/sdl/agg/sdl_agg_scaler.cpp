@@ -0,0 +1,282 @@
+// sdl_agg_scaler.cpp:  Frame scaling for the SDL AGG GUI, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010,
+//   2011 Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#include "sdl_agg_scaler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cassert>
+
+namespace gnash
+{
+
+namespace {
+
+/// RGB565 pixels, blended as 0000 0ggg ggg0 0000 rrrr r000 000b bbbb.
+//
+/// Each channel has five spare bits above it, enough for a weight of
+/// up to 32.
+struct RGB565
+{
+    typedef std::uint16_t Pixel;
+    typedef std::uint32_t Expanded;
+
+    static const int weightBits = 5;
+
+    static Expanded expand(Pixel p) {
+        return (p | (static_cast<Expanded>(p) << 16)) & 0x07e0f81f;
+    }
+
+    static Pixel pack(Expanded c) {
+        return c | (c >> 16);
+    }
+
+    static Expanded mix(Expanded a, Expanded b, unsigned w) {
+        return ((a * (32 - w) + b * w) >> 5) & 0x07e0f81f;
+    }
+};
+
+/// ARGB32 pixels, blended as four 16-bit lanes.
+struct ARGB32
+{
+    typedef std::uint32_t Pixel;
+    typedef std::uint64_t Expanded;
+
+    static const int weightBits = 8;
+
+    static Expanded expand(Pixel p) {
+        return (p & 0x00ff00ff) |
+            (static_cast<Expanded>(p & 0xff00ff00) << 24);
+    }
+
+    static Pixel pack(Expanded c) {
+        return (c & 0x00ff00ff) | ((c >> 24) & 0xff00ff00);
+    }
+
+    static Expanded mix(Expanded a, Expanded b, unsigned w) {
+        return ((a * (256 - w) + b * w) >> 8) & 0x00ff00ff00ff00ffULL;
+    }
+};
+
+template<typename Pixel>
+inline Pixel*
+row(std::uint8_t* buf, int pitch, int y)
+{
+    return reinterpret_cast<Pixel*>(buf + y * pitch);
+}
+
+template<typename Pixel>
+inline const Pixel*
+row(const std::uint8_t* buf, int pitch, int y)
+{
+    return reinterpret_cast<const Pixel*>(buf + y * pitch);
+}
+
+}
+
+SdlAggScaler::SdlAggScaler(int bpp, int srcWidth, int srcHeight,
+        int dstWidth, int dstHeight, Filter filter)
+    :
+    _bpp(bpp),
+    _filter(filter),
+    _xRatio(0)
+{
+    assert(bpp == 16 || bpp == 32);
+
+    const int weightBits = bpp == 16 ? RGB565::weightBits :
+        ARGB32::weightBits;
+
+    _columns = samples(srcWidth, dstWidth, filter, weightBits);
+    _rows = samples(srcHeight, dstHeight, filter, weightBits);
+
+    if (dstWidth % srcWidth == 0) _xRatio = dstWidth / srcWidth;
+}
+
+std::vector<SdlAggScaler::Sample>
+SdlAggScaler::samples(int src, int dst, Filter filter, int weightBits)
+{
+    std::vector<Sample> ret(dst);
+
+    for (int d = 0; d < dst; ++d) {
+        Sample& s = ret[d];
+
+        if (filter == FILTER_NEAREST) {
+            s.pos = static_cast<std::int64_t>(d) * src / dst;
+            s.next = s.pos;
+            s.weight = 0;
+            continue;
+        }
+
+        // Sample at the pixel's center, in 16.16 fixed point.
+        const std::int64_t pos = std::max<std::int64_t>(0,
+                ((2 * d + 1) * (static_cast<std::int64_t>(src) << 16)) /
+                (2 * dst) - 0x8000);
+        s.pos = std::min<std::int64_t>(pos >> 16, src - 1);
+        s.next = std::min(s.pos + 1, src - 1);
+        s.weight = ((pos & 0xffff) + (0x8000 >> weightBits)) >>
+            (16 - weightBits);
+    }
+    return ret;
+}
+
+template<>
+std::vector<std::uint32_t>*
+SdlAggScaler::lines<std::uint32_t>()
+{
+    return _lines32;
+}
+
+template<>
+std::vector<std::uint64_t>*
+SdlAggScaler::lines<std::uint64_t>()
+{
+    return _lines64;
+}
+
+void
+SdlAggScaler::scale(const SDL_Rect& rect, const void* src, int srcPitch,
+        void* dst, int dstPitch)
+{
+    if (!rect.w || !rect.h) return;
+
+    assert(rect.x + rect.w <= static_cast<int>(_columns.size()));
+    assert(rect.y + rect.h <= static_cast<int>(_rows.size()));
+
+    const std::uint8_t* from = static_cast<const std::uint8_t*>(src);
+    std::uint8_t* to = static_cast<std::uint8_t*>(dst);
+
+    if (_filter == FILTER_BILINEAR) {
+        if (_bpp == 16) bilinear<RGB565>(rect, from, srcPitch, to, dstPitch);
+        else bilinear<ARGB32>(rect, from, srcPitch, to, dstPitch);
+        return;
+    }
+
+    if (_bpp == 16) nearest<RGB565>(rect, from, srcPitch, to, dstPitch);
+    else nearest<ARGB32>(rect, from, srcPitch, to, dstPitch);
+}
+
+template<typename Format>
+void
+SdlAggScaler::nearest(const SDL_Rect& rect, const std::uint8_t* src,
+        int srcPitch, std::uint8_t* dst, int dstPitch) const
+{
+    typedef typename Format::Pixel Pixel;
+
+    const Sample* columns = &_columns[rect.x];
+    const Pixel* last = nullptr;
+
+    for (int y = rect.y; y < rect.y + rect.h; ++y) {
+
+        Pixel* to = row<Pixel>(dst, dstPitch, y) + rect.x;
+
+        // Rows from the same frame row are the same.
+        if (last && _rows[y].pos == _rows[y - 1].pos) {
+            std::memcpy(to, last, rect.w * sizeof(Pixel));
+            last = to;
+            continue;
+        }
+        last = to;
+
+        const Pixel* from = row<Pixel>(src, srcPitch, _rows[y].pos);
+
+        if (!_xRatio) {
+            for (int i = 0; i < rect.w; ++i) {
+                to[i] = from[columns[i].pos];
+            }
+            continue;
+        }
+
+        // Repeat each frame pixel _xRatio times.
+        const Pixel* end = to + rect.w;
+        int x = rect.x;
+        for (; to != end && x % _xRatio; ++x) {
+            *to++ = from[x / _xRatio];
+        }
+        from += x / _xRatio;
+        while (end - to >= _xRatio) {
+            const Pixel p = *from++;
+            for (int i = 0; i < _xRatio; ++i) *to++ = p;
+        }
+        while (to != end) *to++ = *from;
+    }
+}
+
+template<typename Format>
+void
+SdlAggScaler::bilinear(const SDL_Rect& rect, const std::uint8_t* src,
+        int srcPitch, std::uint8_t* dst, int dstPitch)
+{
+    typedef typename Format::Pixel Pixel;
+    typedef typename Format::Expanded Expanded;
+
+    const Sample* columns = &_columns[rect.x];
+
+    // Frame rows blended horizontally, reused by the screen rows
+    // between them.
+    std::vector<Expanded>* lines = this->lines<Expanded>();
+    lines[0].resize(rect.w);
+    lines[1].resize(rect.w);
+    int cached[2] = { -1, -1 };
+
+    const auto filterLine = [&](int y, std::vector<Expanded>& line) {
+        const Pixel* from = row<Pixel>(src, srcPitch, y);
+        for (int i = 0; i < rect.w; ++i) {
+            const Sample& s = columns[i];
+            line[i] = Format::mix(Format::expand(from[s.pos]),
+                    Format::expand(from[s.next]), s.weight);
+        }
+    };
+
+    for (int y = rect.y; y < rect.y + rect.h; ++y) {
+
+        const Sample& s = _rows[y];
+
+        if (cached[0] != s.pos) {
+            if (cached[1] == s.pos) {
+                lines[0].swap(lines[1]);
+                std::swap(cached[0], cached[1]);
+            }
+            else {
+                filterLine(s.pos, lines[0]);
+                cached[0] = s.pos;
+            }
+        }
+
+        Pixel* to = row<Pixel>(dst, dstPitch, y) + rect.x;
+        const Expanded* top = &lines[0].front();
+
+        if (!s.weight) {
+            for (int i = 0; i < rect.w; ++i) to[i] = Format::pack(top[i]);
+            continue;
+        }
+
+        if (cached[1] != s.next) {
+            filterLine(s.next, lines[1]);
+            cached[1] = s.next;
+        }
+        const Expanded* bottom = &lines[1].front();
+
+        for (int i = 0; i < rect.w; ++i) {
+            to[i] = Format::pack(Format::mix(top[i], bottom[i], s.weight));
+        }
+    }
+}
+
+} // namespace gnash
@@ -0,0 +1,107 @@
+// sdl_agg_scaler.h:  Frame scaling for the SDL AGG GUI, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010,
+//   2011 Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_SDL_AGG_SCALER_H
+#define GNASH_SDL_AGG_SCALER_H
+
+#include <vector>
+#include <cstdint>
+#include <boost/noncopyable.hpp>
+#include <SDL.h>
+
+namespace gnash
+{
+
+/// Scales frames rendered by AGG to the size of the screen.
+//
+/// The source pixel and filter weight of every screen column and row are
+/// computed once, when the sizes are known. Nearest scaling repeats
+/// pixels without any lookup when the screen is a whole number of times
+/// wider than the frame, and copies screen rows that come from the same
+/// frame row. Bilinear scaling blends all color channels of a pixel at
+/// once in a single integer register.
+class SdlAggScaler : boost::noncopyable
+{
+  public:
+
+    enum Filter
+    {
+        FILTER_NEAREST,
+        FILTER_BILINEAR
+    };
+
+    /// @param bpp      16 for RGB565 or 32 for ARGB32 pixels.
+    SdlAggScaler(int bpp, int srcWidth, int srcHeight, int dstWidth,
+            int dstHeight, Filter filter);
+
+    /// Scale part of a frame.
+    //
+    /// Every part is scaled exactly as it would be in the whole frame.
+    //
+    /// @param rect     The screen pixels to update. They must be within
+    ///                 the screen.
+    void scale(const SDL_Rect& rect, const void* src, int srcPitch,
+            void* dst, int dstPitch);
+
+  private:
+
+    /// Where a screen column or row samples the frame.
+    struct Sample
+    {
+        /// The nearest frame pixel, or the first of two to blend.
+        int pos;
+
+        /// The second frame pixel to blend.
+        int next;
+
+        /// The weight of the second pixel, in the format's weight range.
+        unsigned weight;
+    };
+
+    static std::vector<Sample> samples(int src, int dst, Filter filter,
+            int weightBits);
+
+    template<typename Format> void nearest(const SDL_Rect& rect,
+            const std::uint8_t* src, int srcPitch, std::uint8_t* dst,
+            int dstPitch) const;
+
+    template<typename Format> void bilinear(const SDL_Rect& rect,
+            const std::uint8_t* src, int srcPitch, std::uint8_t* dst,
+            int dstPitch);
+
+    /// Buffers for two horizontally filtered frame rows.
+    template<typename Expanded> std::vector<Expanded>* lines();
+
+    const int _bpp;
+    const Filter _filter;
+
+    std::vector<Sample> _columns;
+    std::vector<Sample> _rows;
+
+    /// The number of times the screen is wider than the frame, or 0 if
+    /// that isn't a whole number.
+    int _xRatio;
+
+    std::vector<std::uint32_t> _lines32[2];
+    std::vector<std::uint64_t> _lines64[2];
+};
+
+} // namespace gnash
+
+#endif
@@ -28,6 +28,7 @@
 #include "Range2d.h" // for Intersection of inv bounds
 #include "Renderer.h" // for setInvalidatedRegions
 #include "RunResources.h"
+#include "rc.h"
 
 extern int internal_width, internal_height, hw_width, hw_height;
 int mouse_mode = 0;
@@ -255,6 +256,10 @@ SDLGui::createWindow(const char *title, int width, int height,
         sdl_flags |= SDL_NOFRAME;
     }
 
+    if (RcInitFile::getDefaultInstance().useDoubleBuffer()) {
+        sdl_flags |= SDL_DOUBLEBUF;
+    }
+
     _glue.prepDrawingArea(_width, _height, sdl_flags);
 
     _runResources.setRenderer(_renderer);
@@ -57,6 +57,14 @@ public:
     /// A disposed CachedBitmap has no data and should not be rendered.
     virtual bool disposed() const = 0;
 
+    /// The CachedBitmap to draw.
+    //
+    /// Bitmaps created by a renderer return themselves. A bitmap that is
+    /// decoded on demand returns the renderer's bitmap, which is only
+    /// valid until the next frame is displayed, or null if it cannot be
+    /// decoded.
+    virtual const CachedBitmap* renderable() const { return this; }
+
 };
 	
 } // namespace gnash
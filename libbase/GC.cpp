@@ -20,6 +20,8 @@
 #include "GC.h"
 
 #include <cstdlib>
+#include <chrono>
+#include <initializer_list>
 
 #include "utility.h" // for typeName()
 #include "GnashAlgorithm.h"
@@ -31,13 +33,40 @@
 
 namespace gnash {
 
+namespace {
+
+/// Default time allowed for sweeping per frame, in microseconds.
+const std::uint64_t defaultTimeBudget = 2000;
+
+/// Number of objects swept between checks of the clock.
+const size_t sweepBatch = 64;
+
+inline std::uint64_t
+now()
+{
+    typedef std::chrono::steady_clock Clock;
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now().time_since_epoch()).count();
+}
+
+}
+
+unsigned int GC::_markEpoch = 0;
+
 GC::GC(GcRoot& root)
     :
     // might raise the default ...
     _maxNewCollectablesCount(64),
-    _resListSize(0),
+    _timeBudget(defaultTimeBudget),
+    _young(nullptr),
+    _old(nullptr),
+    _youngSize(0),
+    _oldSize(0),
     _root(root),
-    _lastResCount(0)
+    _lastMark(0),
+    _sweeping(false),
+    _sweepAgain(false),
+    _sweepPos(&_old)
 #ifdef GNASH_GC_DEBUG 
     , _collectorRuns(0)
 #endif
@@ -50,6 +79,10 @@ GC::GC(GcRoot& root)
         const size_t gap = std::strtoul(gcgap, nullptr, 0);
         _maxNewCollectablesCount = gap;
     }
+    char* gcbudget = std::getenv("GNASH_GC_TIME_BUDGET");
+    if (gcbudget) {
+        _timeBudget = std::strtoul(gcbudget, nullptr, 0);
+    }
 }
 
 GC::~GC()
@@ -57,50 +90,103 @@ GC::~GC()
 #ifdef GNASH_GC_DEBUG 
     log_debug("GC deleted, deleting all managed resources - collector run %d times", _collectorRuns);
 #endif
-    for (ResList::const_iterator i = _resList.begin(), e = _resList.end();
-            i != e; ++i) {
-        delete *i;
+    for (const GcResource* list : { _young, _old }) {
+        while (list) {
+            const GcResource* res = list;
+            list = res->_gcNext;
+            delete res;
+        }
     }
 }
 
 size_t
-GC::cleanUnreachable()
+GC::sweepYoung()
 {
 
 #if (GNASH_GC_DEBUG > 1)
-    log_debug("GC: sweep scan started");
+    log_debug("GC: nursery sweep started");
+#endif
+
+    size_t deleted = 0;
+
+    const GcResource* next;
+    for (const GcResource* res = _young; res; res = next) {
+
+        next = res->_gcNext;
+
+        if (isGarbage(res)) {
+#if GNASH_GC_DEBUG > 1
+            log_debug("GC: recycling object %p (%s)", res, typeName(*res));
+#endif
+            ++deleted;
+            delete res;
+        }
+        else {
+            // Survivors move to the front of the old generation. This
+            // doesn't invalidate _sweepPos.
+            res->_gcNext = _old;
+            _old = res;
+            ++_oldSize;
+        }
+    }
+
+    _young = nullptr;
+    _youngSize = 0;
+
+#ifdef GNASH_GC_DEBUG 
+    log_debug("GC: recycled %d unreachable nursery resources, %d old",
+            deleted, _oldSize);
 #endif
 
+    return deleted;
+}
+
+size_t
+GC::sweepOld(std::uint64_t deadline)
+{
     size_t deleted = 0;
+    size_t swept = 0;
+
+    while (_sweeping) {
 
-    _resList.remove_if([&deleted](const GcResource* res) {
-        if (!res->isReachable()) {
+        const GcResource* res = *_sweepPos;
 
+        if (!res) {
+            if (_sweepAgain) {
+                _sweepAgain = false;
+                _sweepPos = &_old;
+                continue;
+            }
+            _sweeping = false;
+            break;
+        }
+
+        if (isGarbage(res)) {
 #if GNASH_GC_DEBUG > 1
             log_debug("GC: recycling object %p (%s)", res, typeName(*res));
 #endif
             ++deleted;
+            *_sweepPos = res->_gcNext;
+            --_oldSize;
             delete res;
-            return true;
         }
         else {
-            res->clearReachable();
-            return false;
+            _sweepPos = &res->_gcNext;
         }
-    });
 
-    _resListSize -= deleted;
+        if (deadline && !(++swept % sweepBatch) && now() >= deadline) break;
+    }
 
 #ifdef GNASH_GC_DEBUG 
-    log_debug("GC: recycled %d unreachable resources - %d left",
-            deleted, _resListSize);
+    log_debug("GC: recycled %d unreachable old resources - %d left%s",
+            deleted, _oldSize, _sweeping ? ", sweep pending" : "");
 #endif
 
     return deleted;
 }
 
 void 
-GC::runCycle()
+GC::collect(bool full)
 {
     //
     // Collection cycle
@@ -112,29 +198,51 @@ GC::runCycle()
 
 #ifdef GNASH_GC_DEBUG 
     log_debug("GC: collection cycle started - %d/%d new resources "
-            "allocated since last run (from %d to %d)",
-            _resListSize - _lastResCount, _maxNewCollectablesCount,
-            _lastResCount, _resListSize);
+            "allocated since last run, %d old",
+            _youngSize, _maxNewCollectablesCount, _oldSize);
 #endif // GNASH_GC_DEBUG
 
     // Mark all resources as reachable
     markReachable();
 
-    // clean unreachable resources, and mark the others as reachable again
-    cleanUnreachable();
+    // Clean unreachable new resources, and keep the others as old.
+    sweepYoung();
+
+    // Old resources found unreachable by this mark are swept either now
+    // or over the next frames. A pass already in progress continues, but
+    // must then look at the objects it has already passed again.
+    if (_sweeping) {
+        _sweepAgain = true;
+    }
+    else {
+        _sweeping = true;
+        _sweepPos = &_old;
+    }
 
-    _lastResCount = _resListSize;
+    if (full) {
+        // Sweep from the start, so that everything is done now.
+        _sweepAgain = false;
+        _sweepPos = &_old;
+        sweepOld(0);
+    }
+}
 
+void
+GC::runIncrement()
+{
+    if (!_sweeping || !_timeBudget) return;
+    sweepOld(now() + _timeBudget);
 }
 
 void
 GC::countCollectables(CollectablesCount& count) const
 {
-    for (const GcResource* resource : _resList) {
-        ++count[typeName(*resource)];
+    for (const GcResource* list : { _young, _old }) {
+        for (const GcResource* res = list; res; res = res->_gcNext) {
+            ++count[typeName(*res)];
+        }
     }
 }
 
 } // end of namespace gnash
 
-
@@ -29,12 +29,13 @@
 //   
 //#define GNASH_GC_DEBUG 1
 
-#include <forward_list>
+#include <cstdint>
 #include <map>
 #include <string>
 #include <cassert>
 
 #include "dsodefs.h"
+#include "GcArena.h"
 #ifdef GNASH_GC_DEBUG
 # include "log.h"
 # include "utility.h"
@@ -82,6 +83,15 @@ public:
     /// @param gc   The GC to register the resource with.
     GcResource(GC& gc);
 
+    /// Collectables are allocated from the GcArena.
+    static void* operator new(std::size_t size) {
+        return GcArena::allocate(size);
+    }
+
+    static void operator delete(void* p) {
+        GcArena::deallocate(p);
+    }
+
     /// Mark this resource as being reachable
     //
     /// This can trigger further marking of all resources reachable by this
@@ -89,33 +99,13 @@ public:
     //
     /// If the object wasn't reachable before, this call triggers
     /// scan of all contained objects too.
-    void setReachable() const {
+    void setReachable() const;
 
-        if (_reachable) {
-
-#if GNASH_GC_DEBUG > 2
-            log_debug(_("Instance %p of class %s already reachable, "
-                    "setReachable doing nothing"), (void*)this,
-                    typeName(*this));
-#endif
-            return;
-        }
-
-#if GNASH_GC_DEBUG  > 2
-        log_debug(_("Instance %p of class %s set to reachable, scanning "
-                "reachable resources from it"), (void*)this,
-                typeName(*this));
-#endif
-
-        _reachable = true;
-        markReachableResources();
-    }
-
-    /// Return true if this object is marked as reachable
-    bool isReachable() const { return _reachable; }
+    /// Return true if this object was found reachable by the last mark
+    bool isReachable() const;
 
     /// Clear the reachable flag
-    void clearReachable() const { _reachable = false; }
+    void clearReachable() const { _mark = 0; }
 
 protected:
 
@@ -129,12 +119,12 @@ protected:
     /// See setReachable(), which is the function to invoke
     /// against all reachable methods.
     ///
-    /// Feel free to assert(_reachable) in your implementation.
+    /// Feel free to assert(isReachable()) in your implementation.
     ///
     /// The default implementation doesn't mark anything.
     ///
     virtual void markReachableResources() const {
-        assert(_reachable);
+        assert(isReachable());
 #if GNASH_GC_DEBUG > 1
         log_debug(_("Class %s didn't override the markReachableResources() "
                     "method"), typeName(*this));
@@ -150,7 +140,17 @@ protected:
 
 private:
 
-    mutable bool _reachable;
+    /// The mark epoch in which this resource was last found reachable.
+    //
+    /// Using epochs rather than a flag means marks never need clearing,
+    /// so resources that are not swept in a cycle are not touched at all.
+    mutable unsigned int _mark;
+
+    /// The next resource in the GC's list of this resource's generation.
+    //
+    /// The lists are threaded through the resources themselves, so
+    /// walking them touches no memory but the resources.
+    mutable const GcResource* _gcNext;
 
 };
 
@@ -161,6 +161,17 @@ private:
 ///
 /// Their reachability is detected starting from a root, which in turn
 /// marks all reachable resources.
+//
+/// Collectables are kept in two generations. New collectables go to the
+/// nursery, which is swept at the end of every collection cycle; the
+/// survivors are moved to the old generation. Since most long-lived
+/// resources (display objects, class prototypes) end up there, the old
+/// generation is swept incrementally by runIncrement(), within a time
+/// budget, rather than during the cycle itself.
+//
+/// Marking is still done in one go: nothing in Gnash tells the collector
+/// when a reference is stored, so a mark interrupted by ActionScript
+/// execution could miss live resources.
 class DSOEXPORT GC
 {
 
@@ -198,11 +209,13 @@ public:
         assert(!item->isReachable());
 #endif
 
-        _resList.emplace_front(item); ++_resListSize;
+        item->_gcNext = _young;
+        _young = item;
+        ++_youngSize;
 
 #if GNASH_GC_DEBUG > 1
         log_debug(_("GC: collectable %p added, num collectables: %d"), item, 
-                _resListSize);
+                _youngSize + _oldSize);
 #endif
     }
 
@@ -230,7 +243,7 @@ public:
         //  - We run the cycle again if X new collectables were allocated
         //    since last cycle run. X defaults to maxNewCollectablesCount
         //    and can be changed by user (GNASH_GC_TRIGGER_THRESHOLD env
-        //    variable).
+        //    variable). New collectables are exactly the nursery.
         //
         // Possible improvements:
         //
@@ -238,24 +251,32 @@ public:
         //    runtime analisys
         //
 
-        if (_resListSize <  _lastResCount + _maxNewCollectablesCount) {
+        if (_youngSize < _maxNewCollectablesCount) {
 #if GNASH_GC_DEBUG  > 1
             log_debug(_("GC: collection cycle skipped - %d/%d new resources "
-                        "allocated since last run (from %d to %d)"),
-                    _resListSize-_lastResCount, _maxNewCollectablesCount,
-                    _lastResCount, _resListSize);
+                        "allocated since last run"),
+                    _youngSize, _maxNewCollectablesCount);
 #endif // GNASH_GC_DEBUG
             return;
         }
 
-        runCycle();
+        collect(_timeBudget == 0);
     }
 
     /// Run the collection cycle
     //
     /// Find all reachable collectables, destroy all the others.
     ///
-    void runCycle();
+    void runCycle() {
+        collect(true);
+    }
+
+    /// Continue sweeping the old generation, within the time budget
+    //
+    /// This is meant to be called once per frame. It does nothing if
+    /// there is no sweep pending or incremental collection is disabled
+    /// (GNASH_GC_TIME_BUDGET set to 0).
+    void runIncrement();
 
     typedef std::map<std::string, unsigned int> CollectablesCount;
 
@@ -264,38 +285,76 @@ public:
 
 private:
 
-    /// List of collectables
-    typedef std::forward_list<const GcResource*> ResList;
+    friend class GcResource;
 
     /// Mark all reachable resources
     void markReachable() {
 #if GNASH_GC_DEBUG > 2
         log_debug(_("GC %p: MARK SCAN"), (void*)this);
 #endif
+        if (!++_markEpoch) ++_markEpoch;
+        _lastMark = _markEpoch;
         _root.markReachableResources();
     }
 
-    /// Delete all unreachable objects, and mark the others unreachable again
+    /// Mark, sweep the nursery and start sweeping the old generation
+    //
+    /// @param full     Whether to sweep the old generation completely
+    ///                 before returning.
+    void collect(bool full);
+
+    /// Delete unreachable nursery objects and promote the others
     //
     /// @return number of objects deleted
-    size_t cleanUnreachable();
+    size_t sweepYoung();
+
+    /// Delete unreachable objects of the old generation
+    //
+    /// @param deadline     The time (in microseconds, see runIncrement())
+    ///                     at which to stop, or 0 to sweep everything.
+    /// @return             number of objects deleted
+    size_t sweepOld(std::uint64_t deadline);
+
+    /// Whether a resource was not reached by the last mark.
+    bool isGarbage(const GcResource* res) const {
+        return res->_mark != _lastMark;
+    }
+
+    /// The epoch of the mark in progress or last completed, for all GCs.
+    static unsigned int _markEpoch;
 
     /// Number of newly registered collectable since last collection run
     /// triggering next collection.
     size_t _maxNewCollectablesCount;
 
-    /// List of collectable resources
-    ResList _resList;
+    /// Time allowed for each runIncrement() call, in microseconds.
+    std::uint64_t _timeBudget;
+
+    /// Collectables registered since the last cycle
+    const GcResource* _young;
+
+    /// Collectables that survived at least one cycle
+    const GcResource* _old;
 
-    /// Size of the ResList to avoid the cost of computing it
-    ResList::size_type _resListSize;
+    /// Sizes of the lists to avoid the cost of computing them
+    size_t _youngSize;
+    size_t _oldSize;
 
     /// The GcRoot.
     GcRoot& _root;
 
-    /// Number of resources in collectable list at end of last
-    /// collect() call.
-    ResList::size_type _lastResCount;
+    /// The epoch of this collector's last mark.
+    unsigned int _lastMark;
+
+    /// Whether sweeping of the old generation is in progress
+    bool _sweeping;
+
+    /// Whether the old generation must be swept again from the start
+    /// once the pass in progress ends, because a cycle ran meanwhile.
+    bool _sweepAgain;
+
+    /// The link to the next old resource to sweep
+    const GcResource** _sweepPos;
 
 #ifdef GNASH_GC_DEBUG 
     /// Number of times the collector runs (stats/profiling)
@@ -306,11 +365,41 @@ private:
 
 inline GcResource::GcResource(GC& gc)
     :
-    _reachable(false)
+    _mark(0),
+    _gcNext(nullptr)
 {
     gc.addCollectable(this);
 }
 
+inline void
+GcResource::setReachable() const
+{
+    if (_mark == GC::_markEpoch) {
+
+#if GNASH_GC_DEBUG > 2
+        log_debug(_("Instance %p of class %s already reachable, "
+                "setReachable doing nothing"), (void*)this,
+                typeName(*this));
+#endif
+        return;
+    }
+
+#if GNASH_GC_DEBUG  > 2
+    log_debug(_("Instance %p of class %s set to reachable, scanning "
+            "reachable resources from it"), (void*)this,
+            typeName(*this));
+#endif
+
+    _mark = GC::_markEpoch;
+    markReachableResources();
+}
+
+inline bool
+GcResource::isReachable() const
+{
+    return _mark == GC::_markEpoch;
+}
+
 } // namespace gnash
 
 #endif // GNASH_GC_H
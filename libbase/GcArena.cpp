@@ -0,0 +1,225 @@
+// GcArena.cpp: size-class pool allocator for collectables, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#include "GcArena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <sstream>
+#include <iomanip>
+
+namespace gnash {
+
+namespace {
+
+/// Granularity of the size classes, which is also the alignment of
+/// the objects.
+const std::size_t granularity = 16;
+
+/// Number of size classes; larger objects go to the heap.
+const std::size_t numClasses = 32;
+
+/// Approximate size of a block.
+const std::size_t blockBytes = 16384;
+
+/// Minimum number of slots in a block.
+const std::size_t minSlots = 8;
+
+struct Block;
+
+/// Precedes every object, so that it can be found from its address.
+//
+/// Large objects have a null block.
+union Header
+{
+    Block* block;
+    Header* nextFree;
+    char align[granularity];
+};
+
+struct SizeClass
+{
+    /// Blocks with at least one free slot, in a doubly-linked list.
+    Block* partial;
+
+    size_t blocks;
+    size_t used;
+};
+
+struct Block
+{
+    SizeClass* cls;
+    Block* prev;
+    Block* next;
+    Header* free;
+    std::size_t used;
+    std::size_t capacity;
+};
+
+SizeClass classes[numClasses];
+
+/// Objects too large for a size class.
+size_t largeObjects;
+
+const std::size_t headerSize = sizeof(Header);
+const std::size_t blockHeaderSize =
+    (sizeof(Block) + granularity - 1) / granularity * granularity;
+
+inline std::size_t
+slotSize(const SizeClass& cls)
+{
+    return headerSize + (&cls - classes + 1) * granularity;
+}
+
+void
+linkPartial(Block* b)
+{
+    SizeClass& cls = *b->cls;
+    b->prev = nullptr;
+    b->next = cls.partial;
+    if (cls.partial) cls.partial->prev = b;
+    cls.partial = b;
+}
+
+void
+unlinkPartial(Block* b)
+{
+    SizeClass& cls = *b->cls;
+    if (b->prev) b->prev->next = b->next;
+    else cls.partial = b->next;
+    if (b->next) b->next->prev = b->prev;
+    b->prev = b->next = nullptr;
+}
+
+Block*
+newBlock(SizeClass& cls)
+{
+    const std::size_t slot = slotSize(cls);
+    const std::size_t n = std::max(minSlots, blockBytes / slot);
+
+    char* mem = static_cast<char*>(::operator new(blockHeaderSize + n * slot));
+
+    Block* b = new (mem) Block();
+    b->cls = &cls;
+    b->used = 0;
+    b->capacity = n;
+
+    // Thread the free list through the slots in address order.
+    char* p = mem + blockHeaderSize;
+    b->free = nullptr;
+    for (std::size_t i = n; i > 0; --i) {
+        Header* h = reinterpret_cast<Header*>(p + (i - 1) * slot);
+        h->nextFree = b->free;
+        b->free = h;
+    }
+
+    ++cls.blocks;
+    linkPartial(b);
+    return b;
+}
+
+void
+deleteBlock(Block* b)
+{
+    unlinkPartial(b);
+    --b->cls->blocks;
+    b->~Block();
+    ::operator delete(b);
+}
+
+}
+
+void*
+GcArena::allocate(std::size_t size)
+{
+    const std::size_t index = size ? (size - 1) / granularity : 0;
+
+    if (index >= numClasses) {
+        Header* h = static_cast<Header*>(::operator new(headerSize + size));
+        h->block = nullptr;
+        ++largeObjects;
+        return h + 1;
+    }
+
+    SizeClass& cls = classes[index];
+    Block* b = cls.partial ? cls.partial : newBlock(cls);
+
+    Header* h = b->free;
+    b->free = h->nextFree;
+    h->block = b;
+
+    ++b->used;
+    ++cls.used;
+    if (!b->free) unlinkPartial(b);
+
+    return h + 1;
+}
+
+void
+GcArena::deallocate(void* p)
+{
+    if (!p) return;
+
+    Header* h = static_cast<Header*>(p) - 1;
+    Block* b = h->block;
+
+    if (!b) {
+        --largeObjects;
+        ::operator delete(h);
+        return;
+    }
+
+    SizeClass& cls = *b->cls;
+    assert(b->used);
+
+    const bool wasFull = !b->free;
+    h->nextFree = b->free;
+    b->free = h;
+    --b->used;
+    --cls.used;
+
+    if (wasFull) linkPartial(b);
+
+    // Give empty blocks back, but keep one so that a class whose
+    // last object dies and is recreated doesn't allocate every time.
+    if (!b->used && (b->prev || b->next)) deleteBlock(b);
+}
+
+void
+GcArena::getStats(Stats& stats)
+{
+    for (const SizeClass& cls : classes) {
+        if (!cls.blocks) continue;
+
+        const std::size_t size = slotSize(cls) - headerSize;
+        const std::size_t perBlock = std::max(minSlots,
+                blockBytes / slotSize(cls));
+
+        std::ostringstream ss;
+        ss << std::setw(4) << size << " byte objects";
+        stats[ss.str() + " in use"] += cls.used;
+        stats[ss.str() + " reserved"] += cls.blocks * perBlock;
+    }
+    if (largeObjects) stats["large objects in use"] += largeObjects;
+}
+
+} // namespace gnash
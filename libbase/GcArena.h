@@ -0,0 +1,62 @@
+// GcArena.h: size-class pool allocator for collectables, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_GCARENA_H
+#define GNASH_GCARENA_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+
+#include "dsodefs.h"
+
+namespace gnash {
+
+/// Pool allocator for GcResource objects
+//
+/// Objects are rounded up to one of a few size classes and packed into
+/// blocks holding many objects of the same class. This keeps objects
+/// allocated together close in memory, which helps the GC's mark and
+/// sweep passes, and avoids the fragmentation of millions of small heap
+/// allocations in long sessions. Blocks that become empty are returned
+/// to the system.
+//
+/// Objects larger than the largest size class use the normal heap.
+//
+/// Like the collectables themselves, this must only be used from the
+/// main thread.
+class DSOEXPORT GcArena
+{
+public:
+
+    /// Allocate memory for an object of the given size.
+    static void* allocate(std::size_t size);
+
+    /// Release memory returned by allocate().
+    static void deallocate(void* p);
+
+    typedef std::map<std::string, unsigned int> Stats;
+
+    /// Add the number of used and reserved slots of each size class.
+    static void getStats(Stats& stats);
+};
+
+} // namespace gnash
+
+#endif
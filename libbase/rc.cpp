@@ -96,6 +96,12 @@ RcInitFile::RcInitFile()
     _writeLog(false),
     _sound(true),
     _pluginSound(true),
+    _soundCacheLimit(8192),
+    _bitmapCacheLimit(16384),
+    _cacheAsBitmapLimit(8192),
+    _nativeBitmaps(true),
+    _doubleBuffer(false),
+    _smoothScaling(false),
     _extensionsEnabled(false),
     _startStopped(false),
     _insecureSSL(false),
@@ -580,9 +586,27 @@ RcInitFile::parseFile(const std::string& filespec)
             ||
 		 extractSetting(_lctrace, "LCTrace", variable,
                            value)
+            ||
+                 extractSetting(_nativeBitmaps, "nativeBitmaps", variable,
+                           value)
+            ||
+                 extractSetting(_doubleBuffer, "doubleBuffer", variable,
+                           value)
+            ||
+                 extractSetting(_smoothScaling, "smoothScaling", variable,
+                           value)
             ||
                  extractNumber(_movieLibraryLimit, "movieLibraryLimit",
                          variable, value)
+            ||
+                 extractNumber(_soundCacheLimit, "soundCacheLimit",
+                         variable, value)
+            ||
+                 extractNumber(_bitmapCacheLimit, "bitmapCacheLimit",
+                         variable, value)
+            ||
+                 extractNumber(_cacheAsBitmapLimit, "cacheAsBitmapLimit",
+                         variable, value)
             ||
                  extractNumber(_delay, "delay", variable, value)
             ||
@@ -769,6 +793,12 @@ RcInitFile::updateFile(const std::string& filespec)
     cmd << "startStopped " << _startStopped << endl <<
     cmd << "streamsTimeout " << _streamsTimeout << endl <<
     cmd << "movieLibraryLimit " << _movieLibraryLimit << endl <<
+    cmd << "soundCacheLimit " << _soundCacheLimit << endl <<
+    cmd << "bitmapCacheLimit " << _bitmapCacheLimit << endl <<
+    cmd << "cacheAsBitmapLimit " << _cacheAsBitmapLimit << endl <<
+    cmd << "nativeBitmaps " << _nativeBitmaps << endl <<
+    cmd << "doubleBuffer " << _doubleBuffer << endl <<
+    cmd << "smoothScaling " << _smoothScaling << endl <<
     cmd << "quality " << _quality << endl <<    
     cmd << "delay " << _delay << endl <<
     cmd << "verbosity " << _verbosity << endl <<
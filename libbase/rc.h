@@ -129,6 +129,32 @@ public:
     bool usePluginSound() const { return _pluginSound; }
     void usePluginSound(bool value) { _pluginSound = value; }
 
+    /// KiB of decoded event sounds to keep for replaying
+    std::uint32_t getSoundCacheLimit() const { return _soundCacheLimit; }
+    void setSoundCacheLimit(std::uint32_t value) { _soundCacheLimit = value; }
+
+    /// KiB of decoded SWF bitmaps to keep, 0 for no limit
+    std::uint32_t getBitmapCacheLimit() const { return _bitmapCacheLimit; }
+    void setBitmapCacheLimit(std::uint32_t value) { _bitmapCacheLimit = value; }
+
+    /// KiB of cacheAsBitmap renderings to keep, 0 for no limit
+    std::uint32_t getCacheAsBitmapLimit() const { return _cacheAsBitmapLimit; }
+    void setCacheAsBitmapLimit(std::uint32_t value) {
+        _cacheAsBitmapLimit = value;
+    }
+
+    /// Whether renderers may store opaque bitmaps in their own pixel format
+    bool useNativeBitmaps() const { return _nativeBitmaps; }
+    void useNativeBitmaps(bool value) { _nativeBitmaps = value; }
+
+    /// Whether the GUI should flip between two screen buffers
+    bool useDoubleBuffer() const { return _doubleBuffer; }
+    void useDoubleBuffer(bool value) { _doubleBuffer = value; }
+
+    /// Whether the GUI should filter the movie when scaling it
+    bool useSmoothScaling() const { return _smoothScaling; }
+    void useSmoothScaling(bool value) { _smoothScaling = value; }
+
     bool popupMessages() const { return _popups; }
     void interfacePopups(bool value) { _popups = value; }
 
@@ -530,6 +556,24 @@ protected:
     /// Enable sound for the plugin
     bool _pluginSound;		
 
+    /// KiB of decoded event sounds to keep for replaying
+    std::uint32_t _soundCacheLimit;
+
+    /// KiB of decoded SWF bitmaps to keep, 0 for no limit
+    std::uint32_t _bitmapCacheLimit;
+
+    /// KiB of cacheAsBitmap renderings to keep, 0 for no limit
+    std::uint32_t _cacheAsBitmapLimit;
+
+    /// Whether opaque bitmaps may be stored in the renderer's pixel format
+    bool _nativeBitmaps;
+
+    /// Whether the GUI should flip between two screen buffers
+    bool _doubleBuffer;
+
+    /// Whether the GUI should filter the movie when scaling it
+    bool _smoothScaling;
+
     /// Enable scanning plugin path for extensions
     bool _extensionsEnabled;	
 
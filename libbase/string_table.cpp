@@ -22,6 +22,9 @@
 #include "gnashconfig.h" // GNASH_STATS_STRING_TABLE_NOCASE
 #endif
 
+#include <algorithm>
+#include <functional>
+#include <cassert>
 #include <boost/algorithm/string/case_conv.hpp>
 
 //#define DEBUG_STRING_TABLE 1
@@ -36,30 +39,130 @@ namespace gnash {
 
 const std::string string_table::_empty;
 
+namespace {
+
+/// The initial number of hash buckets and of keys in the index.
+const std::size_t initialSize = 1024;
+
+inline std::size_t
+hash(const std::string& s)
+{
+    return std::hash<std::string>()(s);
+}
+
+}
+
+string_table::Buckets::Buckets(std::size_t n)
+    :
+    mask(n - 1),
+    slots(new std::atomic<const Entry*>[n]())
+{
+    assert(n && !(n & mask));
+}
+
+string_table::Index::Index(std::size_t n)
+    :
+    size(n),
+    slots(new Slot[n]())
+{
+}
+
+string_table::string_table()
+    :
+    _highestKey(0),
+    _highestKnownLowercase(0)
+{
+    _allBuckets.emplace_back(new Buckets(initialSize));
+    _allIndices.emplace_back(new Index(initialSize));
+    _buckets.store(_allBuckets.back().get(), std::memory_order_release);
+    _index.store(_allIndices.back().get(), std::memory_order_release);
+}
+
 string_table::key
 string_table::find(const std::string& t_f, bool insert_unfound)
 {
     if (t_f.empty()) return 0;
 
-	table::index<StringValue>::type::iterator i = 
-        _table.get<StringValue>().find(t_f);
+    const std::size_t h = hash(t_f);
+
+    const Entry* e = lookup(t_f, h);
+    if (e) return e->id;
+
+    if (!insert_unfound) return 0;
+
+    // First we lock.
+    std::lock_guard<std::mutex> lock(_lock);
+
+    // Then we see if someone else managed to sneak past us.
+    e = lookup(t_f, h);
+    if (e) return e->id;
+
+    return already_locked_insert(t_f);
+}
+
+const string_table::Entry*
+string_table::lookup(const std::string& s, std::size_t h) const
+{
+    const Buckets* b = _buckets.load(std::memory_order_acquire);
+
+    for (std::size_t i = h & b->mask; ; i = (i + 1) & b->mask) {
+        const Entry* e = b->slots[i].load(std::memory_order_acquire);
+        if (!e) return nullptr;
+        if (e->hash == h && e->value == s) return e;
+    }
+}
 
-	if (i == _table.get<StringValue>().end()) {
+void
+string_table::add(const std::string& s, std::size_t h, key id)
+{
+    _entries.emplace_back(s, id, h);
+    const Entry* e = &_entries.back();
+
+    // Keep the hash table at most half full, so that probing for a
+    // missing string stops soon.
+    Buckets* b = _allBuckets.back().get();
+    if (_entries.size() * 2 > b->mask + 1) {
+        Buckets* bigger = new Buckets((b->mask + 1) * 2);
+        _allBuckets.emplace_back(bigger);
+        for (const Entry& old : _entries) {
+            if (&old == e) continue;
+            std::size_t i = old.hash & bigger->mask;
+            while (bigger->slots[i].load(std::memory_order_relaxed)) {
+                i = (i + 1) & bigger->mask;
+            }
+            bigger->slots[i].store(&old, std::memory_order_relaxed);
+        }
+        _buckets.store(bigger, std::memory_order_release);
+        b = bigger;
+    }
 
-		if (insert_unfound) {
-			// First we lock.
-			std::lock_guard<std::mutex> lock(_lock);
-			// Then we see if someone else managed to sneak past us.
-			i = _table.get<StringValue>().find(t_f);
-			// If they did, use that value.
-			if (i != _table.end()) return i->id;
+    // Publish the key before the string, so that anyone finding the
+    // string can look the key up.
+    indexFor(id).slots[id].entry.store(e, std::memory_order_release);
 
-            return already_locked_insert(t_f);
-		}
-        return 0;
-	}
+    std::size_t i = h & b->mask;
+    while (b->slots[i].load(std::memory_order_relaxed)) i = (i + 1) & b->mask;
+    b->slots[i].store(e, std::memory_order_release);
+}
 
-	return i->id;
+string_table::Index&
+string_table::indexFor(key k)
+{
+    Index& index = *_allIndices.back();
+    if (k < index.size) return index;
+
+    Index* bigger = new Index(std::max(index.size * 2, k + 1));
+    _allIndices.emplace_back(bigger);
+    for (std::size_t i = 0; i < index.size; ++i) {
+        const Slot& from = index.slots[i];
+        Slot& to = bigger->slots[i];
+        to.entry.store(from.entry.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+        to.noCase.store(from.noCase.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+    }
+    _index.store(bigger, std::memory_order_release);
+    return *bigger;
 }
 
 string_table::key
@@ -74,25 +177,33 @@ string_table::insert_group(const svt* l, std::size_t size)
 {
     std::lock_guard<std::mutex> lock(_lock);
     for (std::size_t i = 0; i < size; ++i) {
-        // Copy to avoid changing the original table.
-        const svt s = l[i];
+        const svt& s = l[i];
 
         // The keys don't have to be consecutive, so any time we find a key
         // that is too big, jump a few keys to avoid rewriting this on every
         // item.
-       if (s.id > _highestKey) _highestKey = s.id + 256;
-       _table.insert(s);
+        if (s.id > _highestKey) _highestKey = s.id + 256;
+
+        // Strings and ids are unique: later duplicates are ignored.
+        const std::size_t h = hash(s.value);
+        if (lookup(s.value, h)) continue;
+        if (indexFor(s.id).slots[s.id].entry.load(std::memory_order_relaxed)) {
+            continue;
+        }
+        add(s.value, h, s.id);
     }
     
     for (std::size_t i = 0; i < size; ++i) {
-        const svt s = l[i];
+        const svt& s = l[i];
         const std::string& t = boost::to_lower_copy(s.value);
         if (t != s.value) {
-            _caseTable[s.id] = already_locked_insert(t);
+            const key nocase = already_locked_insert(t);
+            indexFor(s.id).slots[s.id].noCase.store(nocase,
+                    std::memory_order_release);
         }
     }
 #ifdef DEBUG_STRING_TABLE
-    std::cerr << "string_table group insert end -- size is " << _table.size() << " _caseTable size is " << _caseTable.size() << std::endl; 
+    std::cerr << "string_table group insert end -- size is " << _entries.size() << std::endl; 
 #endif
 
 
@@ -101,36 +212,37 @@ string_table::insert_group(const svt* l, std::size_t size)
 string_table::key
 string_table::already_locked_insert(const std::string& to_insert)
 {
-	const key ret = _table.insert(svt(to_insert, ++_highestKey)).first->id;
+    const std::size_t h = hash(to_insert);
+    const Entry* e = lookup(to_insert, h);
+    if (e) return e->id;
+
+    const key ret = ++_highestKey;
 
 #ifdef DEBUG_STRING_TABLE
     int tscp = 100; // table size checkpoint
-    size_t ts = _table.size();
+    size_t ts = _entries.size() + 1;
     if ( ! (ts % tscp) ) { std::cerr << "string_table size grew to " << ts << std::endl; }
 #endif
 
     const std::string lower = boost::to_lower_copy(to_insert);
 
     // Insert the caseless equivalent if it's not there. We're locked for
-    // the whole of this function, so we can do what we like.
+    // the whole of this function, so we can do what we like. The caseless
+    // key is set before the string is published.
     if (lower != to_insert) {
 
-        // Find the caseless value in the table
-        table::index<StringValue>::type::iterator it = 
-            _table.get<StringValue>().find(lower);
-
-        const key nocase = (it == _table.end()) ? 
-            _table.insert(svt(lower, ++_highestKey)).first->id : it->id;
+        const key nocase = already_locked_insert(lower);
 
 #ifdef DEBUG_STRING_TABLE
         ++ts;
         if ( ! (ts % tscp) ) { std::cerr << "string_table size grew to " << ts << std::endl; }
 #endif // DEBUG_STRING_TABLE
 
-        _caseTable[ret] = nocase;
-
+        indexFor(ret).slots[ret].noCase.store(nocase,
+                std::memory_order_relaxed);
     }
 
+    add(to_insert, h, ret);
     return ret;
 }
 
@@ -150,7 +262,7 @@ string_table::noCase(key a) const
     // Avoid checking keys known to be lowercase
     if ( a <= _highestKnownLowercase ) {
 #if GNASH_PARANOIA_LEVEL > 2
-        //assert(_caseTable.find(a) == _caseTable.end());
+        //assert(a >= _index.load()->size || !_index.load()->slots[a].noCase);
 #endif
         return a;
     }
@@ -164,10 +276,11 @@ string_table::noCase(key a) const
     //       would speed things up even for unknown 
     //       strings.
 
-    std::map<key, key>::const_iterator i = _caseTable.find(a);
-    if ( i != _caseTable.end() ) return i->second;
+    const Index* index = _index.load(std::memory_order_acquire);
+    if (a >= index->size) return a;
 
-    return a;
+    const key nocase = index->slots[a].noCase.load(std::memory_order_acquire);
+    return nocase ? nocase : a;
 }
 
 bool
@@ -23,13 +23,15 @@
 // Thread Status: SAFE, except for group functions.
 // The group functions may have strange behavior when trying to automatically
 // lowercase the additions.
+//
+// Lookups never lock. Additions are serialized by a mutex and published
+// with atomic stores, so a lookup sees either the old or the new table.
 
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/identity.hpp>
-#include <boost/multi_index/member.hpp>
 #include <string>
-#include <map>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
 #include <mutex>
 #include "dsodefs.h"
 
@@ -54,31 +56,6 @@ public:
 		std::string value;
 		std::size_t id;
 	};
-    
-    /// A tag to identify the key index.   
-    struct StringID {};
-
-    /// A tag to identify the string index.
-    struct StringValue {};
-
-    /// The container for indexing the strings
-    //
-    /// This contains two indices with no duplicate values:
-    /// 1. An index of unique, case-sensitive strings.
-    /// 2. An index of unique numeric keys.
-	typedef boost::multi_index_container<svt,
-		boost::multi_index::indexed_by<
-
-			boost::multi_index::hashed_unique<
-                boost::multi_index::tag<StringValue>,
-				boost::multi_index::member<svt, std::string, &svt::value> >,
-
-			boost::multi_index::hashed_unique<
-                boost::multi_index::tag<StringID>,
-				boost::multi_index::member<svt, std::size_t, &svt::id>
-
-        > 
-	> > table;
 
 	typedef std::size_t key;
 
@@ -101,11 +78,12 @@ public:
     ///             given.
 	const std::string& value(key to_find) const
 	{
-		if (_table.empty() || !to_find) return _empty;
+        const Index* index = _index.load(std::memory_order_acquire);
+        if (!to_find || to_find >= index->size) return _empty;
 
-		table::index<StringID>::type::iterator r =
-            _table.get<StringID>().find(to_find);
-		return (r == _table.get<StringID>().end()) ? _empty : r->value;
+        const Entry* e =
+            index->slots[to_find].entry.load(std::memory_order_acquire);
+        return e ? e->value : _empty;
 	}
 
 	/// Insert a string with auto-assigned id. 
@@ -128,11 +106,7 @@ public:
 	key already_locked_insert(const std::string& to_insert);
 
 	/// Construct the empty string_table
-	string_table()
-        :
-		_highestKey(0),
-		_highestKnownLowercase(0)
-	{}
+	string_table();
 
     /// Return a caseless equivalent of the passed key.
     //
@@ -147,12 +121,74 @@ public:
 
 private:
 
-	table _table;
+    /// A string in the table. Entries are never changed or removed.
+    struct Entry
+    {
+        Entry(std::string v, key i, std::size_t h)
+            :
+            value(std::move(v)),
+            id(i),
+            hash(h)
+        {}
+
+        const std::string value;
+        const key id;
+        const std::size_t hash;
+    };
+
+    /// An open-addressed hash table of entries, by string.
+    struct Buckets
+    {
+        explicit Buckets(std::size_t n);
+        const std::size_t mask;
+        std::unique_ptr<std::atomic<const Entry*>[]> slots;
+    };
+
+    /// The entry and caseless equivalent of each key.
+    struct Slot
+    {
+        std::atomic<const Entry*> entry;
+
+        /// Zero if the key is its own caseless equivalent.
+        std::atomic<key> noCase;
+    };
+
+    /// A flat array of slots, indexed by key.
+    struct Index
+    {
+        explicit Index(std::size_t n);
+        const std::size_t size;
+        std::unique_ptr<Slot[]> slots;
+    };
+
+    /// Look a string up without locking.
+    const Entry* lookup(const std::string& s, std::size_t hash) const;
+
+    /// Add an entry. The lock must be held and the string must be new.
+    void add(const std::string& s, std::size_t hash, key id);
+
+    /// Make sure the index has a slot for a key. The lock must be held.
+    Index& indexFor(key k);
+
+    /// The tables being read.
+    //
+    /// Tables are replaced by bigger ones as the table grows. Readers
+    /// may still be using the old ones, so they are only freed with the
+    /// string_table.
+    std::atomic<const Buckets*> _buckets;
+    std::atomic<const Index*> _index;
+
+    /// All tables, including the ones in use.
+    std::vector<std::unique_ptr<Buckets> > _allBuckets;
+    std::vector<std::unique_ptr<Index> > _allIndices;
+
+    /// Storage for the entries, which never moves.
+    std::deque<Entry> _entries;
+
 	static const std::string _empty;
 	std::mutex _lock;
 	std::size_t _highestKey;
 
-    std::map<key, key> _caseTable;
     key _highestKnownLowercase;
 };
 
@@ -0,0 +1,223 @@
+// BitmapCache.cpp:  Offscreen rendering for cacheAsBitmap, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#include "BitmapCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "GnashImage.h"
+#include "Renderer.h"
+#include "Point2d.h"
+#include "rc.h"
+
+namespace gnash {
+
+namespace {
+
+/// The bitmaps with a rendering, least recently displayed first.
+//
+/// BitmapCaches belong to DisplayObjects, so only the thread that
+/// advances and renders the movie uses them.
+struct Renderings
+{
+    Renderings() : bytes(0) {}
+
+    std::list<BitmapCache*> used;
+    size_t bytes;
+};
+
+Renderings&
+renderings()
+{
+    static Renderings r;
+    return r;
+}
+
+/// The limit on the size of all bitmaps in bytes, 0 for none.
+size_t
+sizeLimit()
+{
+    return RcInitFile::getDefaultInstance().getCacheAsBitmapLimit() * 1024;
+}
+
+/// Find the size of a Renderer's pixels in TWIPS.
+//
+/// The Renderer interface has no direct way of asking for its stage
+/// matrix, so this measures a large span to keep rounding errors small.
+void
+pixelSize(const Renderer& r, double& xScale, double& yScale, point& origin)
+{
+    const int span = 1000;
+    origin = r.pixel_to_world(0, 0);
+    const point p = r.pixel_to_world(span, span);
+    xScale = (p.x - origin.x) / static_cast<double>(span);
+    yScale = (p.y - origin.y) / static_cast<double>(span);
+}
+
+/// Whether two matrices differ only in translation.
+bool
+sameShape(const SWFMatrix& a, const SWFMatrix& b)
+{
+    return a.a() == b.a() && a.b() == b.b() && a.c() == b.c() &&
+        a.d() == b.d();
+}
+
+}
+
+BitmapCache::BitmapCache(std::unique_ptr<image::GnashImage> im,
+        const Transform& xform, double xScale, double yScale, int x, int y)
+    :
+    _image(std::move(im)),
+    _xform(xform),
+    _xScale(xScale),
+    _yScale(yScale),
+    _x(x),
+    _y(y)
+{
+    Renderings& r = renderings();
+    _used = r.used.insert(r.used.end(), this);
+    r.bytes += _image->size();
+}
+
+BitmapCache::~BitmapCache()
+{
+    drop();
+}
+
+void
+BitmapCache::drop()
+{
+    if (!_image) return;
+
+    Renderings& r = renderings();
+    r.used.erase(_used);
+    r.bytes -= _image->size();
+    _image.reset();
+}
+
+void
+BitmapCache::trim(size_t limit)
+{
+    Renderings& r = renderings();
+    while (r.bytes > limit && !r.used.empty()) {
+        r.used.front()->drop();
+    }
+}
+
+std::unique_ptr<BitmapCache>
+BitmapCache::render(Renderer& renderer, const Transform& xform,
+        const SWFRect& bounds, const Drawer& draw)
+{
+    std::unique_ptr<BitmapCache> ret;
+
+    double xScale, yScale;
+    point origin;
+    pixelSize(renderer, xScale, yScale, origin);
+    if (xScale <= 0 || yScale <= 0) return ret;
+
+    SWFRect world;
+    world.expand_to_transformed_rect(xform.matrix, bounds);
+    if (world.is_null()) return ret;
+
+    // Align the bitmap with the stage pixels so that it can be copied
+    // without resampling, and leave a pixel on each side for antialiasing.
+    const double left =
+        std::floor((world.get_x_min() - origin.x) / xScale) - 1;
+    const double top =
+        std::floor((world.get_y_min() - origin.y) / yScale) - 1;
+    const double right =
+        std::ceil((world.get_x_max() - origin.x) / xScale) + 1;
+    const double bottom =
+        std::ceil((world.get_y_max() - origin.y) / yScale) + 1;
+
+    if (right - left > maxSize || bottom - top > maxSize) return ret;
+
+    const size_t width = right - left;
+    const size_t height = bottom - top;
+
+    // Make room for the new bitmap, unless it would never fit.
+    const size_t limit = sizeLimit();
+    if (limit) {
+        const size_t bytes = width * height * 4;
+        if (bytes > limit) return ret;
+        trim(limit - bytes);
+    }
+
+    const int x = origin.x + std::lround(left * xScale);
+    const int y = origin.y + std::lround(top * yScale);
+
+    std::unique_ptr<image::GnashImage> im(
+            new image::ImageRGBA(width, height));
+
+    {
+        Renderer::Internal in(renderer, *im);
+        Renderer* internal = in.renderer();
+        if (!internal) return ret;
+
+        std::fill(im->begin(), im->end(), 0);
+
+        // Internal renderers draw TWIPS to pixels at 1:20, so scale to the
+        // outer renderer's pixel size and move the bitmap's corner to the
+        // origin.
+        SWFMatrix mat;
+        mat.set_scale(20 / xScale, 20 / yScale);
+        SWFMatrix corner;
+        corner.set_translation(-x, -y);
+        mat.concatenate(corner);
+        mat.concatenate(xform.matrix);
+
+        draw(*internal, Transform(mat, xform.colorTransform));
+    }
+
+    ret.reset(new BitmapCache(std::move(im), xform, xScale, yScale, x, y));
+    return ret;
+}
+
+bool
+BitmapCache::usable(const Renderer& renderer, const Transform& xform) const
+{
+    if (!_image) return false;
+    if (!sameShape(xform.matrix, _xform.matrix)) return false;
+    if (xform.colorTransform != _xform.colorTransform) return false;
+
+    double xScale, yScale;
+    point origin;
+    pixelSize(renderer, xScale, yScale, origin);
+    return xScale == _xScale && yScale == _yScale;
+}
+
+void
+BitmapCache::display(Renderer& renderer, const Transform& xform)
+{
+    Renderings& r = renderings();
+    r.used.splice(r.used.end(), r.used, _used);
+
+    SWFMatrix mat;
+    mat.set_translation(_x + xform.matrix.tx() - _xform.matrix.tx(),
+            _y + xform.matrix.ty() - _xform.matrix.ty());
+
+    const SWFRect bounds(0, 0, std::lround(_image->width() * _xScale),
+            std::lround(_image->height() * _yScale));
+
+    renderer.drawVideoFrame(_image.get(), Transform(mat), &bounds, false);
+}
+
+} // namespace gnash
@@ -0,0 +1,127 @@
+// BitmapCache.h:  Offscreen rendering for cacheAsBitmap, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_BITMAPCACHE_H
+#define GNASH_BITMAPCACHE_H
+
+#include <list>
+#include <memory>
+#include <functional>
+#include <boost/noncopyable.hpp>
+
+#include "Transform.h"
+#include "SWFRect.h"
+
+// Forward declarations
+namespace gnash {
+    class Renderer;
+    namespace image {
+        class GnashImage;
+    }
+}
+
+namespace gnash {
+
+/// A rendered copy of a DisplayObject, for cacheAsBitmap.
+//
+/// The bitmap is rendered at the resolution of the Renderer it is displayed
+/// with, so that it can be copied to the stage pixel for pixel. It stays
+/// valid while the object's contents and the scale, rotation, skew and
+/// color transform of its world transform stay unchanged; a change of
+/// translation only moves the bitmap.
+//
+/// Invalidation of contents is the owner's responsibility (see
+/// DisplayObject::set_invalidated()); changes of transform are detected by
+/// usable().
+//
+/// When the total size of all bitmaps exceeds the "cacheAsBitmapLimit"
+/// setting, those displayed least recently are dropped. They are no
+/// longer usable() and are rendered again when next displayed.
+class BitmapCache : boost::noncopyable
+{
+public:
+
+    /// Draws the object into an offscreen Renderer with a given transform.
+    typedef std::function<void(Renderer&, const Transform&)> Drawer;
+
+    ~BitmapCache();
+
+    /// Render an object into a new BitmapCache.
+    //
+    /// @param renderer     The Renderer the bitmap will be displayed with.
+    /// @param xform        The world transform of the object.
+    /// @param bounds       The bounds of the object in its own coordinates.
+    /// @param draw         Draws the object.
+    /// @return             The new bitmap, or null if the Renderer does not
+    ///                     support offscreen rendering or the bitmap would
+    ///                     be empty, too large or over the size limit.
+    static std::unique_ptr<BitmapCache> render(Renderer& renderer,
+            const Transform& xform, const SWFRect& bounds,
+            const Drawer& draw);
+
+    /// Whether the bitmap can be displayed with a given transform.
+    bool usable(const Renderer& renderer, const Transform& xform) const;
+
+    /// Copy the bitmap to the Renderer.
+    //
+    /// Only call this if usable() returns true for the same arguments.
+    void display(Renderer& renderer, const Transform& xform);
+
+    /// The largest width or height of a cached bitmap, in pixels.
+    //
+    /// This is the limit the reference player uses.
+    static const size_t maxSize = 2880;
+
+private:
+
+    typedef std::list<BitmapCache*> Displayed;
+
+    BitmapCache(std::unique_ptr<image::GnashImage> im,
+            const Transform& xform, double xScale, double yScale,
+            int x, int y);
+
+    /// Free the bitmap.
+    void drop();
+
+    /// Drop bitmaps until their size is within the limit.
+    //
+    /// The bitmaps displayed least recently are dropped first.
+    static void trim(size_t limit);
+
+    /// Null if the bitmap was dropped.
+    std::unique_ptr<image::GnashImage> _image;
+
+    /// The position of this bitmap in the list of bitmaps.
+    Displayed::iterator _used;
+
+    /// The world transform the bitmap was rendered with.
+    Transform _xform;
+
+    /// TWIPS per pixel of the Renderer the bitmap was rendered for.
+    double _xScale;
+    double _yScale;
+
+    /// World position of the bitmap's top left corner.
+    int _x;
+    int _y;
+};
+
+} // namespace gnash
+
+#endif
@@ -36,6 +36,16 @@ operator<<(std::ostream& os, const ConstantPool& p) {
     return os;
 }
 
+const ObjectURI*
+ConstantPool::uri(const VM& vm, const SharedString& s) const
+{
+    const auto it = _uris.find(&s.str());
+    if (it == _uris.end()) return nullptr;
+
+    if (it->second.empty()) it->second = getURI(vm, s.str());
+    return &it->second;
+}
+
 
 PoolGuard::PoolGuard(VM& vm, const ConstantPool* pool)
     :
@@ -20,14 +20,64 @@
 #define GNASH_CONSTANTPOOL_H
 
 #include <vector>
+#include <unordered_map>
 #include <iosfwd>
 
+#include "as_value.h"
+#include "ObjectURI.h"
+
 namespace gnash {
 
 class VM;
 
-/// An indexed list of strings (must match the definition in action_buffer.h)
-typedef std::vector<const char*> ConstantPool;
+/// The strings of an ActionConstantPool.
+//
+/// Each string is also kept as an interned string value, so pushing a
+/// constant doesn't build a string, and a constant used as a name is
+/// only looked up in the string_table the first time. Pools are cached
+/// by the action_buffer, which is only run by one VM, so the ObjectURIs
+/// found are kept here.
+class ConstantPool
+{
+public:
+
+    typedef std::vector<const char*>::const_iterator const_iterator;
+
+    /// Add a string. It must outlive the pool.
+    void push_back(const char* str) {
+        const SharedString s = SharedString::intern(str);
+        _strings.push_back(str);
+        _values.push_back(s);
+        _uris.emplace(&s.str(), ObjectURI());
+    }
+
+    size_t size() const { return _strings.size(); }
+
+    const char* operator[](size_t i) const { return _strings[i]; }
+
+    /// The value to push for a constant.
+    const as_value& value(size_t i) const { return _values[i]; }
+
+    /// Return the ObjectURI of a constant used as a name.
+    //
+    /// Pools also hold plain text, so a constant is only looked up in the
+    /// string_table the first time it is used as a name.
+    //
+    /// @param s    An interned string, matched by identity.
+    /// @return     The ObjectURI, or null if s is not in this pool.
+    const ObjectURI* uri(const VM& vm, const SharedString& s) const;
+
+    const_iterator begin() const { return _strings.begin(); }
+    const_iterator end() const { return _strings.end(); }
+
+private:
+    std::vector<const char*> _strings;
+    std::vector<as_value> _values;
+
+    /// The ObjectURIs of the constants, by the address of their interned
+    /// string. An empty ObjectURI has not been looked up yet.
+    mutable std::unordered_map<const std::string*, ObjectURI> _uris;
+};
 
 std::ostream& operator<<(std::ostream& os, const ConstantPool& p);
 
@@ -27,6 +27,7 @@
 #include <utility>
 #include <functional>
 #include <boost/logic/tribool.hpp>
+#include <boost/tuple/tuple.hpp>
 
 #include "movie_root.h"
 #include "MovieClip.h"
@@ -109,7 +110,8 @@ DisplayObject::DisplayObject(movie_root& mr, as_object* object,
     _unloaded(false),
     _destroyed(false),
     _invalidated(true),
-    _child_invalidated(true)
+    _child_invalidated(true),
+    _cacheAsBitmap(false)
 {
     //assert(m_old_invalidated_ranges.isNull());
 
@@ -187,6 +189,13 @@ DisplayObject::set_invalidated()
 
 void
 DisplayObject::set_invalidated(const char* debug_file, int debug_line)
+{
+    _bitmapCache.reset();
+    transformInvalidated(debug_file, debug_line);
+}
+
+void
+DisplayObject::transformInvalidated(const char* debug_file, int debug_line)
 {
     // Set the invalidated-flag of the parent. Note this does not mean that
     // the parent must re-draw itself, it just means that one of it's childs
@@ -237,6 +246,11 @@ DisplayObject::add_invalidated_bounds(InvalidatedRanges& ranges, bool force)
 void
 DisplayObject::set_child_invalidated()
 {
+    // This is a change of contents for any of our ancestors that are
+    // cached as a bitmap. Ancestors that have already been told keep
+    // _child_invalidated set and have no bitmap until they are displayed.
+    _bitmapCache.reset();
+
     if (!_child_invalidated) {
         _child_invalidated=true;
         if (_parent) _parent->set_child_invalidated();
@@ -397,7 +411,7 @@ DisplayObject::setMatrix(const SWFMatrix& m, bool updateCache)
 
     if (m == _transform.matrix) return;
 
-    set_invalidated(__FILE__, __LINE__);
+    transformInvalidated(__FILE__, __LINE__);
     _transform.matrix = m;
 
     // don't update caches if SWFMatrix wasn't updated too
@@ -409,6 +423,36 @@ DisplayObject::setMatrix(const SWFMatrix& m, bool updateCache)
 
 }
 
+void
+DisplayObject::setCacheAsBitmap(bool cache)
+{
+    if (cache == _cacheAsBitmap) return;
+    set_invalidated(__FILE__, __LINE__);
+    _cacheAsBitmap = cache;
+}
+
+bool
+DisplayObject::displayCached(Renderer& renderer, const Transform& xform,
+        const BitmapCache::Drawer& draw)
+{
+    if (!_cacheAsBitmap) return false;
+
+    // Masks are drawn into the mask buffer as shapes, which a bitmap
+    // can't do.
+    for (const DisplayObject* p = this; p; p = p->parent()) {
+        if (p->isMaskLayer() || p->isDynamicMask()) return false;
+    }
+
+    if (!_bitmapCache || !_bitmapCache->usable(renderer, xform)) {
+        _bitmapCache = BitmapCache::render(renderer, xform, getBounds(),
+                draw);
+        if (!_bitmapCache) return false;
+    }
+
+    _bitmapCache->display(renderer, xform);
+    return true;
+}
+
 void
 DisplayObject::set_event_handlers(const Events& copyfrom)
 {
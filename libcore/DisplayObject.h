@@ -41,6 +41,7 @@
 #include "SWFCxForm.h"
 #include "dsodefs.h" 
 #include "snappingrange.h"
+#include "BitmapCache.h"
 #ifdef USE_SWFTREE
 # include "tree.hh"
 #endif
@@ -352,7 +353,7 @@ public:
     void setCxForm(const SWFCxForm& cx) 
     {       
         if (_transform.colorTransform != cx) {
-            set_invalidated();
+            transformInvalidated(__FILE__, __LINE__);
             _transform.colorTransform = cx;
         }
     }
@@ -622,6 +623,14 @@ public:
     // Return true if this DisplayObject should be rendered
     bool visible() const { return _visible; }
 
+    /// Whether this DisplayObject is rendered through a cached bitmap.
+    bool cacheAsBitmap() const { return _cacheAsBitmap; }
+
+    /// Set whether this DisplayObject is rendered through a cached bitmap.
+    //
+    /// This is set by PlaceObject3 tags and the cacheAsBitmap property.
+    void setCacheAsBitmap(bool cache);
+
     /// Return true if an handler for the given event is defined
     //
     /// NOTE that we look for both clip-defined and user-defined
@@ -1000,6 +1009,20 @@ protected:
 
     void set_event_handlers(const Events& copyfrom);
 
+    /// Display this DisplayObject from its cached bitmap.
+    //
+    /// The bitmap is rendered with the given Drawer if there is none or if
+    /// it doesn't suit the transform. Nothing is done if cacheAsBitmap is
+    /// not set, or if the DisplayObject is being drawn as a mask.
+    //
+    /// @param renderer     The Renderer to display with.
+    /// @param xform        The world transform of this DisplayObject.
+    /// @param draw         Draws the contents of this DisplayObject.
+    /// @return             true if the bitmap was displayed, false if the
+    ///                     DisplayObject must be drawn normally.
+    bool displayCached(Renderer& renderer, const Transform& xform,
+            const BitmapCache::Drawer& draw);
+
     /// Name of this DisplayObject (if any)
     ObjectURI _name; 
 
@@ -1033,6 +1056,12 @@ private:
     /// Register a DisplayObject masked by this instance
     void setMaskee(DisplayObject* maskee);
 
+    /// Invalidate this DisplayObject for a change of its transform.
+    //
+    /// This is set_invalidated() without discarding the cached bitmap,
+    /// which knows whether it suits the new transform.
+    void transformInvalidated(const char* debug_file, int debug_line);
+
     /// The as_object to which this DisplayObject is attached.
     as_object* _object;
 
@@ -1111,6 +1140,11 @@ private:
     /// can be set at the same time. 
     bool _child_invalidated;
 
+    /// Whether cacheAsBitmap is set.
+    bool _cacheAsBitmap;
+
+    /// The cached rendering, if any. Dropped on any change of contents.
+    std::unique_ptr<BitmapCache> _bitmapCache;
 
 };
 
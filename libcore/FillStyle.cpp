@@ -181,16 +181,16 @@ BitmapFill::operator=(const BitmapFill& other)
 const CachedBitmap*
 BitmapFill::bitmap() const
 {
-    if (_bitmapInfo) {
-        return  _bitmapInfo.get();
+    if (!_bitmapInfo) {
+        if (!_md) {
+            return nullptr;
+        }
+        _bitmapInfo = _md->getBitmap(_id);
+
+        // May still be 0!
+        if (!_bitmapInfo) return nullptr;
     }
-    if (!_md) {
-        return nullptr;
-    }
-    _bitmapInfo = _md->getBitmap(_id);
-
-    // May still be 0!
-    return _bitmapInfo.get();
+    return _bitmapInfo->renderable();
 }
     
 void
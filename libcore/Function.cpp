@@ -30,9 +30,103 @@
 #include "namedStrings.h"
 #include "CallStack.h"
 #include "DisplayObject.h"
+#include "DecodedActions.h"
+#include "StringPredicates.h"
 
 namespace gnash {
 
+namespace {
+
+/// Names that are only defined in a function's scope if its code uses them.
+enum ScopeName
+{
+    SCOPE_ARGUMENTS = 1 << 0,
+    SCOPE_SUPER = 1 << 1,
+    SCOPE_ALL = SCOPE_ARGUMENTS | SCOPE_SUPER
+};
+
+/// The ScopeName flag of a name, or 0.
+//
+/// Names are compared without case, as older SWF versions do.
+int
+scopeName(const std::string& name)
+{
+    StringNoCaseEqual noCaseCompare;
+    if (noCaseCompare(name, "arguments")) return SCOPE_ARGUMENTS;
+    if (noCaseCompare(name, "super")) return SCOPE_SUPER;
+    return 0;
+}
+
+int
+poolScopeNames(const ConstantPool& pool)
+{
+    int names = 0;
+    for (const char* s : pool) names |= scopeName(s);
+    return names;
+}
+
+/// Add the offsets an action may continue at, other than the next one.
+//
+/// @param start    The offset of the function's code.
+/// @param end      The offset after the function's code.
+/// @return         false if control may go to code that can't be checked.
+bool
+jumpTargets(const action_buffer& buf, const DecodedActions& actions,
+        const DecodedAction& act, size_t start, size_t end,
+        std::vector<size_t>& targets)
+{
+    switch (act.type) {
+        case SWF::ACTION_BRANCHALWAYS:
+        case SWF::ACTION_BRANCHIFTRUE:
+        {
+            const long target =
+                static_cast<long>(act.nextPC) + act.branchOffset;
+
+            // Leaving the function is fine, landing inside an action isn't.
+            if (target < static_cast<long>(start) ||
+                    target >= static_cast<long>(end)) {
+                return true;
+            }
+            if (act.branchIndex == DecodedAction::noBranch) return false;
+            targets.push_back(target);
+            return true;
+        }
+        case SWF::ACTION_TRY:
+        {
+            if (act.nextPC - act.pc < 10) return false;
+            const std::uint8_t flags = buf[act.pc + 3];
+            const size_t catchStart = act.nextPC + buf.read_uint16(act.pc + 4);
+            const size_t finallyStart = catchStart +
+                ((flags & 1) ? buf.read_uint16(act.pc + 6) : 0);
+            const size_t after = finallyStart +
+                ((flags & 2) ? buf.read_uint16(act.pc + 8) : 0);
+            targets.push_back(catchStart);
+            targets.push_back(finallyStart);
+            targets.push_back(after);
+            return true;
+        }
+        case SWF::ACTION_WAITFORFRAME:
+        case SWF::ACTION_WAITFORFRAMEEXPRESSION:
+        {
+            const size_t skipAt = act.pc +
+                (act.type == SWF::ACTION_WAITFORFRAME ? 5 : 3);
+            if (skipAt >= act.nextPC) return false;
+
+            const DecodedAction* a = &act;
+            for (size_t n = buf[skipAt]; a && n; --n) {
+                a = actions.find(a->nextPC, a);
+            }
+            if (!a) return false;
+            targets.push_back(a->nextPC);
+            return true;
+        }
+        default:
+            return true;
+    }
+}
+
+}
+
 Function::Function(const action_buffer& ab, as_environment& env,
             size_t start, ScopeStack scopeStack)
     :
@@ -42,7 +136,8 @@ Function::Function(const action_buffer& ab, as_environment& env,
     _action_buffer(ab),
     _scopeStack(std::move(scopeStack)),
     _startPC(start),
-    _length(0)
+    _length(0),
+    _scopeNames(-1)
 {
     //assert( _startPC < _action_buffer.size() );
 }
@@ -126,19 +221,21 @@ Function::call(const fn_call& fn)
     // Add 'this'
     setLocal(cf, NSV::PROP_THIS, fn.this_ptr ? fn.this_ptr : as_value());
 
-    as_object* super = fn.super ? fn.super :
-        fn.this_ptr ? fn.this_ptr->get_super() : nullptr;
-
     // Add 'super' (SWF6+ only)
-    if (super && swfversion > 5) {
-        setLocal(cf, NSV::PROP_SUPER, super);
+    if (swfversion > 5 && usesSuper()) {
+        as_object* super = fn.super ? fn.super :
+            fn.this_ptr ? fn.this_ptr->get_super() : nullptr;
+        if (super) setLocal(cf, NSV::PROP_SUPER, super);
     }
 
     // Add 'arguments'
-    as_object* args = getGlobal(fn).createArray();
+    if (usesArguments()) {
+        as_object* args = getGlobal(fn).createArray();
 
-    // Put 'arguments' in a local var.
-    setLocal(cf, NSV::PROP_ARGUMENTS, getArguments(*this, *args, fn, caller));
+        // Put 'arguments' in a local var.
+        setLocal(cf, NSV::PROP_ARGUMENTS,
+                getArguments(*this, *args, fn, caller));
+    }
 
     // Execute the actions.
     as_value result;
@@ -153,6 +250,119 @@ Function::setLength(size_t len)
     _length = len;
 }
 
+bool
+Function::usesArguments() const
+{
+    return scopeNames() & SCOPE_ARGUMENTS;
+}
+
+bool
+Function::usesSuper() const
+{
+    return scopeNames() & SCOPE_SUPER;
+}
+
+int
+Function::scopeNames() const
+{
+    if (_scopeNames >= 0) return _scopeNames;
+
+    // The code of nested functions is part of ours, so names they take
+    // from our scope are found too.
+    const DecodedActions& actions = _action_buffer.decoded();
+    const size_t end = _startPC + _length;
+
+    int names = 0;
+    size_t pc = _startPC;
+    const DecodedAction* prev = nullptr;
+
+    // GetVariables whose name is pushed just before them, and the offsets
+    // reached other than by falling through. A name is only known if its
+    // GetVariable can't be reached from anywhere else.
+    std::vector<size_t> staticNames;
+    std::vector<size_t> targets;
+
+    while (pc < end && names != SCOPE_ALL) {
+
+        const DecodedAction* act = actions.find(pc, prev);
+
+        // Code that isn't decoded can't be checked.
+        if (!act) {
+            names = SCOPE_ALL;
+            break;
+        }
+
+        if (!jumpTargets(_action_buffer, actions, *act, _startPC, end,
+                    targets)) {
+            names = SCOPE_ALL;
+            break;
+        }
+
+        switch (act->type) {
+            case SWF::ACTION_PUSHDATA:
+                if (!act->pushDecoded) {
+                    names = SCOPE_ALL;
+                    break;
+                }
+                for (const DecodedAction::PushItem& item : act->push) {
+                    if (item.kind == DecodedAction::PushItem::LITERAL) {
+                        if (item.value.is_string()) {
+                            names |= scopeName(item.value.to_string());
+                        }
+                    }
+                    else if (item.kind == DecodedAction::PushItem::CONSTANT) {
+                        // Constants may also come from a pool defined in
+                        // the function, which is checked below.
+                        if (_pool && item.index < _pool->size()) {
+                            names |= scopeName((*_pool)[item.index]);
+                        }
+                    }
+                }
+                break;
+            case SWF::ACTION_CONSTANTPOOL:
+                names |= poolScopeNames(
+                        _action_buffer.readConstantPool(act->pc, act->nextPC));
+                break;
+            case SWF::ACTION_GETVARIABLE:
+                // A variable name computed at runtime, as in eval(), or
+                // pushed from a register, may be any name.
+                if (!prev || prev->type != SWF::ACTION_PUSHDATA ||
+                        !prev->pushDecoded || prev->push.empty()) {
+                    names = SCOPE_ALL;
+                    break;
+                }
+                {
+                    const DecodedAction::PushItem& item = prev->push.back();
+                    const bool literal =
+                        item.kind == DecodedAction::PushItem::LITERAL &&
+                        item.value.is_string();
+                    if (!literal &&
+                            item.kind != DecodedAction::PushItem::CONSTANT) {
+                        names = SCOPE_ALL;
+                        break;
+                    }
+                }
+                staticNames.push_back(act->pc);
+                break;
+            default:
+                break;
+        }
+
+        prev = act;
+        pc = act->nextPC;
+    }
+
+    std::sort(targets.begin(), targets.end());
+    for (size_t get : staticNames) {
+        if (std::binary_search(targets.begin(), targets.end(), get)) {
+            names = SCOPE_ALL;
+        }
+    }
+
+    _scopeNames = names;
+    return _scopeNames;
+}
+
 void
 Function::markReachableResources() const
 {
@@ -119,6 +119,18 @@ public:
 	/// Dispatch.
 	virtual as_value call(const fn_call& fn);
 
+    /// Whether the function code may refer to 'arguments'.
+    //
+    /// The code is scanned for the name on the first request. Names
+    /// built at runtime are not found, except when they are looked up
+    /// as variables.
+    bool usesArguments() const;
+
+    /// Whether the function code may refer to 'super'.
+    //
+    /// See usesArguments().
+    virtual bool usesSuper() const;
+
 	/// Mark reachable resources. Override from as_object
 	//
 	/// Reachable resources from this object are its scope stack
@@ -163,6 +175,12 @@ private:
 	/// to a DoAction block
 	size_t _length;
 
+    /// Scan the code for the names that are only defined when used.
+    int scopeNames() const;
+
+    /// The result of scopeNames(), or -1 before the code is scanned.
+    mutable int _scopeNames;
+
 };
 
 /// Add properties to an 'arguments' object.
@@ -41,6 +41,13 @@ Function2::Function2(const action_buffer& ab, as_environment& env,
 {
 }
 
+bool
+Function2::usesSuper() const
+{
+    if (_function2Flags & SUPPRESS_SUPER) return false;
+    return (_function2Flags & PRELOAD_SUPER) || Function::usesSuper();
+}
+
 // Dispatch.
 as_value
 Function2::call(const fn_call& fn)
@@ -119,12 +126,17 @@ Function2::call(const fn_call& fn)
     // local variable, but if both preload and suppress arguments flags
     // are set, an empty array is still placed to the register.
     // This seems like a bug in the reference player.
-    if (!(_function2Flags & SUPPRESS_ARGUMENTS) ||
-            (_function2Flags & PRELOAD_ARGUMENTS)) {
+    //
+    // When it isn't preloaded, 'arguments' is only needed if the code
+    // refers to it.
+    const bool fillArgs = !(_function2Flags & SUPPRESS_ARGUMENTS) &&
+        ((_function2Flags & PRELOAD_ARGUMENTS) || usesArguments());
+
+    if (fillArgs || (_function2Flags & PRELOAD_ARGUMENTS)) {
         
         as_object* args = getGlobal(fn).createArray();
 
-        if (!(_function2Flags & SUPPRESS_ARGUMENTS)) {
+        if (fillArgs) {
             getArguments(*this, *args, fn, caller);
         }
 
@@ -142,7 +154,7 @@ Function2::call(const fn_call& fn)
 
     // If super is not suppressed it is either placed in a register
     // or set as a local variable, but not both.
-    if (swfversion > 5 && !(_function2Flags & SUPPRESS_SUPER)) {
+    if (swfversion > 5 && usesSuper()) {
         
         // Put 'super' in a register (SWF6+ only).
         // TOCHECK: should we still set it if not available ?
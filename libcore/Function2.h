@@ -94,6 +94,12 @@ public:
 	/// Dispatch.
 	virtual as_value call(const fn_call& fn);
 
+    /// Whether calls need a 'super' object.
+    //
+    /// This depends on the flags when they say so, and otherwise on the
+    /// code.
+    virtual bool usesSuper() const;
+
 private:
 
     /// The number of registers required.
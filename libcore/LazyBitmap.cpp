@@ -0,0 +1,163 @@
+// LazyBitmap.cpp:  SWF bitmaps decoded on first use, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#include "LazyBitmap.h"
+
+#include <mutex>
+#include <cassert>
+
+#include "Renderer.h"
+#include "GnashImage.h"
+#include "log.h"
+#include "rc.h"
+
+namespace gnash {
+
+namespace {
+
+/// The decoded LazyBitmaps, least recently used first.
+//
+/// Bitmaps are only decoded and trimmed by the thread that renders, but
+/// they may be destroyed by others.
+struct DecodedBitmaps
+{
+    DecodedBitmaps() : bytes(0) {}
+
+    std::mutex mutex;
+    std::list<const LazyBitmap*> used;
+    size_t bytes;
+};
+
+DecodedBitmaps&
+decodedBitmaps()
+{
+    static DecodedBitmaps bitmaps;
+    return bitmaps;
+}
+
+}
+
+LazyBitmap::LazyBitmap(Decoder decoder, Renderer& renderer)
+    :
+    _decoder(std::move(decoder)),
+    _renderer(renderer),
+    _size(0),
+    _failed(false),
+    _disposed(false)
+{
+}
+
+LazyBitmap::~LazyBitmap()
+{
+    DecodedBitmaps& cache = decodedBitmaps();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    drop();
+}
+
+image::GnashImage&
+LazyBitmap::image()
+{
+    assert(!disposed());
+    return decode()->image();
+}
+
+void
+LazyBitmap::dispose()
+{
+    DecodedBitmaps& cache = decodedBitmaps();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    drop();
+    _disposed = true;
+}
+
+const CachedBitmap*
+LazyBitmap::renderable() const
+{
+    // The renderer knows how to draw a disposed bitmap.
+    if (_disposed) return this;
+
+    const CachedBitmap* bm = decode();
+    return _failed ? nullptr : bm;
+}
+
+void
+LazyBitmap::trimCache()
+{
+    const size_t limit =
+        RcInitFile::getDefaultInstance().getBitmapCacheLimit() * 1024;
+    if (!limit) return;
+
+    DecodedBitmaps& cache = decodedBitmaps();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    while (cache.bytes > limit && !cache.used.empty()) {
+        cache.used.front()->drop();
+    }
+}
+
+CachedBitmap*
+LazyBitmap::decode() const
+{
+    DecodedBitmaps& cache = decodedBitmaps();
+
+    if (_decoded) {
+        if (!_failed) {
+            std::lock_guard<std::mutex> lock(cache.mutex);
+            cache.used.splice(cache.used.end(), cache.used, _used);
+        }
+        return _decoded.get();
+    }
+
+    std::unique_ptr<image::GnashImage> im = _decoder();
+
+    if (!im) {
+        log_error(_("Failed to decode bitmap"));
+        _failed = true;
+        std::unique_ptr<image::ImageRGBA> blank(new image::ImageRGBA(1, 1));
+        blank->setPixel(0, 0, 0, 0, 0, 0);
+        im = std::move(blank);
+    }
+
+    _size = im->size();
+    _decoded = _renderer.createStaticBitmap(std::move(im));
+    assert(_decoded);
+
+    if (!_failed) {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        _used = cache.used.insert(cache.used.end(), this);
+        cache.bytes += _size;
+    }
+    return _decoded.get();
+}
+
+void
+LazyBitmap::drop() const
+{
+    if (!_decoded) return;
+
+    if (!_failed) {
+        DecodedBitmaps& cache = decodedBitmaps();
+        cache.used.erase(_used);
+        cache.bytes -= _size;
+    }
+    _decoded.reset();
+}
+
+} // namespace gnash
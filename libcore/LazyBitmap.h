@@ -0,0 +1,117 @@
+// LazyBitmap.h:  SWF bitmaps decoded on first use, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_LAZYBITMAP_H
+#define GNASH_LAZYBITMAP_H
+
+#include <list>
+#include <memory>
+#include <functional>
+#include <boost/intrusive_ptr.hpp>
+
+#include "CachedBitmap.h"
+
+// Forward declarations
+namespace gnash {
+    class Renderer;
+    namespace image {
+        class GnashImage;
+    }
+}
+
+namespace gnash {
+
+/// A bitmap from a SWF definition that is decoded when it is first used.
+//
+/// Only the compressed data is kept in memory when the bitmap is not in
+/// use. The decoded pixels are shared by all movies using the definition;
+/// when their total size exceeds the "bitmapCacheLimit" setting, those
+/// used least recently are dropped by trimCache() and decoded again when
+/// next needed.
+//
+/// Definition bitmaps are only ever read, so changes made through image()
+/// are not guaranteed to survive.
+class LazyBitmap : public CachedBitmap
+{
+public:
+
+    /// Decodes the bitmap, returning null on failure.
+    typedef std::function<std::unique_ptr<image::GnashImage>()> Decoder;
+
+    /// @param decoder      Decodes the compressed data. It is called on
+    ///                     the thread that renders.
+    /// @param renderer     The Renderer to create the decoded bitmap with.
+    ///                     It must exist whenever the bitmap is used.
+    LazyBitmap(Decoder decoder, Renderer& renderer);
+
+    ~LazyBitmap();
+
+    /// Decode the bitmap if necessary.
+    //
+    /// A bitmap that fails to decode is presented as a single transparent
+    /// pixel.
+    virtual image::GnashImage& image();
+
+    virtual void dispose();
+
+    virtual bool disposed() const {
+        return _disposed;
+    }
+
+    /// Decode the bitmap if necessary.
+    virtual const CachedBitmap* renderable() const;
+
+    /// Drop decoded bitmaps until their size is within the limit.
+    //
+    /// The bitmaps used least recently are dropped first. This must not
+    /// be called while rendering, as the renderer holds pointers to
+    /// decoded bitmaps.
+    static void trimCache();
+
+private:
+
+    typedef std::list<const LazyBitmap*> Decoded;
+
+    /// Return the decoded bitmap, decoding it if necessary.
+    CachedBitmap* decode() const;
+
+    /// Free the decoded bitmap.
+    void drop() const;
+
+    const Decoder _decoder;
+
+    Renderer& _renderer;
+
+    mutable boost::intrusive_ptr<CachedBitmap> _decoded;
+
+    /// The size of the decoded pixels in bytes.
+    mutable size_t _size;
+
+    /// Whether decoding failed, in which case _decoded is a placeholder.
+    mutable bool _failed;
+
+    bool _disposed;
+
+    /// The position of this bitmap in the list of decoded bitmaps.
+    mutable Decoded::iterator _used;
+};
+
+} // namespace gnash
+
+#endif
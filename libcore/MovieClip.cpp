@@ -56,6 +56,7 @@
 #include "namedStrings.h"
 #include "LineStyle.h"
 #include "PlaceObject2Tag.h" 
+#include "TimelineSnapshots.h"
 #include "flash/geom/Matrix_as.h"
 #include "GnashNumeric.h"
 #include "InteractiveObject.h"
@@ -1014,7 +1015,23 @@ MovieClip::restoreDisplayList(size_t tgtFrame)
     //assert(tgtFrame <= _currentFrame);
 
     DisplayList tmplist;
-    for (size_t f = 0; f < tgtFrame; ++f) {
+    size_t f = 0;
+
+    // Start from the state saved before an earlier frame, if there is
+    // one, rather than executing the tags of every frame.
+    TimelineSnapshots* snapshots = _def ? _def->snapshots() : nullptr;
+    const TimelineSnapshots::Snapshot* snapshot =
+        snapshots && !isDestroyed() ? snapshots->find(tgtFrame) : nullptr;
+
+    if (snapshot) {
+        _currentFrame = snapshot->frame - 1;
+        for (const SWF::ControlTag* tag : snapshot->tags) {
+            tag->executeState(this, tmplist);
+        }
+        f = snapshot->frame;
+    }
+
+    for (; f < tgtFrame; ++f) {
         _currentFrame = f;
         executeFrameTags(f, tmplist, SWF::ControlTag::TAG_DLIST);
     }
@@ -1195,7 +1212,12 @@ void
 MovieClip::draw(Renderer& renderer, const Transform& xform)
 {
     const DisplayObject::MaskRenderer mr(renderer, *this);
+    drawContents(renderer, xform);
+}
 
+void
+MovieClip::drawContents(Renderer& renderer, const Transform& xform)
+{
     _drawable.finalize();
     _drawable.display(renderer, xform);
     _displayList.display(renderer, xform);
@@ -1212,7 +1234,18 @@ MovieClip::display(Renderer& renderer, const Transform& base)
     
     // Draw everything with our own transform.
     const Transform xform = base * transform();
-    draw(renderer, xform);
+    const DisplayObject::MaskRenderer mr(renderer, *this);
+
+    if (cacheAsBitmap() && displayCached(renderer, xform,
+                [this](Renderer& r, const Transform& x) {
+                    drawContents(r, x);
+                })) {
+        // The children were not displayed, but their flags must be reset
+        // as if they had been.
+        if (childInvalidated()) _displayList.omit_display();
+    }
+    else drawContents(renderer, xform);
+
     clear_invalidated();
 }
 
@@ -1269,6 +1302,10 @@ MovieClip::add_display_object(const SWF::PlaceObject2Tag* tag,
         ch->setBlendMode(static_cast<DisplayObject::BlendMode>(bm));
     }
 
+    if (tag->hasBitmapCaching()) {
+        ch->setCacheAsBitmap(tag->getBitmapCaching());
+    }
+
     // Attach event handlers (if any).
     const SWF::PlaceObject2Tag::EventHandlers& event_handlers =
         tag->getEventHandlers();
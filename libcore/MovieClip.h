@@ -637,6 +637,9 @@ protected:
 
 private:
 
+    /// Draw the drawing API shape and the children, without any mask.
+    void drawContents(Renderer& renderer, const Transform& xform);
+
     /// Process any completed loadVariables request
     void processCompletedLoadVariableRequests();
 
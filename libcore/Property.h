@@ -21,6 +21,7 @@
 #define GNASH_PROPERTY_H
 
 #include <boost/variant.hpp>
+#include <boost/noncopyable.hpp>
 #include <cassert>
 #include <functional>
 #include <typeinfo>
@@ -0,0 +1,139 @@
+// PropertyCache.cpp:  Per-call-site cache of property lookups, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#include "PropertyCache.h"
+
+#include "as_object.h"
+#include "as_value.h"
+#include "Property.h"
+#include "namedStrings.h"
+
+namespace gnash {
+
+PropertyCache::PropertyCache()
+    :
+    _prop(nullptr),
+    _nextMissing(0)
+{
+}
+
+void
+PropertyCache::setURI(const SharedString& name, const ObjectURI& uri)
+{
+    if (!name.interned()) return;
+    _name = name;
+    _uri = uri;
+}
+
+bool
+PropertyCache::Entry::matches(const as_object& obj, const ObjectURI& uri,
+        int version) const
+{
+    if (!depth || chain[0].obj != &obj) return false;
+    if (key.name != uri.name || this->version != version) return false;
+
+    // Each object is only reachable (and so only safe to look at) if
+    // its predecessor's __proto__ is unchanged, so check in order.
+    for (size_t i = 0; i < depth; ++i) {
+        if (chain[i].obj->shape() != chain[i].shape) return false;
+    }
+    return true;
+}
+
+Property*
+PropertyCache::find(const as_object& obj, const ObjectURI& uri,
+        int version) const
+{
+    return _found.matches(obj, uri, version) ? _prop : nullptr;
+}
+
+bool
+PropertyCache::missing(const as_object& obj, const ObjectURI& uri,
+        int version) const
+{
+    for (const Entry& e : _missing) {
+        if (e.matches(obj, uri, version)) return true;
+    }
+    return false;
+}
+
+void
+PropertyCache::store(as_object& obj, const ObjectURI& uri, int version,
+        const as_object& owner, Property& prop)
+{
+    _found.depth = record(_found, obj, &owner, version);
+    if (!_found.depth) return;
+
+    _found.key = uri;
+    _found.version = version;
+    _prop = &prop;
+}
+
+void
+PropertyCache::storeMissing(as_object& obj, const ObjectURI& uri,
+        int version)
+{
+    Entry& e = _missing[_nextMissing];
+    e.depth = record(e, obj, nullptr, version);
+    if (!e.depth) return;
+
+    e.key = uri;
+    e.version = version;
+    _nextMissing = (_nextMissing + 1) % maxMissing;
+}
+
+size_t
+PropertyCache::record(Entry& e, as_object& obj, const as_object* owner,
+        int version)
+{
+    as_object* o = &obj;
+    size_t depth = 0;
+
+    for (;;) {
+
+        if (depth == maxDepth) return 0;
+        e.chain[depth].obj = o;
+        e.chain[depth].shape = o->shape();
+        ++depth;
+
+        if (o == owner) return depth;
+
+        // DisplayObject properties are looked up before the inheritance
+        // chain, and they aren't in any PropertyList.
+        if (o->displayObject()) return 0;
+
+        // Only follow plain __proto__ members, which can't change
+        // without changing the stamp.
+        Property* proto = o->getOwnProperty(NSV::PROP_uuPROTOuu);
+        if (!proto) return owner ? 0 : depth;
+        if (proto->isGetterSetter() || !visible(*proto, version)) return 0;
+
+        // Other values than objects are converted to a new object each
+        // time, except for undefined and null, which end the chain.
+        const as_value& val = proto->getCache();
+        o = val.get_object();
+        if (!o) {
+            if (owner || !(val.is_undefined() || val.is_null())) return 0;
+            return depth;
+        }
+    }
+}
+
+} // namespace gnash
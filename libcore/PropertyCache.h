@@ -0,0 +1,169 @@
+// PropertyCache.h:  Per-call-site cache of property lookups, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_PROPERTYCACHE_H
+#define GNASH_PROPERTYCACHE_H
+
+#include <string>
+#include <cstdint>
+#include <boost/noncopyable.hpp>
+
+#include "ObjectURI.h"
+#include "SharedString.h"
+
+// Forward declarations
+namespace gnash {
+    class as_object;
+    class Property;
+    class VM;
+}
+
+namespace gnash {
+
+/// Remembers the results of property lookups at one call site.
+//
+/// An entry records the object looked up, the objects of its inheritance
+/// chain up to the owner of the Property found, and the PropertyList
+/// stamps (see PropertyList::shape()) of all of them. While none of these
+/// stamps change no Property can have been added, removed or hidden along
+/// that chain, so the cached Property is still the one a full lookup
+/// would find.
+//
+/// The last successful lookup is kept apart from a few failed ones, for
+/// which the whole inheritance chain is recorded. A variable lookup tries
+/// each object of the scope chain in turn, so this lets it skip the
+/// objects that don't have the name and go straight to the one that has.
+//
+/// Only lookups that do not depend on anything but the PropertyLists are
+/// stored: DisplayObject magic properties and __resolve are never cached.
+class PropertyCache : boost::noncopyable
+{
+public:
+
+    PropertyCache();
+
+    /// Return the ObjectURI remembered for a name, or null.
+    //
+    /// Only interned names (ActionPush literals and constants) are
+    /// remembered, and they are matched by identity. Call sites almost
+    /// always use the same one, so the string is neither compared nor
+    /// looked up.
+    const ObjectURI* uri(const SharedString& name) const {
+        return name.interned() && !_uri.empty() && _name == name ?
+            &_uri : nullptr;
+    }
+
+    /// Remember the ObjectURI of an interned name.
+    void setURI(const SharedString& name, const ObjectURI& uri);
+
+    /// Return the cached Property for this lookup, if still valid.
+    //
+    /// @param obj      The object the lookup starts at.
+    /// @param uri      The property name.
+    /// @param version  The SWF version of the lookup.
+    /// @return         The Property, or null if a full lookup is needed.
+    Property* find(const as_object& obj, const ObjectURI& uri,
+            int version) const;
+
+    /// Whether a lookup is known to find nothing.
+    //
+    /// @param obj      The object the lookup starts at.
+    /// @param uri      The property name.
+    /// @param version  The SWF version of the lookup.
+    bool missing(const as_object& obj, const ObjectURI& uri,
+            int version) const;
+
+    /// Record the result of a full lookup.
+    //
+    /// Nothing is stored if the result can't be validated cheaply, for
+    /// instance for long or unusual inheritance chains.
+    //
+    /// @param obj      The object the lookup started at.
+    /// @param uri      The property name.
+    /// @param version  The SWF version of the lookup.
+    /// @param owner    The object in whose PropertyList prop was found.
+    /// @param prop     The Property found.
+    void store(as_object& obj, const ObjectURI& uri, int version,
+            const as_object& owner, Property& prop);
+
+    /// Record that a full lookup, including __resolve, found nothing.
+    //
+    /// Nothing is stored unless the whole inheritance chain can be
+    /// validated cheaply.
+    //
+    /// @param obj      The object the lookup started at.
+    /// @param uri      The property name.
+    /// @param version  The SWF version of the lookup.
+    void storeMissing(as_object& obj, const ObjectURI& uri, int version);
+
+private:
+
+    /// Maximum number of objects checked for a cache hit.
+    static const size_t maxDepth = 4;
+
+    /// Number of failed lookups remembered.
+    static const size_t maxMissing = 3;
+
+    struct Link
+    {
+        const as_object* obj;
+        std::uint32_t shape;
+    };
+
+    /// A lookup starting at one object.
+    struct Entry
+    {
+        Entry() : version(0), depth(0) {}
+
+        /// Whether this is a still valid lookup of uri on obj.
+        bool matches(const as_object& obj, const ObjectURI& uri,
+                int version) const;
+
+        ObjectURI key;
+        int version;
+
+        /// The number of objects in chain, or 0 if the entry is unused.
+        size_t depth;
+        Link chain[maxDepth];
+    };
+
+    /// Record the inheritance chain of obj in an entry.
+    //
+    /// @param owner    The object to stop at, or null to record the
+    ///                 whole chain.
+    /// @return         The number of objects recorded, or 0 if the chain
+    ///                 can't be validated by its stamps.
+    static size_t record(Entry& e, as_object& obj, const as_object* owner,
+            int version);
+
+    SharedString _name;
+    ObjectURI _uri;
+
+    /// The last lookup that found a Property, and the Property.
+    Entry _found;
+    Property* _prop;
+
+    /// The last lookups that found nothing, replaced in turn.
+    Entry _missing[maxMissing];
+    size_t _nextMissing;
+};
+
+} // namespace gnash
+
+#endif
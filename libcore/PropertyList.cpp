@@ -26,7 +26,8 @@
 
 #include <utility> 
 #include <functional> 
-#include <boost/tuple/tuple.hpp>
+#include <new>
+#include <memory>
 
 #include "Property.h" 
 #include "as_environment.h"
@@ -36,6 +37,7 @@
 #include "VM.h" 
 #include "string_table.h"
 #include "GnashAlgorithm.h"
+#include "namedStrings.h"
 
 // Define the following to enable printing address of each property added
 //#define DEBUG_PROPERTY_ALLOC
@@ -48,59 +50,346 @@
 
 #ifdef GNASH_STATS_PROPERTY_LOOKUPS
 # include "Stats.h"
-# include "namedStrings.h"
 #endif
 
 namespace gnash {
 
 namespace {
 
-inline
-PropertyList::const_iterator
-iterator_find(const PropertyList::container& p, const ObjectURI& uri, VM& vm)
+/// Source of PropertyList stamps.
+//
+/// ActionScript objects are only touched by the main thread, so this
+/// needs no locking.
+std::uint32_t shapeCounter = 0;
+
+inline std::uint32_t
+newShape()
 {
-    const bool caseless = vm.getSWFVersion() < 7;
+    return ++shapeCounter;
+}
 
-    if (!caseless) {
-        return p.project<PropertyList::CreationOrder>(
-                p.get<PropertyList::Case>().find(uri));
+/// Lists with more properties than this are indexed.
+const std::uint32_t linearScanLimit = 8;
+
+/// Number of slots in the first chunk; each further chunk doubles.
+const std::uint32_t firstChunkSize = 2;
+
+/// Marks a deleted hash entry, so that probing continues past it.
+template<typename T>
+inline T*
+tombstone()
+{
+    return reinterpret_cast<T*>(static_cast<std::uintptr_t>(1));
+}
+
+inline std::uint32_t
+hashKey(string_table::key k)
+{
+    // Fibonacci hashing spreads the mostly sequential keys.
+    return static_cast<std::uint32_t>(k) * 2654435761U;
+}
+
+/// The exact name of the Property in a slot.
+struct NameOf
+{
+    template<typename T>
+    string_table::key operator()(const T* s) const {
+        return s->prop().uri().name;
+    }
+};
+
+/// The case-insensitive name of the Property in a slot.
+class NoCaseOf
+{
+public:
+    explicit NoCaseOf(string_table& st) : _st(st) {}
+    template<typename T>
+    string_table::key operator()(const T* s) const {
+        return s->prop().uri().noCase(_st);
+    }
+private:
+    string_table& _st;
+};
+
+template<typename T, typename KeyOf>
+T*
+hashFind(T* const* table, std::uint32_t size, string_table::key k,
+        KeyOf keyOf)
+{
+    const std::uint32_t mask = size - 1;
+    for (std::uint32_t i = hashKey(k) & mask; ; i = (i + 1) & mask) {
+        T* s = table[i];
+        if (!s) return nullptr;
+        if (s != tombstone<T>() && keyOf(s) == k) return s;
     }
-        
-    return p.project<PropertyList::CreationOrder>(
-            p.get<PropertyList::NoCase>().find(uri));
 }
 
+template<typename T>
+void
+hashAdd(T** table, std::uint32_t size, T* slot, string_table::key k)
+{
+    const std::uint32_t mask = size - 1;
+    std::uint32_t i = hashKey(k) & mask;
+    while (table[i] && table[i] != tombstone<T>()) i = (i + 1) & mask;
+    table[i] = slot;
 }
-    
+
+template<typename T>
+void
+hashRemove(T** table, std::uint32_t size, T* slot, string_table::key k)
+{
+    const std::uint32_t mask = size - 1;
+    for (std::uint32_t i = hashKey(k) & mask; table[i]; i = (i + 1) & mask) {
+        if (table[i] == slot) {
+            table[i] = tombstone<T>();
+            return;
+        }
+    }
+}
+
+}
+
+struct PropertyList::Chunk
+{
+    Chunk(std::uint32_t n, Chunk* nx)
+        :
+        next(nx),
+        slots(new Slot[n])
+    {}
+
+    Chunk* next;
+    std::unique_ptr<Slot[]> slots;
+};
+
 PropertyList::PropertyList(as_object& obj)
     :
-    _props(boost::make_tuple(
-                boost::tuple<>(),
-                boost::make_tuple(
-                    KeyExtractor(),
-                    ObjectURI::LessThan()
-                ),
-                boost::make_tuple(
-                    KeyExtractor(),
-                    ObjectURI::CaseLessThan(getStringTable(obj), true)
-                )
-            )
-        ),
+    _first(nullptr),
+    _last(nullptr),
+    _free(nullptr),
+    _chunks(nullptr),
+    _size(0),
+    _capacity(0),
+    _names(),
+    _noCaseNames(),
+    _caseDuplicates(false),
+    _shape(newShape()),
     _owner(obj)
 {
 }
 
+PropertyList::~PropertyList()
+{
+    clear();
+}
+
+void
+PropertyList::shapeChanged()
+{
+    _shape = newShape();
+}
+
+PropertyList::Slot*
+PropertyList::allocSlot()
+{
+    if (!_free) {
+        const std::uint32_t n = _capacity ? _capacity : firstChunkSize;
+        _chunks = new Chunk(n, _chunks);
+        for (std::uint32_t i = n; i > 0; --i) {
+            Slot* s = &_chunks->slots[i - 1];
+            s->next = _free;
+            _free = s;
+        }
+        _capacity += n;
+    }
+    Slot* s = _free;
+    _free = s->next;
+    return s;
+}
+
+void
+PropertyList::buildIndex(HashIndex& index, bool caseless) const
+{
+    std::uint32_t size = 16;
+    while (size < _size * 4) size *= 2;
+
+    delete [] index.table;
+    index.table = new Slot*[size]();
+    index.size = size;
+    index.used = 0;
+
+    if (!caseless) {
+        for (Slot* s = _first; s; s = s->next) {
+            hashAdd(index.table, size, s, s->prop().uri().name);
+            ++index.used;
+        }
+        return;
+    }
+
+    // Only the earliest of properties with the same case-insensitive
+    // name is found by caseless lookups.
+    NoCaseOf noCase(getStringTable(_owner));
+    for (Slot* s = _first; s; s = s->next) {
+        const string_table::key k = noCase(s);
+        if (hashFind(index.table, size, k, noCase)) {
+            _caseDuplicates = true;
+            continue;
+        }
+        hashAdd(index.table, size, s, k);
+        ++index.used;
+    }
+}
+
+void
+PropertyList::indexName(Slot* slot)
+{
+    if ((_names.used + 1) * 2 > _names.size) {
+        buildIndex(_names, false);
+        return;
+    }
+    hashAdd(_names.table, _names.size, slot, slot->prop().uri().name);
+    ++_names.used;
+}
+
+void
+PropertyList::indexNoCase(Slot* slot)
+{
+    NoCaseOf noCase(getStringTable(_owner));
+    const string_table::key k = noCase(slot);
+
+    if (hashFind(_noCaseNames.table, _noCaseNames.size, k, noCase)) {
+        _caseDuplicates = true;
+        return;
+    }
+    if ((_noCaseNames.used + 1) * 2 > _noCaseNames.size) {
+        buildIndex(_noCaseNames, true);
+        return;
+    }
+    hashAdd(_noCaseNames.table, _noCaseNames.size, slot, k);
+    ++_noCaseNames.used;
+}
+
+PropertyList::Slot*
+PropertyList::find(const ObjectURI& uri, bool caseless) const
+{
+    if (!caseless) {
+        if (_names.table) {
+            return hashFind(_names.table, _names.size, uri.name, NameOf());
+        }
+        for (Slot* s = _first; s; s = s->next) {
+            if (s->prop().uri().name == uri.name) return s;
+        }
+        return nullptr;
+    }
+
+    NoCaseOf noCase(getStringTable(_owner));
+    const string_table::key k = uri.noCase(getStringTable(_owner));
+
+    if (!_noCaseNames.table && _size > linearScanLimit) {
+        buildIndex(_noCaseNames, true);
+    }
+    if (_noCaseNames.table) {
+        return hashFind(_noCaseNames.table, _noCaseNames.size, k, noCase);
+    }
+    for (Slot* s = _first; s; s = s->next) {
+        if (noCase(s) == k) return s;
+    }
+    return nullptr;
+}
+
+PropertyList::Slot*
+PropertyList::find(const ObjectURI& uri) const
+{
+    return find(uri, getVM(_owner).getSWFVersion() < 7);
+}
+
+void
+PropertyList::insert(const Property& prop)
+{
+    Slot* slot = allocSlot();
+    new (&slot->storage) Property(prop);
+
+    slot->prev = _last;
+    slot->next = nullptr;
+    if (_last) _last->next = slot;
+    else _first = slot;
+    _last = slot;
+    ++_size;
+
+    if (_names.table) indexName(slot);
+    else if (_size > linearScanLimit) buildIndex(_names, false);
+
+    if (_noCaseNames.table) indexNoCase(slot);
+
+    _shape = newShape();
+}
+
+void
+PropertyList::replace(Slot* slot, const Property& prop)
+{
+    const bool renamed = slot->prop().uri().name != prop.uri().name;
+
+    if (renamed && _names.table) {
+        hashRemove(_names.table, _names.size, slot, slot->prop().uri().name);
+    }
+
+    // The slot is reused so that pointers to the Property stay valid.
+    slot->prop().~Property();
+    new (&slot->storage) Property(prop);
+
+    if (renamed && _names.table) {
+        hashAdd(_names.table, _names.size, slot, slot->prop().uri().name);
+    }
+
+    _shape = newShape();
+}
+
+void
+PropertyList::erase(Slot* slot)
+{
+    if (_names.table) {
+        hashRemove(_names.table, _names.size, slot, slot->prop().uri().name);
+    }
+
+    if (_noCaseNames.table) {
+        NoCaseOf noCase(getStringTable(_owner));
+        const string_table::key k = noCase(slot);
+        if (hashFind(_noCaseNames.table, _noCaseNames.size, k, noCase) ==
+                slot) {
+            hashRemove(_noCaseNames.table, _noCaseNames.size, slot, k);
+            // Another property may now be the earliest with this name.
+            if (_caseDuplicates) {
+                for (Slot* s = _first; s; s = s->next) {
+                    if (s == slot || noCase(s) != k) continue;
+                    hashAdd(_noCaseNames.table, _noCaseNames.size, s, k);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (slot->prev) slot->prev->next = slot->next;
+    else _first = slot->next;
+    if (slot->next) slot->next->prev = slot->prev;
+    else _last = slot->prev;
+    --_size;
+
+    slot->prop().~Property();
+    slot->next = _free;
+    _free = slot;
+
+    _shape = newShape();
+}
+
 bool
 PropertyList::setValue(const ObjectURI& uri, const as_value& val,
         const PropFlags& flagsIfMissing)
 {
-	const_iterator found = iterator_find(_props, uri, getVM(_owner));
+	Slot* found = find(uri);
 	
-	if (found == _props.end()) {
+	if (!found) {
 		// create a new member
 		Property a(uri, val, flagsIfMissing);
-		// Non slot properties are negative ordering in insertion order
-		_props.push_back(a);
+		insert(a);
 #ifdef GNASH_DEBUG_PROPERTY
         ObjectURI::Logger l(getStringTable(_owner));
         log_debug("Simple AS property %s inserted with flags %s",
@@ -109,7 +398,11 @@ PropertyList::setValue(const ObjectURI& uri, const as_value& val,
 		return true;
 	}
 
-	const Property& prop = *found;
+	const Property& prop = found->prop();
+
+	// The inheritance chain depends on __proto__.
+	if (prop.uri().name == NSV::PROP_uuPROTOuu) _shape = newShape();
+
 	return prop.setValue(_owner, val);
 
 }
@@ -117,22 +410,24 @@ PropertyList::setValue(const ObjectURI& uri, const as_value& val,
 void
 PropertyList::setFlags(const ObjectURI& uri, int setFlags, int clearFlags)
 {
-	iterator found = iterator_find(_props, uri, getVM(_owner));
-	if (found == _props.end()) return;
-    PropFlags f = found->getFlags();
+	Slot* found = find(uri);
+	if (!found) return;
+    PropFlags f = found->prop().getFlags();
     f.set_flags(setFlags, clearFlags);
-	found->setFlags(f);
+	found->prop().setFlags(f);
+	_shape = newShape();
 
 }
 
 void
 PropertyList::setFlagsAll(int setFlags, int clearFlags)
 {
-    for (const auto& prop: _props) {
+    for (const auto& prop: *this) {
         PropFlags f = prop.getFlags();
         f.set_flags(setFlags, clearFlags);
         prop.setFlags(f);
     }
+    _shape = newShape();
 }
 
 Property*
@@ -145,26 +440,26 @@ PropertyList::getProperty(const ObjectURI& uri) const
         getStringTable(_owner), 10000000, NSV::PROP_uuPROTOuu, 10);
     kcl.check(uri.name);
 #endif // GNASH_STATS_PROPERTY_LOOKUPS
-	iterator found = iterator_find(_props, uri, getVM(_owner));
-	if (found == _props.end()) return nullptr;
-	return const_cast<Property*>(&(*found));
+	Slot* found = find(uri);
+	if (!found) return nullptr;
+	return &found->prop();
 }
 
 std::pair<bool,bool>
 PropertyList::delProperty(const ObjectURI& uri)
 {
 	//GNASH_REPORT_FUNCTION;
-	iterator found = iterator_find(_props, uri, getVM(_owner));
-	if (found == _props.end()) {
+	Slot* found = find(uri);
+	if (!found) {
 		return std::make_pair(false, false);
 	}
 
 	// check if member is protected from deletion
-	if (found->getFlags().test<PropFlags::dontDelete>()) {
+	if (found->prop().getFlags().test<PropFlags::dontDelete>()) {
 		return std::make_pair(true, false);
 	}
 
-	_props.erase(found);
+	erase(found);
 	return std::make_pair(true, true);
 }
 
@@ -173,7 +468,7 @@ PropertyList::visitKeys(KeyVisitor& visitor, PropertyTracker& donelist)
     const
 {
     // We should enumerate in order of creation, not lexicographically.
-	for (const auto& prop : _props) {
+	for (const auto& prop : *this) {
 
 		if (prop.getFlags().test<PropFlags::dontEnum>()) continue;
 
@@ -189,7 +484,7 @@ void
 PropertyList::dump()
 {
     ObjectURI::Logger l(getStringTable(_owner));
-	for (const auto& prop : _props) {
+	for (const auto& prop : *this) {
             log_debug("  %s: %s", l(prop.uri()), prop.getValue(_owner));
 	}
 }
@@ -200,13 +495,13 @@ PropertyList::addGetterSetter(const ObjectURI& uri, as_function& getter,
 	const PropFlags& flagsIfMissing)
 {
 	Property a(uri, &getter, setter, flagsIfMissing);
-	iterator found = iterator_find(_props, uri, getVM(_owner));
+	Slot* found = find(uri);
     
-	if (found != _props.end()) {
+	if (found) {
 		// copy flags from previous member (even if it's a normal member ?)
-		a.setFlags(found->getFlags());
-		a.setCache(found->getCache());
-		_props.replace(found, a);
+		a.setFlags(found->prop().getFlags());
+		a.setCache(found->prop().getCache());
+		replace(found, a);
 
 #ifdef GNASH_DEBUG_PROPERTY
         ObjectURI::Logger l(getStringTable(_owner));
@@ -217,7 +512,7 @@ PropertyList::addGetterSetter(const ObjectURI& uri, as_function& getter,
 	}
 	else {
 		a.setCache(cacheVal);
-		_props.push_back(a);
+		insert(a);
 #ifdef GNASH_DEBUG_PROPERTY
         ObjectURI::Logger l(getStringTable(_owner));
         log_debug("AS GetterSetter %s inserted with flags %s", l(uri),
@@ -234,12 +529,12 @@ PropertyList::addGetterSetter(const ObjectURI& uri, as_c_function_ptr getter,
 {
 	Property a(uri, getter, setter, flagsIfMissing);
 
-	const_iterator found = iterator_find(_props, uri, getVM(_owner));
-	if (found != _props.end())
+	Slot* found = find(uri);
+	if (found)
 	{
 		// copy flags from previous member (even if it's a normal member ?)
-		a.setFlags(found->getFlags());
-		_props.replace(found, a);
+		a.setFlags(found->prop().getFlags());
+		replace(found, a);
 
 #ifdef GNASH_DEBUG_PROPERTY
         ObjectURI::Logger l(getStringTable(_owner));
@@ -250,7 +545,7 @@ PropertyList::addGetterSetter(const ObjectURI& uri, as_c_function_ptr getter,
 	}
 	else
 	{
-		_props.push_back(a);
+		insert(a);
 #ifdef GNASH_DEBUG_PROPERTY
 		string_table& st = getStringTable(_owner);
 		log_debug("Native GetterSetter %s in namespace %s inserted with "
@@ -265,8 +560,7 @@ bool
 PropertyList::addDestructiveGetter(const ObjectURI& uri, as_function& getter, 
 	const PropFlags& flagsIfMissing)
 {
-	const_iterator found = iterator_find(_props, uri, getVM(_owner));
-	if (found != _props.end())
+	if (find(uri))
 	{
         ObjectURI::Logger l(getStringTable(_owner));
         log_error(_("Property %s already exists, can't addDestructiveGetter"),
@@ -277,7 +571,7 @@ PropertyList::addDestructiveGetter(const ObjectURI& uri, as_function& getter,
 	// destructive getter doesn't need a setter
 	Property a(uri, &getter, nullptr, flagsIfMissing, true);
 
-	_props.push_back(a);
+	insert(a);
 
 #ifdef GNASH_DEBUG_PROPERTY
     ObjectURI::Logger l(getStringTable(_owner));
@@ -292,12 +586,11 @@ bool
 PropertyList::addDestructiveGetter(const ObjectURI& uri,
 	as_c_function_ptr getter, const PropFlags& flagsIfMissing)
 {
-	iterator found = iterator_find(_props, uri, getVM(_owner));
-	if (found != _props.end()) return false; 
+	if (find(uri)) return false; 
 
 	// destructive getter doesn't need a setter
 	Property a(uri, getter, nullptr, flagsIfMissing, true);
-	_props.push_back(a);
+	insert(a);
 
 #ifdef GNASH_DEBUG_PROPERTY
     ObjectURI::Logger l(getStringTable(_owner));
@@ -310,7 +603,22 @@ PropertyList::addDestructiveGetter(const ObjectURI& uri,
 void
 PropertyList::clear()
 {
-	_props.clear();
+	for (Slot* s = _first; s; s = s->next) s->prop().~Property();
+
+	while (_chunks) {
+		Chunk* c = _chunks;
+		_chunks = c->next;
+		delete c;
+	}
+	delete [] _names.table;
+	delete [] _noCaseNames.table;
+
+	_first = _last = _free = nullptr;
+	_size = _capacity = 0;
+	_names = HashIndex();
+	_noCaseNames = HashIndex();
+	_caseDuplicates = false;
+	_shape = newShape();
 }
 
 } // namespace gnash
@@ -24,10 +24,7 @@
 #include <cassert> // for inlines
 #include <utility> // for std::pair
 #include <cstdint>
-#include <boost/multi_index_container.hpp>
-#include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/sequenced_index.hpp>
-#include <boost/multi_index/key_extractors.hpp>
+#include <type_traits>
 #include <boost/noncopyable.hpp>
 #include <functional>
 #include <algorithm>
@@ -78,60 +75,79 @@ public:
 /// as_object, not just original as_object it was use with. Currently (as
 /// there is no use for this scenario) it is not possible to change the
 /// owner.
+//
+/// Properties are kept in a flat array of slots, which grows in chunks
+/// and is searched linearly while small. Larger lists get an open-addressing
+/// hash keyed on string_table::key, and a second one for case-insensitive
+/// names, built only if SWF6 or lower code looks up a property. Most
+/// objects have a handful of properties and never need either index.
 class PropertyList : boost::noncopyable
 {
+
+    /// Storage for one Property.
+    //
+    /// Slots never move once allocated, so Property pointers stay valid
+    /// until the Property is deleted. Live slots are linked in creation
+    /// order; deleted slots are linked in a free list for reuse.
+    struct Slot
+    {
+        Property& prop() {
+            return *reinterpret_cast<Property*>(&storage);
+        }
+        const Property& prop() const {
+            return *reinterpret_cast<const Property*>(&storage);
+        }
+
+        std::aligned_storage<sizeof(Property),
+                 alignof(Property)>::type storage;
+        Slot* prev;
+        Slot* next;
+    };
+
+    /// A block of Slots, allocated in doubling sizes.
+    struct Chunk;
+
+    /// An open-addressing hash of Slots keyed by string_table::key.
+    struct HashIndex
+    {
+        HashIndex() : table(nullptr), size(0), used(0) {}
+        Slot** table;
+        std::uint32_t size;
+        std::uint32_t used;
+    };
+
 public:
 
     typedef std::set<ObjectURI, ObjectURI::LessThan> PropertyTracker;
     typedef Property value_type;
 
-    /// Identifier for the sequenced index
-    struct CreationOrder {};
-
-    /// The sequenced index in creation order.
-    typedef boost::multi_index::sequenced<
-        boost::multi_index::tag<CreationOrder> > SequencedIndex;
-    
-    struct KeyExtractor
+    /// Iterator over the Properties in creation order.
+    class const_iterator
     {
-        typedef const ObjectURI& result_type;
-        result_type operator()(const Property& p) const {
-            return p.uri();
+    public:
+        const_iterator(const Slot* s = nullptr) : _slot(s) {}
+        const Property& operator*() const { return _slot->prop(); }
+        const Property* operator->() const { return &_slot->prop(); }
+        const_iterator& operator++() { _slot = _slot->next; return *this; }
+        bool operator==(const const_iterator& o) const {
+            return _slot == o._slot;
         }
+        bool operator!=(const const_iterator& o) const {
+            return _slot != o._slot;
+        }
+    private:
+        const Slot* _slot;
     };
 
-    /// Identifier for the case-sensitive index
-    struct Case {};
-    
-    /// The case-sensitive index
-    typedef boost::multi_index::ordered_unique<
-        boost::multi_index::tag<Case>,
-        KeyExtractor,
-        ObjectURI::LessThan> CaseIndex;
-
-    /// Identifier for the case-insensitive index
-    struct NoCase {};
-    
-    /// The case-insensitive index
-    typedef boost::multi_index::ordered_non_unique<
-        boost::multi_index::tag<NoCase>,
-        KeyExtractor,
-        ObjectURI::CaseLessThan> NoCaseIndex;
-
-    /// The container of the Properties.
-    typedef boost::multi_index_container<
-        value_type,
-        boost::multi_index::indexed_by<SequencedIndex, CaseIndex, NoCaseIndex>
-        > container;
-
-    typedef container::iterator iterator;
-    typedef container::const_iterator const_iterator;
+    typedef const_iterator iterator;
 
     /// Construct the PropertyList 
     //
     /// @param obj      The as_object to which this PropertyList belongs.
     DSOTEXPORT PropertyList(as_object& obj);
 
+    ~PropertyList();
+
     /// Visit properties 
     //
     /// The method will invoke the given visitor method
@@ -150,7 +166,7 @@ public:
     template <class U, class V>
     void visitValues(V& visitor, U cmp = U()) const {
 
-        for (const auto& prop : _props) {
+        for (const auto& prop : *this) {
 
             if (!cmp(prop)) continue;
             as_value val = prop.getValue(_owner);
@@ -279,13 +295,21 @@ public:
 
     /// Return number of properties in this list
     size_t size() const {
-        return _props.size();
+        return _size;
+    }
+
+    /// Iterate over the properties in creation order.
+    const_iterator begin() const {
+        return const_iterator(_first);
+    }
+
+    const_iterator end() const {
+        return const_iterator();
     }
 
     /// Dump all members (using log_debug)
     //
-    /// This does not reflect the normal enumeration order. It is sorted
-    /// lexicographically by property.
+    /// Members are listed in creation order.
     void dump();
 
     /// Mark all properties reachable
@@ -293,13 +317,81 @@ public:
     /// This can be called very frequently, so is inlined to allow the
     /// compiler to optimize it.
     void setReachable() const {
-        std::for_each(_props.begin(), _props.end(),
-                std::mem_fn(&Property::setReachable));
+        for (const Slot* s = _first; s; s = s->next) {
+            s->prop().setReachable();
+        }
     }
 
+    /// Return a stamp identifying the current layout of this list.
+    //
+    /// The stamp changes whenever a Property is added, removed or
+    /// replaced, when flags change, and when __proto__ is reassigned.
+    /// Stamps are unique across all PropertyLists, so a stamp never
+    /// matches a different (or recycled) list. Changing the value of
+    /// an existing Property does not change the stamp.
+    std::uint32_t shape() const {
+        return _shape;
+    }
+
+    /// Force a new stamp, for layout changes made through a Property.
+    void shapeChanged();
+
 private:
 
-    container _props;
+    /// Find the slot of a Property.
+    //
+    /// @param caseless     Whether to match names case-insensitively, as
+    ///                     for SWF6 and lower. The earliest created match
+    ///                     is returned.
+    Slot* find(const ObjectURI& uri, bool caseless) const;
+
+    /// Find a Property for the VM's current SWF version.
+    Slot* find(const ObjectURI& uri) const;
+
+    /// Append a Property in creation order.
+    void insert(const Property& prop);
+
+    /// Replace the Property in a slot, keeping its creation order.
+    void replace(Slot* slot, const Property& prop);
+
+    /// Delete a Property and recycle its slot.
+    void erase(Slot* slot);
+
+    /// Get a free slot, allocating a new Chunk if needed.
+    Slot* allocSlot();
+
+    /// Add a slot to the index of exact names.
+    void indexName(Slot* slot);
+
+    /// Add a slot to the index of case-insensitive names.
+    void indexNoCase(Slot* slot);
+
+    /// Build the indices once there are too many properties to scan.
+    void buildIndex(HashIndex& index, bool caseless) const;
+
+    /// The first and last Property in creation order.
+    Slot* _first;
+    Slot* _last;
+
+    /// Unused slots.
+    Slot* _free;
+
+    /// Owned storage.
+    Chunk* _chunks;
+
+    std::uint32_t _size;
+    std::uint32_t _capacity;
+
+    /// Index of exact names, built when the list grows.
+    mutable HashIndex _names;
+
+    /// Index of case-insensitive names, built on first caseless lookup.
+    mutable HashIndex _noCaseNames;
+
+    /// Whether two properties ever had the same case-insensitive name.
+    mutable bool _caseDuplicates;
+
+    std::uint32_t _shape;
 
     as_object& _owner;
 
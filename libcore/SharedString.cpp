@@ -0,0 +1,91 @@
+// SharedString.cpp:  Immutable reference-counted strings, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#include "SharedString.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace gnash {
+
+SharedString::SharedString()
+{
+}
+
+SharedString::SharedString(std::string s)
+{
+    // Empty strings are common and need no buffer.
+    if (!s.empty()) _rep = new Rep(std::move(s), false);
+}
+
+struct SharedString::Pool
+{
+    typedef std::unordered_map<std::string,
+            boost::intrusive_ptr<const Rep>> Strings;
+
+    std::mutex mutex;
+    Strings strings;
+};
+
+SharedString::Pool&
+SharedString::pool()
+{
+    static Pool p;
+    return p;
+}
+
+SharedString
+SharedString::intern(const std::string& s)
+{
+    if (s.empty()) return SharedString();
+
+    Pool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+
+    Pool::Strings::iterator it = p.strings.find(s);
+    if (it == p.strings.end()) {
+        it = p.strings.insert(std::make_pair(s, new Rep(s, true))).first;
+    }
+    return SharedString(it->second.get());
+}
+
+void
+SharedString::prune()
+{
+    Pool& p = pool();
+    std::lock_guard<std::mutex> lock(p.mutex);
+
+    // No new references can be taken while the pool is locked, so a
+    // string held only by the pool stays unused.
+    for (Pool::Strings::iterator it = p.strings.begin();
+            it != p.strings.end();) {
+        if (it->second->get_ref_count() == 1) it = p.strings.erase(it);
+        else ++it;
+    }
+}
+
+const std::string&
+SharedString::emptyString()
+{
+    static const std::string empty;
+    return empty;
+}
+
+} // namespace gnash
@@ -0,0 +1,108 @@
+// SharedString.h:  Immutable reference-counted strings, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_SHAREDSTRING_H
+#define GNASH_SHAREDSTRING_H
+
+#include <string>
+#include <boost/intrusive_ptr.hpp>
+
+#include "ref_counted.h"
+#include "dsodefs.h"
+
+namespace gnash {
+
+/// An immutable string whose copies share one buffer.
+//
+/// This is the string representation of as_value. Copying is O(1), so
+/// string values can be pushed, stored in registers and properties and
+/// returned without allocating.
+//
+/// Interned strings are unique per content, so two of them are equal only
+/// if they share a buffer. Interning is meant for strings that live as
+/// long as the movie anyway, such as ActionPush literals. They are kept
+/// in a pool until prune() finds them unused.
+class DSOEXPORT SharedString
+{
+public:
+
+    /// Construct an empty string.
+    SharedString();
+
+    explicit SharedString(std::string s);
+
+    /// Return the unique interned copy of a string.
+    static SharedString intern(const std::string& s);
+
+    /// Free interned strings that are only referenced by the pool.
+    //
+    /// This walks the whole pool, so it is meant to be called when
+    /// movies are unloaded.
+    static void prune();
+
+    const std::string& str() const {
+        return _rep ? _rep->str : emptyString();
+    }
+
+    bool empty() const {
+        return str().empty();
+    }
+
+    bool operator==(const SharedString& o) const {
+        if (_rep == o._rep) return true;
+        if (_rep && o._rep && _rep->interned && o._rep->interned) {
+            return false;
+        }
+        return str() == o.str();
+    }
+
+    bool operator!=(const SharedString& o) const {
+        return !(*this == o);
+    }
+
+    /// Whether this is the interned copy of its string.
+    bool interned() const {
+        return _rep && _rep->interned;
+    }
+
+private:
+
+    class Rep : public ref_counted
+    {
+    public:
+        Rep(std::string s, bool i) : str(std::move(s)), interned(i) {}
+        const std::string str;
+        const bool interned;
+    };
+
+    /// The interned strings.
+    struct Pool;
+
+    static Pool& pool();
+
+    explicit SharedString(const Rep* rep) : _rep(rep) {}
+
+    static const std::string& emptyString();
+
+    boost::intrusive_ptr<const Rep> _rep;
+};
+
+} // namespace gnash
+
+#endif
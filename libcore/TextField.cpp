@@ -37,6 +37,7 @@
 #include <utility>
 #include <map>
 #include <functional>
+#include <boost/tuple/tuple.hpp>
 
 #include "utf8.h"
 #include "log.h"
@@ -35,6 +35,7 @@
 #include "namedStrings.h"
 #include "CallStack.h"
 #include "Global_as.h"
+#include "PropertyCache.h"
 
 // Define this to have find_target() calls trigger debugging output
 //#define DEBUG_TARGET_FINDING 1
@@ -88,7 +89,15 @@ namespace {
     as_value getVariableRaw(const as_environment& env,
         const std::string& varname,
         const as_environment::ScopeStack& scope,
-        as_object** retTarget = nullptr);
+        as_object** retTarget = nullptr, PropertyCache* cache = nullptr,
+        const ObjectURI* uri = nullptr);
+
+    /// Get a member, going through the call site's cache if there is one.
+    inline bool getMember(as_object& obj, const ObjectURI& uri,
+            as_value& val, PropertyCache* cache) {
+        return cache ? obj.get_member(uri, &val, *cache) :
+                       obj.get_member(uri, &val);
+    }
 
     void setVariableRaw(const as_environment& env, const std::string& varname,
         const as_value& val, const as_environment::ScopeStack& scope);
@@ -287,7 +296,8 @@ as_environment::markReachableResources() const
 
 as_value
 getVariable(const as_environment& env, const std::string& varname,
-        const as_environment::ScopeStack& scope, as_object** retTarget)
+        const as_environment::ScopeStack& scope, as_object** retTarget,
+        PropertyCache* cache, const ObjectURI* uri)
 {
     // Path lookup rigamarole.
     std::string path;
@@ -300,7 +310,7 @@ getVariable(const as_environment& env, const std::string& varname,
 
         if (target) {
             as_value val;
-            target->get_member(getURI(env.getVM(), var), &val);
+            getMember(*target, getURI(env.getVM(), var), val, cache);
             if (retTarget) *retTarget = target;
             return val;
         }
@@ -321,7 +331,7 @@ getVariable(const as_environment& env, const std::string& varname,
             if (m) return as_value(getObject(m));
         }
     }
-    return getVariableRaw(env, varname, scope, retTarget);
+    return getVariableRaw(env, varname, scope, retTarget, cache, uri);
 }
 
 void
@@ -478,7 +488,8 @@ setVariableRaw(const as_environment& env, const std::string& varname,
 
 as_value
 getVariableRaw(const as_environment& env, const std::string& varname,
-    const as_environment::ScopeStack& scope, as_object** retTarget)
+    const as_environment::ScopeStack& scope, as_object** retTarget,
+    PropertyCache* cache, const ObjectURI* uri)
 {
 
     if (!validRawVariableName(varname)) {
@@ -492,13 +503,13 @@ getVariableRaw(const as_environment& env, const std::string& varname,
 
     VM& vm = env.getVM();
     const int swfVersion = vm.getSWFVersion();
-    const ObjectURI& key = getURI(vm, varname);
+    const ObjectURI key = uri ? *uri : getURI(vm, varname);
 
     // Check the scope stack.
     for (size_t i = scope.size(); i > 0; --i) {
 
         as_object* obj = scope[i - 1];
-        if (obj && obj->get_member(key, &val)) {
+        if (obj && getMember(*obj, key, val, cache)) {
             if (retTarget) *retTarget = obj;
             return val;
         }
@@ -516,7 +527,7 @@ getVariableRaw(const as_environment& env, const std::string& varname,
     if (env.target()) {
         as_object* obj = getObject(env.target());
         //assert(obj);
-        if (obj->get_member(key, &val)) {
+        if (getMember(*obj, key, val, cache)) {
             if (retTarget) *retTarget = obj;
             return val;
         }
@@ -524,7 +535,7 @@ getVariableRaw(const as_environment& env, const std::string& varname,
     else if (env.get_original_target()) {
         as_object* obj = getObject(env.get_original_target());
         //assert(obj);
-        if (obj->get_member(key, &val)) {
+        if (getMember(*obj, key, val, cache)) {
             if (retTarget) *retTarget = obj;
             return val;
         }
@@ -553,7 +564,7 @@ getVariableRaw(const as_environment& env, const std::string& varname,
         return as_value(global);
     }
 
-    if (global->get_member(key, &val)) {
+    if (getMember(*global, key, val, cache)) {
 #ifdef GNASH_DEBUG_GET_VARIABLE
         log_debug("Found %s in _global", varname);
 #endif
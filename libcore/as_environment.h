@@ -25,7 +25,7 @@
 
 #include "dsodefs.h" // for DSOTEXPORT
 #include "as_value.h" 
-#include "SafeStack.h"
+#include "OperandStack.h"
 
 // Forward declarations
 namespace gnash {
@@ -34,6 +34,8 @@ namespace gnash {
     class Global_as;
     class movie_root;
     class string_table;
+    class PropertyCache;
+    struct ObjectURI;
 }
 
 namespace gnash {
@@ -80,32 +82,35 @@ public:
     void reset_target() { _target = _original_target; }
 
     /// Push a value on the stack
+    //
+    /// Space must have been reserved with reserveStack().
     void push(const as_value& val) {
         _stack.push(val);
     }
 
-    /// Pops an as_value off the stack top and return it.
-    as_value pop()
-    try {
-        return _stack.pop();
+    /// Make sure at least n values can be pushed on the stack.
+    void reserveStack(size_t n) {
+        _stack.reserve(n);
     }
-    catch (const StackException&) {
-        return as_value();
+
+    /// Pops an as_value off the stack top and return it.
+    //
+    /// Popping an empty stack gives undefined.
+    as_value pop() {
+        if (_stack.empty()) return as_value();
+        return std::move(_stack.pop());
     }
 
     /// Get stack value at the given distance from top.
     //
     /// top(0) is actual stack top
     ///
-    /// Throw StackException if index is out of range
+    /// Return undefined if index is out of range
     ///
-    as_value& top(size_t dist) const 
-    try {
+    as_value& top(size_t dist) const {
+        if (dist >= _stack.size()) return undefVal;
         return _stack.top(dist);
     }
-    catch (const StackException&) {
-        return undefVal;
-    }
 
     /// Drop 'count' values off the top of the stack.
     void drop(size_t count) {
@@ -131,7 +136,7 @@ private:
     VM& _vm;
 
     /// Stack of as_values in this environment
-    SafeStack<as_value>& _stack;
+    OperandStack<as_value>& _stack;
 
     /// Movie target. 
     DisplayObject* _target;
@@ -150,8 +155,12 @@ private:
 /// @param scope       The Scope stack to use for lookups.
 /// @param retTarget   If not null, the pointer will be set to the actual
 ///                    object containing the found variable (if found).
+/// @param cache       If not null, a lookup cache for the calling site.
+/// @param uri         If not null, the ObjectURI of varname, which saves
+///                    looking it up if it isn't a path.
 as_value getVariable(const as_environment& ctx, const std::string& varname,
-    const as_environment::ScopeStack& scope, as_object** retTarget = nullptr);
+    const as_environment::ScopeStack& scope, as_object** retTarget = nullptr,
+    PropertyCache* cache = nullptr, const ObjectURI* uri = nullptr);
 
 /// Given a path to variable, set its value.
 //
@@ -106,6 +106,11 @@ public:
 	/// Return true if this is a built-in class.
 	virtual bool isBuiltin() { return false; }
 
+    /// Return false if calls to this function never use a 'super' object.
+    //
+    /// Callers can then avoid creating one.
+    virtual bool usesSuper() const { return true; }
+
 protected:
 	
     /// Construct a function.
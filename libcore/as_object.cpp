@@ -40,6 +40,7 @@
 #include "GnashAlgorithm.h"
 #include "DisplayObject.h"
 #include "namedStrings.h"
+#include "PropertyCache.h"
 
 namespace gnash {
 template<typename T>
@@ -376,22 +377,45 @@ as_object::add_property(const std::string& name, as_function& getter,
 ///    Object ends the chain). This should ignore visibility but doesn't.
 bool
 as_object::get_member(const ObjectURI& uri, as_value* val)
+{
+    return getMemberImpl(uri, val, nullptr);
+}
+
+bool
+as_object::get_member(const ObjectURI& uri, as_value* val,
+        PropertyCache& cache)
+{
+    return getMemberImpl(uri, val, &cache);
+}
+
+bool
+as_object::getMemberImpl(const ObjectURI& uri, as_value* val,
+        PropertyCache* cache)
 {
     //assert(val);
 
     const int version = getSWFVersion(*this);
 
-    PrototypeRecursor<IsVisible> pr(this, uri, IsVisible(version));
-	
-    Property* prop = pr.getProperty();
+    Property* prop = cache ? cache->find(*this, uri, version) : nullptr;
+
     if (!prop) {
-        if (displayObject()) {
-            DisplayObject* d = displayObject();
-            if (getDisplayObjectProperty(*d, uri, *val)) return true;
-        }
-        while (pr()) {
-            if ((prop = pr.getProperty())) break;
+
+        if (cache && cache->missing(*this, uri, version)) return false;
+
+        PrototypeRecursor<IsVisible> pr(this, uri, IsVisible(version));
+
+        as_object* owner = this;
+        prop = pr.getProperty(&owner);
+        if (!prop) {
+            if (displayObject()) {
+                DisplayObject* d = displayObject();
+                if (getDisplayObjectProperty(*d, uri, *val)) return true;
+            }
+            while (pr()) {
+                if ((prop = pr.getProperty(&owner))) break;
+            }
         }
+        if (prop && cache) cache->store(*this, uri, version, *owner, *prop);
     }
 
     // If the property isn't found or doesn't apply to any objects in the
@@ -401,17 +425,26 @@ as_object::get_member(const ObjectURI& uri, as_value* val)
         PrototypeRecursor<Exists> pr(this, NSV::PROP_uuRESOLVE);
 
         as_value resolve;
+        bool hasResolve = false;
 
         for (;;) {
             Property* res = pr.getProperty();
             if (res) {
+                hasResolve = true;
                 resolve = res->isGetterSetter() ? res->getCache() :
                                                   res->getValue(*this);
                 if (version < 7) break;
                 if (resolve.is_object()) break;
             }
             // Finished searching.
-            if (!pr()) return false;
+            if (!pr()) {
+                // A __resolve that isn't called now might be after its
+                // value changes, which doesn't change any stamp.
+                if (cache && !hasResolve) {
+                    cache->storeMissing(*this, uri, version);
+                }
+                return false;
+            }
         }
 
         // If __resolve exists, call it with the name of the undefined
@@ -537,7 +570,7 @@ as_object::executeTriggers(Property* prop, const ObjectURI& uri,
     if (!_trigs.get() || (trigIter = _trigs->find(uri)) == _trigs->end()) {
         if (prop) {
             prop->setValue(*this, val);
-            prop->clearVisible(getSWFVersion(*this));
+            clearVisible(*prop);
         }
         return;
     }
@@ -567,10 +600,23 @@ as_object::executeTriggers(Property* prop, const ObjectURI& uri,
     if (!prop) return;
 
     prop->setValue(*this, newVal); 
-    prop->clearVisible(getSWFVersion(*this));
+    clearVisible(*prop);
     
 }
 
+void
+as_object::clearVisible(Property& prop)
+{
+    const int version = getSWFVersion(*this);
+
+    // Making a property visible, or assigning __proto__, changes
+    // the result of lookups.
+    if (!visible(prop, version) || prop.uri().name == NSV::PROP_uuPROTOuu) {
+        _members.shapeChanged();
+    }
+    prop.clearVisible(version);
+}
+
 /// Order of property lookup:
 //
 /// 0. MovieClip textfield variables. TODO: this is a hack and should be
@@ -581,6 +627,20 @@ as_object::executeTriggers(Property* prop, const ObjectURI& uri,
 ///    (a DisplayObject ends the chain).
 bool
 as_object::set_member(const ObjectURI& uri, const as_value& val, bool ifFound)
+{
+    return setMemberImpl(uri, val, ifFound, nullptr);
+}
+
+bool
+as_object::set_member(const ObjectURI& uri, const as_value& val,
+        PropertyCache& cache)
+{
+    return setMemberImpl(uri, val, false, &cache);
+}
+
+bool
+as_object::setMemberImpl(const ObjectURI& uri, const as_value& val,
+        bool ifFound, PropertyCache* cache)
 {
 
     bool tfVarFound = false;
@@ -596,7 +656,14 @@ as_object::set_member(const ObjectURI& uri, const as_value& val, bool ifFound)
 
     PrototypeRecursor<Exists> pr(this, uri);
 
-    Property* prop = pr.getProperty();
+    // Only own properties are cached here, as inherited ones are only
+    // used if they are visible getter-setters.
+    const int swfVersion = getSWFVersion(*this);
+    Property* prop = cache ? cache->find(*this, uri, swfVersion) : nullptr;
+    if (!prop) {
+        prop = pr.getProperty();
+        if (prop && cache) cache->store(*this, uri, swfVersion, *this, *prop);
+    }
 
     // We won't scan the inheritance chain if we find a member,
     // even if invisible.
@@ -608,10 +675,9 @@ as_object::set_member(const ObjectURI& uri, const as_value& val, bool ifFound)
             // TODO: should we execute triggers?
         }
             
-        const int version = getSWFVersion(*this);
         while (pr()) {
             if ((prop = pr.getProperty())) {
-                if ((prop->isGetterSetter()) && visible(*prop, version)) {
+                if ((prop->isGetterSetter()) && visible(*prop, swfVersion)) {
                     break;
                 }
                 else prop = nullptr;
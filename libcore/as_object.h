@@ -50,6 +50,7 @@ namespace gnash {
     class Global_as;
     class as_value;
     class string_table;
+    class PropertyCache;
 }
 
 namespace gnash {
@@ -228,6 +229,17 @@ public:
     virtual bool set_member(const ObjectURI& uri, const as_value& val,
         bool ifFound = false);
 
+    /// Set a member value, using a per-call-site lookup cache
+    //
+    /// This behaves exactly like set_member(uri, val), but an existing
+    /// own property is taken from the cache when still valid.
+    //
+    /// @param uri      Property identifier.
+    /// @param val      Value to assign to the named property.
+    /// @param cache    The cache for the calling site.
+    bool set_member(const ObjectURI& uri, const as_value& val,
+        PropertyCache& cache);
+
     /// Initialize a member value by string
     //
     /// This is just a wrapper around the other init_member method
@@ -426,6 +438,17 @@ public:
     /// @return         true if the named property was found, false otherwise.
     virtual bool get_member(const ObjectURI& uri, as_value* val);
 
+    /// Get a property by name, using a per-call-site lookup cache
+    //
+    /// This behaves exactly like get_member(uri, val), but skips the
+    /// inheritance chain scan when the cached lookup is still valid.
+    //
+    /// @param uri      Property identifier.
+    /// @param val      Variable to assign an existing value to.
+    /// @param cache    The cache for the calling site.
+    /// @return         true if the named property was found, false otherwise.
+    bool get_member(const ObjectURI& uri, as_value* val, PropertyCache& cache);
+
     /// Get the super object of this object.
     ///
     /// The super should be __proto__ if this is a prototype object
@@ -458,6 +481,13 @@ public:
     ///                 contain the named property.
     Property* getOwnProperty(const ObjectURI& uri);
 
+    /// Return the layout stamp of this object's properties
+    //
+    /// See PropertyList::shape().
+    std::uint32_t shape() const {
+        return _members.shape();
+    }
+
     /// Set member flags (probably used by ASSetPropFlags)
     //
     /// @param name     Name of the property. Must be all lowercase
@@ -682,9 +712,20 @@ private:
     ///
     Property* findUpdatableProperty(const ObjectURI& uri);
 
+    /// Implementation of get_member, with an optional lookup cache.
+    bool getMemberImpl(const ObjectURI& uri, as_value* val,
+            PropertyCache* cache);
+
+    /// Implementation of set_member, with an optional lookup cache.
+    bool setMemberImpl(const ObjectURI& uri, const as_value& val,
+            bool ifFound, PropertyCache* cache);
+
     void executeTriggers(Property* prop, const ObjectURI& uri,
             const as_value& val);
 
+    /// Make a Property just set visible in the current SWF version.
+    void clearVisible(Property& prop);
+
     /// A utility class for processing this as_object's inheritance chain
     template<typename T> class PrototypeRecursor;
 
@@ -732,7 +732,7 @@ void
 as_value::set_string(const std::string& str)
 {
     _type = STRING;
-    _value = str;
+    _value = SharedString(str);
 }
 
 void
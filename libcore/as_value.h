@@ -28,6 +28,7 @@
 
 #include "dsodefs.h" // for DSOTEXPORT
 #include "CharacterProxy.h"
+#include "SharedString.h"
 #include "GnashNumeric.h" // for isNaN
 
 
@@ -145,11 +146,18 @@ public:
     DSOEXPORT as_value(const char* str)
         :
         _type(STRING),
-        _value(std::string(str))
+        _value(SharedString(str))
     {}
 
     /// Construct a primitive String value 
     DSOEXPORT as_value(std::string str)
+        :
+        _type(STRING),
+        _value(SharedString(std::move(str)))
+    {}
+
+    /// Construct a primitive String value sharing an existing buffer.
+    DSOEXPORT as_value(SharedString str)
         :
         _type(STRING),
         _value(std::move(str))
@@ -207,6 +215,11 @@ public:
     bool is_string() const {
         return _type == STRING;
     }
+
+    /// Return the string of a String value, or null for other types.
+    const SharedString* sharedString() const {
+        return _type == STRING ? &boost::get<SharedString>(_value) : nullptr;
+    }
     
     /// Return true if this value is strictly a number
     bool is_number() const {
@@ -423,7 +436,7 @@ private:
                            bool,
                            as_object*,
                            CharacterProxy,
-                           std::string>
+                           SharedString>
     AsValueType;
     
     /// Use the relevant equality function, not operator==
@@ -473,12 +486,12 @@ private:
         return boost::get<bool>(_value);
     }
 
-    /// Get the boolean variant member.
+    /// Get the string variant member.
     //
     /// The caller must check that this value is a String.
     const std::string& getStr() const {
         assert(_type == STRING);
-        return boost::get<std::string>(_value);
+        return boost::get<SharedString>(_value).str();
     }
     
 };
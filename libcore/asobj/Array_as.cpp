@@ -25,6 +25,7 @@
 #include <cmath>
 #include <functional>
 #include <iterator>
+#include <list>
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/lexical_cast.hpp>
 
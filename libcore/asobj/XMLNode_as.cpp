@@ -81,7 +81,7 @@ XMLNode_as::XMLNode_as(Global_as& gl)
     _global(gl),
     _object(nullptr),
     _parent(nullptr),
-    _attributes(new as_object(gl)),
+    _attributes(nullptr),
     _childNodes(nullptr),
     _type(Element)
 {
@@ -92,7 +92,7 @@ XMLNode_as::XMLNode_as(const XMLNode_as& tpl, bool deep)
     _global(tpl._global),
     _object(nullptr),
     _parent(nullptr),
-    _attributes(new as_object(_global)),
+    _attributes(nullptr),
     _childNodes(nullptr),
     _name(tpl._name),
     _value(tpl._value),
@@ -309,13 +309,20 @@ XMLNode_as::toString(std::ostream& xmlout, bool encode) const
     stringify(*this, xmlout, encode);
 }
 
-void
-XMLNode_as::setAttribute(const std::string& name, const std::string& value)
+as_object*
+XMLNode_as::getAttributes() const
 {
-    if (_attributes) {
-        VM& vm = getVM(_global);
-        _attributes->set_member(getURI(vm, name), value);
+    if (_attributes) return _attributes;
+
+    _attributes = new as_object(_global);
+
+    VM& vm = getVM(_global);
+    for (const auto& attr : _parsedAttributes) {
+        _attributes->set_member(getURI(vm, attr.first), attr.second);
     }
+    Attributes().swap(_parsedAttributes);
+
+    return _attributes;
 }
 
 bool
@@ -1033,6 +1040,13 @@ enumerateAttributes(const XMLNode_as& node, StringPairs& pairs)
 {
     pairs.clear();
 
+    // Don't create the attributes object just to read parsed attributes.
+    if (!node.hasAttributesObject()) {
+        const XMLNode_as::Attributes& parsed = node.parsedAttributes();
+        pairs.assign(parsed.rbegin(), parsed.rend());
+        return;
+    }
+
     as_object* obj = node.getAttributes();
     if (obj) {
         string_table& st = getStringTable(*obj);
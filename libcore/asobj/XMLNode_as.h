@@ -21,7 +21,9 @@
 #define GNASH_ASOBJ3_XMLNODE_H
 
 #include <list>
+#include <vector>
 #include <string>
+#include <utility>
 #include <cassert>
 
 #include "Relay.h"
@@ -50,10 +52,15 @@ namespace gnash {
 /// 5. When an XMLNode is destroyed, any children without an associated object
 ///    are also deleted. Children with an associated object will be destroyed
 ///    when the GC destroys the object.
+/// 6. Parsed attributes are kept as strings. The attributes object is only
+///    created when ActionScript asks for it.
 class XMLNode_as : public Relay
 {
 public:
 
+    /// Attribute names and values, in the order they are set.
+    typedef std::vector<std::pair<std::string, std::string> > Attributes;
+
     enum NodeType {
         Element = 1,
         Attribute = 2,
@@ -190,15 +197,29 @@ public:
     virtual void toString(std::ostream& str, bool encode = false) const;
 
     /// Return the attributes object associated with this node.
-    as_object* getAttributes() const { return _attributes; }
+    //
+    /// The object is created, and any parsed attributes set on it, the
+    /// first time it is needed.
+    as_object* getAttributes() const;
 
-    /// Set a named attribute to a value.
+    /// Set the attributes of a newly parsed node.
     //
-    /// @param name     The name of the attribute to set. If already present,
-    ///                 the value is changed. If not present, the attribute is
-    ///                 added.
-    /// @param value    The value to set the named attribute to.
-    void setAttribute(const std::string& name, const std::string& value);
+    /// @param attrs    The attributes, with no duplicate names, in the
+    ///                 order they should be set on the attributes object.
+    void setAttributes(Attributes attrs) {
+        assert(!_attributes);
+        _parsedAttributes = std::move(attrs);
+    }
+
+    /// Whether the attributes object has been created.
+    bool hasAttributesObject() const {
+        return _attributes != nullptr;
+    }
+
+    /// Return the parsed attributes not yet set on an attributes object.
+    const Attributes& parsedAttributes() const {
+        return _parsedAttributes;
+    }
 
     /// Associate an as_object with this XMLNode_as.
     //
@@ -254,7 +275,11 @@ private:
 
     XMLNode_as* _parent;
 
-    as_object* _attributes;
+    /// Created on first use.
+    mutable as_object* _attributes;
+
+    /// Attributes to set when the attributes object is created.
+    mutable Attributes _parsedAttributes;
 
     as_object* _childNodes;
 
@@ -24,7 +24,6 @@
 #include <vector>
 #include <algorithm>
 #include <boost/algorithm/string/compare.hpp>
-#include <boost/algorithm/string/replace.hpp>
 
 #include "log.h"
 #include "as_function.h" 
@@ -59,6 +58,11 @@ namespace {
     typedef XML_as::xml_iterator xml_iterator;
 
     bool textAfterWhitespace(xml_iterator& it, xml_iterator end);
+    bool isWhitespace(char c);
+    bool attributeNameLess(const XMLNode_as::Attributes::value_type& a,
+            const XMLNode_as::Attributes::value_type& b);
+    bool attributeNameEqual(const XMLNode_as::Attributes::value_type& a,
+            const XMLNode_as::Attributes::value_type& b);
     bool textMatch(xml_iterator& it, xml_iterator end,
             const std::string& match, bool advance = true);
     bool parseNodeWithTerminator( xml_iterator& it, xml_iterator end,
@@ -68,8 +72,16 @@ namespace {
             const std::string& val);
 	
 	
-    typedef std::map<std::string, std::string> Entities;
-    const Entities& getEntities();
+    /// An entity unescaped by unescapeXML, without the leading '&'.
+    struct Entity
+    {
+        const char* name;
+        std::string::size_type length;
+        const char* text;
+    };
+
+    const Entity* entityAt(const std::string& text,
+            std::string::size_type pos);
 
     void attachXMLProperties(as_object& o);
 	void attachXMLInterface(as_object& o);
@@ -103,26 +115,70 @@ XML_as::XML_as(as_object& object, const std::string& xml)
 void
 escapeXML(std::string& text)
 {
-    const Entities& ent = getEntities();
-
-    for (const auto& entity : ent)
-    {
-        boost::replace_all(text, entity.second, entity.first);
+    std::string::size_type pos = text.find_first_of("&\"<>'");
+    if (pos == std::string::npos) return;
+
+    std::string escaped(text, 0, pos);
+    escaped.reserve(text.size() + 16);
+
+    for (const std::string::size_type e = text.size(); pos != e; ++pos) {
+        const char c = text[pos];
+        switch (c) {
+            case '&':
+                escaped += "&amp;";
+                break;
+            case '"':
+                escaped += "&quot;";
+                break;
+            case '<':
+                escaped += "&lt;";
+                break;
+            case '>':
+                escaped += "&gt;";
+                break;
+            case '\'':
+                escaped += "&apos;";
+                break;
+            default:
+                escaped += c;
+        }
     }
+    text.swap(escaped);
 }
 
 void
 unescapeXML(std::string& text)
 {
-    const Entities& ent = getEntities();
+    std::string::size_type pos = text.find('&');
+    if (pos == std::string::npos) return;
 
-    for (const auto& entity : ent) {
-        boost::replace_all(text, entity.first, entity.second);
-    }
+    std::string unescaped(text, 0, pos);
+    unescaped.reserve(text.size());
+
+    while (pos != std::string::npos) {
+
+        // Skip the '&'.
+        ++pos;
 
-    // Additionally, the &nbsp; entity is unescaped (but never escaped).
-    // Note we do this as UTF-8, which is most likely wrong for SWF5.
-    boost::replace_all(text, "&nbsp;", "\xc2\xa0");
+        // The entities were once replaced one after the other, starting
+        // with &amp;, so the '&' it leaves is also the start of any other
+        // entity following it.
+        if (!text.compare(pos, 4, "amp;")) {
+            pos += 4;
+        }
+
+        const Entity* entity = entityAt(text, pos);
+        if (entity) {
+            unescaped += entity->text;
+            pos += entity->length;
+        }
+        else unescaped += '&';
+
+        const std::string::size_type next = text.find('&', pos);
+        unescaped.append(text, pos, next - pos);
+        pos = next;
+    }
+    text.swap(unescaped);
 }
 
 void
@@ -142,10 +198,10 @@ void
 XML_as::parseAttribute(XMLNode_as* node, xml_iterator& it,
         const xml_iterator end, Attributes& attributes)
 {
-    const std::string terminators("\r\t\n >=");
+    static const char terminators[] = "\r\t\n >=";
 
     xml_iterator ourend = std::find_first_of(it, end,
-            terminators.begin(), terminators.end());
+            terminators, terminators + sizeof(terminators) - 1);
 
     if (ourend == end) {
         _status = XML_UNTERMINATED_ELEMENT;
@@ -213,9 +269,8 @@ XML_as::parseAttribute(XMLNode_as* node, xml_iterator& it,
         node->setNamespaceURI(value);
     }
 
-    // This ensures values are not inserted twice, which is expected
-    // behaviour
-    attributes.insert(std::make_pair(name, value));
+    // Duplicates are removed when the tag has been parsed.
+    attributes.emplace_back(std::move(name), std::move(value));
 
 }
 
@@ -279,10 +334,10 @@ XML_as::parseTag(XMLNode_as*& node, xml_iterator& it,
     if (closing) ++it;
 
     // These are for terminating the tag name, not (necessarily) the tag.
-    const std::string terminators("\r\n\t >");
+    static const char terminators[] = "\r\n\t >";
 
-    xml_iterator endName = std::find_first_of(it, end, terminators.begin(),
-            terminators.end());
+    xml_iterator endName = std::find_first_of(it, end, terminators,
+            terminators + sizeof(terminators) - 1);
 
     // Check that one of the terminators was found; otherwise it's malformed.
     if (endName == end) {
@@ -345,15 +400,22 @@ XML_as::parseTag(XMLNode_as*& node, xml_iterator& it,
             return;
         }
 
+        // Only the first of any attributes with the same name is kept.
+        // The attributes are set in reverse order of their names.
+        std::stable_sort(attributes.begin(), attributes.end(),
+                attributeNameLess);
+        attributes.erase(std::unique(attributes.begin(), attributes.end(),
+                    attributeNameEqual), attributes.end());
+        std::reverse(attributes.begin(), attributes.end());
+
         // testsuite/swfdec/xml-id-map.as tests that the node is appended
         // first.
         node->appendChild(childNode);
 
-        for (Attributes::const_reverse_iterator i = attributes.rbegin(),
-                e = attributes.rend(); i != e; ++i) {
-            childNode->setAttribute(i->first, i->second);
-            if (i->first == "id") setIdMap(*object(), *childNode, i->second);
+        for (const auto& attr : attributes) {
+            if (attr.first == "id") setIdMap(*object(), *childNode, attr.second);
         }
+        childNode->setAttributes(std::move(attributes));
 
         if (*it == '/') ++it;
         else node = childNode;
@@ -401,14 +463,16 @@ void
 XML_as::parseText(XMLNode_as* node, xml_iterator& it,
         const xml_iterator end, bool iw)
 {
-    xml_iterator ourend = std::find(it, end, '<');
+    const xml_iterator ourend = std::find(it, end, '<');
+
+    if (iw && std::all_of(it, ourend, isWhitespace)) {
+        it = ourend;
+        return;
+    }
+
     std::string content(it, ourend);
-    
     it = ourend;
 
-    if (iw && 
-        content.find_first_not_of("\t\r\n ") == std::string::npos) return;
-
     XMLNode_as* childNode = new XMLNode_as(_global);
 
     childNode->nodeTypeSet(XMLNode_as::Text);
@@ -474,7 +538,11 @@ XML_as::parseXML(const std::string& xml)
     while (it != end && _status == XML_OK) {
         if (*it == '<') {
             ++it;
-            if (textMatch(it, end, "!DOCTYPE", false)) {
+            // Only declarations, comments and CDATA start with '!' or '?'.
+            if (it == end || (*it != '!' && *it != '?')) {
+                parseTag(node, it, end);
+            }
+            else if (textMatch(it, end, "!DOCTYPE", false)) {
                 // We should not advance past the DOCTYPE label, as
                 // the case is preserved.
                 parseDocTypeDecl(it, end);
@@ -869,11 +937,30 @@ textMatch(xml_iterator& it, const xml_iterator end,
 bool
 textAfterWhitespace(xml_iterator& it, const xml_iterator end)
 {
-    const std::string whitespace("\r\t\n ");
-    while (it != end && whitespace.find(*it) != std::string::npos) ++it;
+    while (it != end && isWhitespace(*it)) ++it;
     return (it != end);
 }
 
+bool
+isWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+bool
+attributeNameLess(const XMLNode_as::Attributes::value_type& a,
+        const XMLNode_as::Attributes::value_type& b)
+{
+    return StringNoCaseLessThan()(a.first, b.first);
+}
+
+bool
+attributeNameEqual(const XMLNode_as::Attributes::value_type& a,
+        const XMLNode_as::Attributes::value_type& b)
+{
+    return !attributeNameLess(a, b) && !attributeNameLess(b, a);
+}
+
 /// Parse a complete node up to a specified terminator.
 //
 /// @return     false if we reach the end of the text before finding the
@@ -934,18 +1021,25 @@ setIdMap(as_object& xml, XMLNode_as& childNode, const std::string& val)
     idMap->set_member(getURI(vm, val), childNode.object());
 }
 
-const Entities&
-getEntities()
+/// Return the entity at a position in the text, if any.
+//
+/// The &nbsp; entity is unescaped (but never escaped). Note we do this
+/// as UTF-8, which is most likely wrong for SWF5.
+const Entity*
+entityAt(const std::string& text, std::string::size_type pos)
 {
-    static const Entities entities = {
-        {"&amp;", "&"},
-        {"&quot;", "\""},
-        {"&lt;", "<"},
-        {"&gt;", ">"},
-        {"&apos;", "'"}
+    static const Entity entities[] = {
+        { "quot;", 5, "\"" },
+        { "lt;", 3, "<" },
+        { "gt;", 3, ">" },
+        { "apos;", 5, "'" },
+        { "nbsp;", 5, "\xc2\xa0" }
     };
 
-    return entities;
+    for (const Entity& entity : entities) {
+        if (!text.compare(pos, entity.length, entity.name)) return &entity;
+    }
+    return nullptr;
 }
 
 } // anonymous namespace 
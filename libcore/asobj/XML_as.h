@@ -24,7 +24,6 @@
 #include "dsodefs.h"
 #include "StringPredicates.h"
 
-#include <map>
 #include <string>
 
 
@@ -148,7 +147,7 @@ public:
 
 private:
 
-    typedef std::map<std::string, std::string, StringNoCaseLessThan> Attributes;
+    typedef XMLNode_as::Attributes Attributes;
 
     void parseTag(XMLNode_as*& node, xml_iterator& it, xml_iterator end);
 
@@ -289,7 +289,8 @@ externalinterface_call(const fn_call& fn)
     if (fn.nargs >= 1) {
         const as_value& methodName_as = fn.arg(0);
         const std::string methodName = methodName_as.to_string();
-        const std::vector<as_value>& args = fn.getArgs();
+        const std::vector<as_value> args(fn.getArgs().begin(),
+                fn.getArgs().end());
         log_debug("Calling External method \"%s\"", methodName);
         std::string result = mr.callExternalJavascript(methodName, args);
         if (!result.empty()) {
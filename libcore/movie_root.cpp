@@ -26,6 +26,7 @@
 #include <map>
 #include <bitset>
 #include <cassert>
+#include <chrono>
 #include <functional>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/ptr_container/ptr_deque.hpp>
@@ -51,6 +52,7 @@
 #include "IOChannel.h"
 #include "RunResources.h"
 #include "Renderer.h"
+#include "LazyBitmap.h"
 #include "ExternalInterface.h"
 #include "TextField.h"
 #include "Button.h"
@@ -58,6 +60,7 @@
 #include "StreamProvider.h"
 #include "SystemClock.h"
 #include "as_function.h"
+#include "SharedString.h"
 
 #ifdef USE_SWFTREE
 # include "tree.hh"
@@ -122,6 +125,30 @@ private:
     DisplayObject* _target;
 };
 
+/// Adds the time until the end of the scope to a counter, if there is one.
+class PhaseTimer : boost::noncopyable
+{
+public:
+
+    typedef std::chrono::steady_clock Clock;
+
+    explicit PhaseTimer(std::uint64_t* total)
+        :
+        _total(total),
+        _start(total ? Clock::now() : Clock::time_point())
+    {}
+
+    ~PhaseTimer() {
+        if (!_total) return;
+        *_total += std::chrono::duration_cast<std::chrono::microseconds>(
+                Clock::now() - _start).count();
+    }
+
+private:
+    std::uint64_t* _total;
+    const Clock::time_point _start;
+};
+
 void
 clear(movie_root::ActionQueue& aq)
 {
@@ -166,7 +193,8 @@ movie_root::movie_root(VirtualClock& clock, const RunResources& runResources)
     _movieAdvancementDelay(83), // ~12 fps by default
     _lastMovieAdvancement(0),
     _unnamedInstance(0),
-    _movieLoader(*this)
+    _movieLoader(*this),
+    _advanceTimes(nullptr)
 {
     // This takes care of informing the renderer (if present) too.
     setQuality(QUALITY_HIGH);
@@ -550,6 +578,9 @@ movie_root::reset()
     // Run the garbage collector again
     _gc.fuzzyCollect();
 
+    // Free the names and literals only the old movies used.
+    SharedString::prune();
+
     setInvalidated();
 
     _disableScripts = false;
@@ -859,6 +890,9 @@ movie_root::advance()
 #ifdef USE_SOUND
         sound::sound_handler* s = _runResources.soundHandler();
 
+        // Event sounds keep decoding while they play.
+        if (s) s->trimDecodedSounds();
+
         if (s && _timelineSound) {
 
             if (!s->streamingSound()) {
@@ -938,6 +972,7 @@ movie_root::advance()
 #endif  // USE_SOUND
         
         // Always do this.
+        PhaseTimer t(_advanceTimes ? &_advanceTimes->actions : nullptr);
         executeAdvanceCallbacks();
         executeTimers();
     
@@ -952,6 +987,12 @@ movie_root::advance()
         log_error(_("Buffer overread during advance: %s"), e.what());
         clear(_actionQueue);
     }
+
+    // Spread the cost of freeing old objects over frames.
+    {
+        PhaseTimer t(_advanceTimes ? &_advanceTimes->collect : nullptr);
+        _gc.runIncrement();
+    }
     
     return advanced;
 }
@@ -959,28 +1000,36 @@ movie_root::advance()
 void
 movie_root::advanceMovie()
 {
-    // Do mouse drag, if needed
-    doMouseDrag();
-
-    // Advance all non-unloaded DisplayObjects in the LiveChars list
-    // in reverse order (last added, first advanced)
-    // NOTE: can throw ActionLimitException
-    advanceLiveChars(); 
-
-    // Process loadMovie requests
-    // 
-    // NOTE: should be done before executing timers,
-    //      see swfdec's test/trace/loadmovie-case-{5,6}.swf 
-    // NOTE: processing loadMovie requests after advanceLiveChars
-    //       is known to fix more tests in misc-mtasc.all/levels.swf
-    //       to be checked if it keeps the swfdec testsuite safe
-    //
-    _movieLoader.processCompletedRequests();
+    {
+        PhaseTimer t(_advanceTimes ? &_advanceTimes->displayList : nullptr);
+
+        // Do mouse drag, if needed
+        doMouseDrag();
+
+        // Advance all non-unloaded DisplayObjects in the LiveChars list
+        // in reverse order (last added, first advanced)
+        // NOTE: can throw ActionLimitException
+        advanceLiveChars(); 
+
+        // Process loadMovie requests
+        // 
+        // NOTE: should be done before executing timers,
+        //      see swfdec's test/trace/loadmovie-case-{5,6}.swf 
+        // NOTE: processing loadMovie requests after advanceLiveChars
+        //       is known to fix more tests in misc-mtasc.all/levels.swf
+        //       to be checked if it keeps the swfdec testsuite safe
+        //
+        _movieLoader.processCompletedRequests();
+    }
 
-    // Process queued actions
-    // NOTE: can throw ActionLimitException
-    processActionQueue();
+    {
+        // Process queued actions
+        // NOTE: can throw ActionLimitException
+        PhaseTimer t(_advanceTimes ? &_advanceTimes->actions : nullptr);
+        processActionQueue();
+    }
 
+    PhaseTimer t(_advanceTimes ? &_advanceTimes->collect : nullptr);
     cleanupAndCollect();
 
     //assert(testInvariant());
@@ -1003,6 +1052,9 @@ movie_root::display()
 
     clearInvalidated();
 
+    // Nothing holds on to decoded bitmaps between frames.
+    LazyBitmap::trimCache();
+
     // TODO: should we consider the union of all levels bounds ?
     const SWFRect& frame_size = _rootMovie->get_frame_size();
     if ( frame_size.is_null() )
@@ -75,6 +75,7 @@
 #include <set>
 #include <bitset>
 #include <array>
+#include <cstdint>
 #include <boost/ptr_container/ptr_deque.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/any.hpp>
@@ -386,6 +387,37 @@ public:
 
     void display();
 
+    /// Time spent in the phases of advance(), in microseconds.
+    //
+    /// The times are cumulative; they are only recorded while
+    /// recordAdvanceTimes() has been given somewhere to put them.
+    struct AdvanceTimes
+    {
+        AdvanceTimes()
+            :
+            displayList(0),
+            actions(0),
+            collect(0)
+        {}
+
+        /// Advancing timelines and processing loaded movies.
+        std::uint64_t displayList;
+
+        /// Executing queued actions, timers and advance callbacks.
+        std::uint64_t actions;
+
+        /// Cleaning up the display list and garbage collection.
+        std::uint64_t collect;
+    };
+
+    /// Record how long the phases of advance() take.
+    //
+    /// @param times    The times to add to, or null to stop recording.
+    ///                 This must outlive the movie_root or the next call.
+    void recordAdvanceTimes(AdvanceTimes* times) {
+        _advanceTimes = times;
+    }
+
     /// Get a unique number for unnamed instances.
     size_t nextUnnamedInstance() {
         return ++_unnamedInstance;
@@ -1099,6 +1131,9 @@ private:
 
     MovieLoader _movieLoader;
 
+    /// Where to record the time spent advancing, if anywhere.
+    AdvanceTimes* _advanceTimes;
+
     struct SoundStream {
         SoundStream(int i, int b) : id(i), block(b) {}
         int id;
@@ -48,7 +48,7 @@ BitmapMovieDefinition::BitmapMovieDefinition(
 	_framerate(12),
 	_url(std::move(url)),
 	_bytesTotal(image->size()),
-	_bitmap(renderer ? renderer->createCachedBitmap(std::move(image)) : nullptr)
+	_bitmap(renderer ? renderer->createStaticBitmap(std::move(image)) : nullptr)
 {
 }
 
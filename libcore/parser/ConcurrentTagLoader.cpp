@@ -0,0 +1,177 @@
+// ConcurrentTagLoader.cpp:  Load SWF definition tags on worker threads, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#include "ConcurrentTagLoader.h"
+
+#include <algorithm>
+
+#include "CopiedTag.h"
+#include "SWFStream.h"
+#include "IOChannel.h"
+#include "GnashException.h"
+#include "log.h"
+
+namespace gnash {
+
+namespace {
+
+/// Leave one core to the parsing thread, and don't take over big machines.
+size_t
+workers()
+{
+    const size_t cores = std::thread::hardware_concurrency();
+    return cores > 1 ? std::min<size_t>(cores - 1, 4) : 0;
+}
+
+}
+
+ConcurrentTagLoader::ConcurrentTagLoader(movie_definition& md,
+        const RunResources& r)
+    :
+    _md(md),
+    _runResources(r),
+    _workers(workers()),
+    _pending(0),
+    _stop(false)
+{
+}
+
+ConcurrentTagLoader::~ConcurrentTagLoader()
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] () { return !_pending; });
+        _stop = true;
+    }
+    _queued.notify_all();
+
+    for (std::thread& t : _threads) t.join();
+}
+
+bool
+ConcurrentTagLoader::concurrent(SWF::TagType tag)
+{
+    switch (tag) {
+        case SWF::DEFINESHAPE:
+        case SWF::DEFINESHAPE2:
+        case SWF::DEFINESHAPE3:
+        case SWF::DEFINESHAPE4:
+        case SWF::DEFINESHAPE4_:
+        case SWF::DEFINEMORPHSHAPE:
+        case SWF::DEFINEMORPHSHAPE2:
+        case SWF::DEFINEMORPHSHAPE2_:
+        case SWF::DEFINEFONT:
+        case SWF::DEFINEFONT2:
+        case SWF::DEFINEFONT3:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool
+ConcurrentTagLoader::independent(SWF::TagType tag)
+{
+    // Bitmaps and sounds are kept apart from the characters, and
+    // shapes only look their bitmaps up when they are drawn.
+    switch (tag) {
+        case SWF::JPEGTABLES:
+        case SWF::DEFINEBITS:
+        case SWF::DEFINEBITSJPEG2:
+        case SWF::DEFINEBITSJPEG3:
+        case SWF::DEFINEBITSJPEG4:
+        case SWF::DEFINELOSSLESS:
+        case SWF::DEFINELOSSLESS2:
+        case SWF::DEFINESOUND:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void
+ConcurrentTagLoader::load(SWFStream& in, SWF::TagType tag,
+        SWF::TagLoadersTable::TagLoader lf)
+{
+    if (!_workers) {
+        lf(in, tag, _md, _runResources);
+        return;
+    }
+
+    if (_threads.empty()) {
+        for (size_t i = 0; i < _workers; ++i) {
+            _threads.push_back(std::thread(&ConcurrentTagLoader::work, this));
+        }
+    }
+
+    Job job;
+    job.tag.reset(new SWF::CopiedTag(in, tag));
+    job.loader = lf;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(std::move(job));
+        ++_pending;
+    }
+    _queued.notify_one();
+}
+
+void
+ConcurrentTagLoader::wait()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this] () { return !_pending; });
+}
+
+void
+ConcurrentTagLoader::work()
+{
+    for (;;) {
+
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _queued.wait(lock, [this] () { return _stop || !_jobs.empty(); });
+            if (_jobs.empty()) return;
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        const std::unique_ptr<IOChannel> buf = job.tag->read();
+        SWFStream in(buf.get());
+
+        try {
+            in.open_tag();
+            job.loader(in, job.tag->type(), _md, _runResources);
+            in.close_tag();
+        }
+        catch (const ParserException& e) {
+            log_error(_("Parsing exception: %s"), e.what());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_pending) continue;
+        }
+        _done.notify_all();
+    }
+}
+
+} // namespace gnash
@@ -0,0 +1,123 @@
+// ConcurrentTagLoader.h:  Load SWF definition tags on worker threads, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_CONCURRENTTAGLOADER_H
+#define GNASH_CONCURRENTTAGLOADER_H
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <boost/noncopyable.hpp>
+
+#include "SWF.h"
+#include "TagLoadersTable.h"
+
+// Forward declarations
+namespace gnash {
+    class SWFStream;
+    class movie_definition;
+    class RunResources;
+    namespace SWF {
+        class CopiedTag;
+    }
+}
+
+namespace gnash {
+
+/// Loads the definition tags of a movie on a pool of worker threads.
+//
+/// Shapes, morph shapes and fonts are the tags that take longest to
+/// parse, and they depend on nothing else in the movie while they are
+/// parsed. The parsing thread copies them out of the stream and goes on
+/// reading while workers parse and add them to the definition.
+//
+/// Any other tag may need the definitions before it, or change the frame
+/// being loaded, so the parsing thread must call wait() before loading
+/// it unless it is independent(). This keeps every frame complete when
+/// it is reported loaded.
+class ConcurrentTagLoader : boost::noncopyable
+{
+public:
+
+    ConcurrentTagLoader(movie_definition& md, const RunResources& r);
+
+    /// Wait for all queued tags and stop the workers.
+    ~ConcurrentTagLoader();
+
+    /// Whether a tag can be loaded by a worker.
+    static bool concurrent(SWF::TagType tag);
+
+    /// Whether a tag can be loaded while workers are loading others.
+    //
+    /// These tags neither look up definitions nor add to the frame.
+    static bool independent(SWF::TagType tag);
+
+    /// Load the tag open in a SWFStream.
+    //
+    /// The rest of the tag is copied for a worker to load, or it is
+    /// loaded immediately if there are no workers.
+    void load(SWFStream& in, SWF::TagType tag,
+            SWF::TagLoadersTable::TagLoader lf);
+
+    /// Wait until all queued tags have been loaded.
+    void wait();
+
+private:
+
+    struct Job
+    {
+        std::unique_ptr<SWF::CopiedTag> tag;
+        SWF::TagLoadersTable::TagLoader loader;
+    };
+
+    /// Load queued tags until stopped.
+    void work();
+
+    movie_definition& _md;
+
+    const RunResources& _runResources;
+
+    /// The number of workers to start.
+    const size_t _workers;
+
+    /// Started on the first load().
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+
+    /// Signalled when a job is queued or the workers must stop.
+    std::condition_variable _queued;
+
+    /// Signalled when the last pending job is done.
+    std::condition_variable _done;
+
+    std::deque<Job> _jobs;
+
+    /// The number of jobs queued or being loaded.
+    size_t _pending;
+
+    bool _stop;
+};
+
+} // namespace gnash
+
+#endif
@@ -0,0 +1,272 @@
+// DecodedActions.cpp:  pre-decoded form of an action_buffer, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#include "DecodedActions.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "action_buffer.h"
+#include "ASHandlers.h"
+#include "VM.h"
+#include "log.h"
+
+namespace gnash {
+
+namespace {
+
+struct ActionPCLess
+{
+    bool operator()(const DecodedAction& a, size_t pc) const {
+        return a.pc < pc;
+    }
+};
+
+}
+
+DecodedActions::DecodedActions(const action_buffer& buf)
+{
+    const SWF::SWFHandlers& ash = SWF::SWFHandlers::instance();
+    const size_t end = buf.size();
+
+    size_t pc = 0;
+    while (pc < end) {
+
+        const std::uint8_t id = buf[pc];
+        size_t next = pc + 1;
+
+        if (id & 0x80) {
+            if (pc + 2 >= end) break;
+            next = pc + 3 + buf.read_uint16(pc + 1);
+            if (next > end) break;
+        }
+
+        const SWF::ActionType type = static_cast<SWF::ActionType>(id);
+        _actions.push_back(DecodedAction(pc, next, type, ash[type]));
+        DecodedAction& act = _actions.back();
+
+        switch (type) {
+            case SWF::ACTION_PUSHDATA:
+                decodePush(buf, act);
+                break;
+            case SWF::ACTION_BRANCHALWAYS:
+            case SWF::ACTION_BRANCHIFTRUE:
+                if (next - pc >= 5) act.branchOffset = buf.read_int16(pc + 3);
+                break;
+            case SWF::ACTION_GETMEMBER:
+            case SWF::ACTION_SETMEMBER:
+            case SWF::ACTION_GETVARIABLE:
+                act.cache.reset(new PropertyCache);
+                break;
+            default:
+                break;
+        }
+
+        if (type == SWF::ACTION_END) break;
+        pc = next;
+    }
+
+    // Resolve branch targets to indices now that all offsets are known.
+    for (DecodedAction& act : _actions) {
+        if (act.type != SWF::ACTION_BRANCHALWAYS &&
+                act.type != SWF::ACTION_BRANCHIFTRUE) continue;
+
+        const long target = static_cast<long>(act.nextPC) + act.branchOffset;
+        if (target < 0) continue;
+
+        std::vector<DecodedAction>::const_iterator it =
+            std::lower_bound(_actions.begin(), _actions.end(),
+                    static_cast<size_t>(target), ActionPCLess());
+
+        if (it != _actions.end() &&
+                it->pc == static_cast<size_t>(target)) {
+            act.branchIndex = it - _actions.begin();
+        }
+    }
+
+    // Index the string literals now that the items won't move.
+    for (const DecodedAction& act : _actions) {
+        for (const DecodedAction::PushItem& item : act.push) {
+            if (item.kind != DecodedAction::PushItem::LITERAL) continue;
+            const SharedString* s = item.value.sharedString();
+            if (s && s->interned()) _literals.emplace(&s->str(), &item);
+        }
+    }
+}
+
+const ObjectURI*
+DecodedActions::uri(const VM& vm, const SharedString& s) const
+{
+    const auto it = _literals.find(&s.str());
+    if (it == _literals.end()) return nullptr;
+
+    const DecodedAction::PushItem& item = *it->second;
+    if (item.uri.empty()) item.uri = getURI(vm, s.str());
+    return &item.uri;
+}
+
+const DecodedAction*
+DecodedActions::find(size_t pc, const DecodedAction* prev) const
+{
+    if (_actions.empty()) return nullptr;
+
+    if (prev) {
+        // Straight-line execution.
+        const DecodedAction* seq = prev + 1;
+        if (prev->nextPC == pc && seq != &_actions.back() + 1 &&
+                seq->pc == pc) {
+            return seq;
+        }
+        // A taken branch.
+        if (prev->branchIndex != DecodedAction::noBranch) {
+            const DecodedAction& tgt = _actions[prev->branchIndex];
+            if (tgt.pc == pc) return &tgt;
+        }
+    }
+
+    std::vector<DecodedAction>::const_iterator it =
+        std::lower_bound(_actions.begin(), _actions.end(), pc,
+                ActionPCLess());
+
+    if (it == _actions.end() || it->pc != pc) return nullptr;
+    return &*it;
+}
+
+void
+DecodedActions::decodePush(const action_buffer& buf, DecodedAction& act)
+{
+    typedef DecodedAction::PushItem PushItem;
+
+    // Same layout as in ActionPushData.
+    const size_t end = act.nextPC;
+    size_t i = act.pc + 3;
+
+    while (i < end) {
+
+        const std::uint8_t type = buf[i];
+        ++i;
+
+        switch (type) {
+            default:
+                act.push.clear();
+                return;
+
+            case 0: // string
+            {
+                const char* str = buf.read_string(i);
+                const size_t len = strnlen(str, end - i);
+                if (i + len >= end) {
+                    act.push.clear();
+                    return;
+                }
+                // Literals are interned so that comparing them with
+                // each other never needs to look at the characters.
+                act.push.push_back(PushItem(PushItem::LITERAL, 0,
+                            SharedString::intern(std::string(str, len))));
+                i += len + 1;
+                break;
+            }
+
+            case 1: // float
+                if (i + 4 > end) {
+                    act.push.clear();
+                    return;
+                }
+                act.push.push_back(PushItem(PushItem::LITERAL, 0,
+                            buf.read_float_little(i)));
+                i += 4;
+                break;
+
+            case 2: // null
+            {
+                as_value nullvalue;
+                nullvalue.set_null();
+                act.push.push_back(PushItem(PushItem::LITERAL, 0, nullvalue));
+                break;
+            }
+
+            case 3: // undefined
+                act.push.push_back(PushItem(PushItem::LITERAL, 0));
+                break;
+
+            case 4: // register
+                if (i >= end) {
+                    act.push.clear();
+                    return;
+                }
+                act.push.push_back(PushItem(PushItem::REGISTER, buf[i]));
+                ++i;
+                break;
+
+            case 5: // bool
+                if (i >= end) {
+                    act.push.clear();
+                    return;
+                }
+                act.push.push_back(PushItem(PushItem::LITERAL, 0,
+                            static_cast<bool>(buf[i])));
+                ++i;
+                break;
+
+            case 6: // double
+                if (i + 8 > end) {
+                    act.push.clear();
+                    return;
+                }
+                act.push.push_back(PushItem(PushItem::LITERAL, 0,
+                            buf.read_double_wacky(i)));
+                i += 8;
+                break;
+
+            case 7: // int32
+                if (i + 4 > end) {
+                    act.push.clear();
+                    return;
+                }
+                act.push.push_back(PushItem(PushItem::LITERAL, 0,
+                            static_cast<double>(buf.read_int32(i))));
+                i += 4;
+                break;
+
+            case 8: // dict8
+                if (i >= end) {
+                    act.push.clear();
+                    return;
+                }
+                act.push.push_back(PushItem(PushItem::CONSTANT, buf[i]));
+                ++i;
+                break;
+
+            case 9: // dict16
+                if (i + 2 > end) {
+                    act.push.clear();
+                    return;
+                }
+                act.push.push_back(PushItem(PushItem::CONSTANT,
+                            buf.read_uint16(i)));
+                i += 2;
+                break;
+        }
+    }
+
+    act.pushDecoded = true;
+}
+
+} // namespace gnash
@@ -0,0 +1,169 @@
+// DecodedActions.h:  pre-decoded form of an action_buffer, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_DECODEDACTIONS_H
+#define GNASH_DECODEDACTIONS_H
+
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <boost/noncopyable.hpp>
+
+#include "as_value.h"
+#include "PropertyCache.h"
+#include "SWF.h"
+
+// Forward declarations
+namespace gnash {
+    class action_buffer;
+    class VM;
+    namespace SWF {
+        class ActionHandler;
+    }
+}
+
+namespace gnash {
+
+/// A single action record with its operands already parsed.
+//
+/// The byte offsets are kept so that code relying on byte-based
+/// program counters (try blocks, with blocks, function bodies,
+/// WaitForFrame skips) keeps working unchanged.
+struct DecodedAction
+{
+    /// An ActionPush operand.
+    struct PushItem
+    {
+        enum Kind {
+            LITERAL,
+            REGISTER,
+            CONSTANT
+        };
+
+        PushItem(Kind k, std::uint16_t i, as_value v = as_value())
+            :
+            kind(k),
+            index(i),
+            value(std::move(v))
+        {}
+
+        Kind kind;
+
+        /// Register number or constant pool index.
+        std::uint16_t index;
+
+        /// The value to push for LITERAL items.
+        as_value value;
+
+        /// The ObjectURI of a string LITERAL, once it is used as a name.
+        mutable ObjectURI uri;
+    };
+
+    /// Value of branchIndex when there is no (valid) branch target.
+    static const size_t noBranch = static_cast<size_t>(-1);
+
+    DecodedAction(size_t p, size_t n, SWF::ActionType t,
+            const SWF::ActionHandler& h)
+        :
+        pc(p),
+        nextPC(n),
+        type(t),
+        handler(&h),
+        branchOffset(0),
+        branchIndex(noBranch),
+        pushDecoded(false)
+    {}
+
+    /// Offset of this action in the buffer.
+    size_t pc;
+
+    /// Offset of the following action in the buffer.
+    size_t nextPC;
+
+    SWF::ActionType type;
+
+    /// The handler for this action, resolved at decode time.
+    const SWF::ActionHandler* handler;
+
+    /// Branch offset for ActionJump and ActionIf, relative to nextPC.
+    std::int16_t branchOffset;
+
+    /// Index of the branch target in the decoded stream, or noBranch.
+    size_t branchIndex;
+
+    /// Whether the ActionPush operands could be decoded.
+    //
+    /// Malformed push records are left to the byte interpreter, which
+    /// knows how to complain about them.
+    bool pushDecoded;
+
+    std::vector<PushItem> push;
+
+    /// Property lookup cache for GetMember, SetMember and GetVariable.
+    mutable std::unique_ptr<PropertyCache> cache;
+};
+
+/// The pre-decoded instruction stream of an action_buffer.
+//
+/// This is built once on first execution and cached by the action_buffer.
+/// Decoding stops at the first malformed record; offsets that are not in
+/// the decoded stream (including jumps into the middle of an instruction)
+/// are interpreted from the raw buffer as before.
+class DecodedActions : boost::noncopyable
+{
+public:
+
+    explicit DecodedActions(const action_buffer& buf);
+
+    /// Find the decoded action at the given offset.
+    //
+    /// @param pc       The byte offset of the action.
+    /// @param prev     The previously executed action, or null. This is
+    ///                 used to find sequential and branch targets without
+    ///                 searching.
+    /// @return         The decoded action, or null if none starts at pc.
+    const DecodedAction* find(size_t pc, const DecodedAction* prev) const;
+
+    size_t size() const { return _actions.size(); }
+
+    /// Return the ObjectURI of a string pushed as a literal.
+    //
+    /// A literal is only looked up in the string_table the first time it
+    /// is used as a name.
+    //
+    /// @param s    An interned string, matched by identity.
+    /// @return     The ObjectURI, or null if s is not a literal of this
+    ///             buffer.
+    const ObjectURI* uri(const VM& vm, const SharedString& s) const;
+
+private:
+
+    void decodePush(const action_buffer& buf, DecodedAction& act);
+
+    std::vector<DecodedAction> _actions;
+
+    /// The string literals, by the address of their interned string.
+    std::unordered_map<const std::string*, const DecodedAction::PushItem*>
+        _literals;
+};
+
+} // namespace gnash
+
+#endif
@@ -48,12 +48,14 @@
 #include "sound_definition.h" // for sound_sample
 #include "GnashAlgorithm.h"
 #include "SWFParser.h"
+#include "ConcurrentTagLoader.h"
 #include "Global_as.h"
 #include "namedStrings.h"
 #include "as_function.h"
 #include "CachedBitmap.h"
 #include "TypesParser.h"
 #include "GnashImageJpeg.h"
+#include "TimelineSnapshots.h"
 
 // Debug frames load
 #undef DEBUG_FRAMES_LOAD
@@ -176,13 +178,14 @@ void
 SWFMovieDefinition::add_font(int font_id, boost::intrusive_ptr<Font> f)
 {
     //assert(f);
+    std::lock_guard<std::mutex> lock(_fontsMutex);
     m_fonts.insert(std::make_pair(font_id, f));
 }
 
 Font*
 SWFMovieDefinition::get_font(int font_id) const
 {
-
+    std::lock_guard<std::mutex> lock(_fontsMutex);
     FontMap::const_iterator it = m_fonts.find(font_id);
     if ( it == m_fonts.end() ) return nullptr;
     boost::intrusive_ptr<Font> f = it->second;
@@ -194,7 +197,7 @@ Font*
 SWFMovieDefinition::get_font(const std::string& name, bool bold, bool italic)
     const
 {
-
+    std::lock_guard<std::mutex> lock(_fontsMutex);
     for (const auto& elem : m_fonts)
     {
        Font* f = elem.second.get();
@@ -218,6 +221,13 @@ SWFMovieDefinition::addBitmap(int id, boost::intrusive_ptr<CachedBitmap> im)
     _bitmaps.insert(std::make_pair(id, im));
 }
 
+TimelineSnapshots*
+SWFMovieDefinition::snapshots() const
+{
+    if (!_snapshots) _snapshots.reset(new TimelineSnapshots(*this));
+    return _snapshots.get();
+}
+
 sound_sample*
 SWFMovieDefinition::get_sound_sample(int id) const
 {
@@ -444,7 +454,9 @@ SWFMovieDefinition::read_all_swf()
     //assert( ! _loader.isSelfThread() );
 #endif
 
-    SWFParser parser(*_str, this, _runResources);
+    // Shapes and fonts are parsed by workers while the stream is read.
+    ConcurrentTagLoader loader(*this, _runResources);
+    SWFParser parser(*_str, this, _runResources, &loader);
 
     const size_t startPos = _str->tell();
     assert (startPos <= _swf_end_pos);
@@ -480,6 +492,8 @@ SWFMovieDefinition::read_all_swf()
         log_error(_("Error while parsing SWF stream."));
     }
 
+    loader.wait();
+
     // Set bytesLoaded to the current stream position unless it's greater
     // than the reported length. TODO: should we be trying to continue
     // parsing after an exception?
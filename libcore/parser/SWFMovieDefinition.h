@@ -300,6 +300,8 @@ public:
         else return &(it->second);
     }
 
+    virtual TimelineSnapshots* snapshots() const;
+
     /// Read the header of the SWF file
     //
     /// This function only reads the header of the SWF
@@ -401,6 +403,10 @@ private:
     typedef std::map<int, boost::intrusive_ptr<Font> > FontMap;
     FontMap m_fonts;
 
+    /// Mutex protecting m_fonts, which fonts are added to by the
+    /// ConcurrentTagLoader
+    mutable std::mutex _fontsMutex;
+
     typedef std::map<int, boost::intrusive_ptr<CachedBitmap> > Bitmaps;
     Bitmaps _bitmaps;
 
@@ -412,6 +418,9 @@ private:
     /// Movie control events for each frame.
     PlayListMap m_playlist;
 
+    /// Created on the first jump back.
+    mutable std::unique_ptr<TimelineSnapshots> _snapshots;
+
     /// 0-based frame #'s
     typedef std::map<std::string, size_t, StringNoCaseLessThan> NamedFrameMap;
     NamedFrameMap _namedFrames;
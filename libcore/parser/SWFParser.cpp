@@ -21,6 +21,7 @@
 #include "RunResources.h"
 #include "SWFParser.h"
 #include "TagLoadersTable.h"
+#include "ConcurrentTagLoader.h"
 #include "log.h"
 
 #include <iomanip>
@@ -76,6 +77,12 @@ SWFParser::read(std::streamsize bytes)
                 return true;
             }
 
+            // Everything this tag may depend on must be loaded first.
+            if (_loader && !ConcurrentTagLoader::concurrent(_tag) &&
+                    !ConcurrentTagLoader::independent(_tag)) {
+                _loader->wait();
+            }
+
             // Signal that we have reached the end of a SWF or sprite when
             // a SWF::END tag is encountered.
             if (_tag == SWF::END) {
@@ -93,7 +100,10 @@ SWFParser::read(std::streamsize bytes)
             else if (tagLoaders.get(_tag, lf)) {
                 // call the tag loader.  The tag loader should add
                 // DisplayObjects or tags to the movie data structure.
-                lf(_stream, _tag, *_md, _runResources);
+                if (_loader && ConcurrentTagLoader::concurrent(_tag)) {
+                    _loader->load(_stream, _tag, lf);
+                }
+                else lf(_stream, _tag, *_md, _runResources);
             }
             else {
                 // no tag loader for this tag type.
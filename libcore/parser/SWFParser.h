@@ -29,6 +29,7 @@ namespace gnash {
     class SWFStream;
     class movie_definition;
     class RunResources;
+    class ConcurrentTagLoader;
 }
 
 namespace gnash {
@@ -47,15 +48,22 @@ namespace gnash {
 /// The SWFParser will only deal with ParserExceptions in an open tag.
 /// Exceptions thrown when opening and closing tags signal a fatal error,
 /// and will be left to the callers to deal with.
+//
+/// If a ConcurrentTagLoader is passed, the tags it can load are handed
+/// to it, and the SWFParser waits for them before any tag that may
+/// depend on them, including the end of each frame.
 class SWFParser
 {
 
 public:
-    SWFParser(SWFStream& in, movie_definition* md, const RunResources& runResources)
+    SWFParser(SWFStream& in, movie_definition* md,
+            const RunResources& runResources,
+            ConcurrentTagLoader* loader = nullptr)
         :
         _stream(in),
         _md(md),
         _runResources(runResources),
+        _loader(loader),
         _bytesRead(0),
         _tagOpen(false),
         _endRead(0),
@@ -96,6 +104,8 @@ private:
     movie_definition* _md;
     
     const RunResources& _runResources;
+
+    ConcurrentTagLoader* _loader;
     
     size_t _bytesRead;
     
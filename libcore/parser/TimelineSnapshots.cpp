@@ -0,0 +1,99 @@
+// TimelineSnapshots.cpp:  DisplayList state of a timeline, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#include "TimelineSnapshots.h"
+
+#include <algorithm>
+
+#include "movie_definition.h"
+#include "ControlTag.h"
+#include "DisplayListTag.h"
+
+namespace gnash {
+
+TimelineSnapshots::TimelineSnapshots(const movie_definition& def)
+    :
+    _def(def),
+    _frames(0),
+    _tags(0)
+{
+}
+
+const TimelineSnapshots::Snapshot*
+TimelineSnapshots::find(size_t frame)
+{
+    const size_t count = frame / interval;
+    if (!count) return nullptr;
+
+    while (_snapshots.size() < count) {
+
+        do {
+            addFrame();
+        } while (_frames % interval);
+
+        std::vector<Entry> entries(_other);
+        for (const auto& depth : _depths) {
+            entries.insert(entries.end(), depth.second.begin(),
+                    depth.second.end());
+        }
+        std::sort(entries.begin(), entries.end());
+
+        _snapshots.push_back(Snapshot());
+        Snapshot& s = _snapshots.back();
+        s.frame = _frames;
+        s.tags.reserve(entries.size());
+        for (const Entry& e : entries) s.tags.push_back(e.second);
+    }
+
+    return &_snapshots[count - 1];
+}
+
+void
+TimelineSnapshots::addFrame()
+{
+    const movie_definition::PlayList* playlist = _def.getPlaylist(_frames);
+    ++_frames;
+
+    if (!playlist) return;
+
+    for (const auto& item : *playlist) {
+
+        // Action tags are never needed to restore a frame.
+        if (!item->hasState()) continue;
+
+        const Entry e(_tags++, item.get());
+
+        const SWF::DisplayListTag* dl =
+            dynamic_cast<const SWF::DisplayListTag*>(item.get());
+
+        // Other tags can't be dropped, but they are few.
+        if (!dl) {
+            _other.push_back(e);
+            continue;
+        }
+
+        // DisplayList tags only act on the object at their own depth,
+        // so the ones before it was last removed no longer matter.
+        if (dl->removes()) _depths.erase(dl->getDepth());
+        else _depths[dl->getDepth()].push_back(e);
+    }
+}
+
+} // namespace gnash
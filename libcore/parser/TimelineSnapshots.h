@@ -0,0 +1,107 @@
+// TimelineSnapshots.h:  DisplayList state of a timeline, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_TIMELINESNAPSHOTS_H
+#define GNASH_TIMELINESNAPSHOTS_H
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <boost/noncopyable.hpp>
+
+// Forward declarations
+namespace gnash {
+    class movie_definition;
+    namespace SWF {
+        class ControlTag;
+    }
+}
+
+namespace gnash {
+
+/// Snapshots of the state a timeline builds up, for jumping back.
+//
+/// Restoring the DisplayList of a frame means executing the state tags of
+/// every frame before it. Most of those tags have no lasting effect: an
+/// object placed and moved at a depth is forgotten when the depth is
+/// cleared. A snapshot holds only the tags that still matter at a frame,
+/// so that a jump back executes those and then the tags of the few frames
+/// after the snapshot.
+//
+/// Snapshots are taken every 'interval' frames, on demand, and only
+/// depend on the definition, so they are shared by all its instances.
+/// They must only be used by the thread executing the movie.
+class TimelineSnapshots : boost::noncopyable
+{
+public:
+
+    typedef std::vector<const SWF::ControlTag*> Tags;
+
+    /// The state before a frame.
+    struct Snapshot
+    {
+        /// The frame the snapshot was taken before, 0-based.
+        size_t frame;
+
+        /// The state tags of earlier frames that still have an effect,
+        /// in their original order.
+        Tags tags;
+    };
+
+    /// The number of frames between snapshots.
+    static const size_t interval = 32;
+
+    explicit TimelineSnapshots(const movie_definition& def);
+
+    /// Find the latest snapshot taken before or at a frame.
+    //
+    /// @param frame    A 0-based frame. All frames before it must have
+    ///                 been loaded.
+    /// @return         The snapshot, or null if the frame is before the
+    ///                 first snapshot.
+    const Snapshot* find(size_t frame);
+
+private:
+
+    /// A tag and its position on the timeline.
+    typedef std::pair<size_t, const SWF::ControlTag*> Entry;
+
+    /// Add the tags of the next frame to the current state.
+    void addFrame();
+
+    const movie_definition& _def;
+
+    std::vector<Snapshot> _snapshots;
+
+    /// The number of frames in the current state.
+    size_t _frames;
+
+    /// The number of tags seen so far.
+    size_t _tags;
+
+    /// The DisplayList tags that have an effect at each depth.
+    std::map<int, std::vector<Entry> > _depths;
+
+    /// All other tags with state, such as definitions.
+    std::vector<Entry> _other;
+};
+
+} // namespace gnash
+
+#endif
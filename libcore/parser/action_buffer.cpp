@@ -28,6 +28,7 @@
 #include "SWF.h"
 #include "ASHandlers.h"
 #include "movie_definition.h"
+#include "DecodedActions.h"
 
 namespace gnash {
 
@@ -44,6 +45,17 @@ action_buffer::action_buffer(const movie_definition& md)
 {
 }
 
+action_buffer::~action_buffer()
+{
+}
+
+const DecodedActions&
+action_buffer::decoded() const
+{
+    if (!_decoded) _decoded.reset(new DecodedActions(*this));
+    return *_decoded;
+}
+
 void
 action_buffer::read(SWFStream& in, unsigned long endPos)
 {
@@ -117,12 +129,10 @@ action_buffer::readConstantPool(size_t start_pc, size_t stop_pc) const
     
     //assert(start_pc + 3 + length == stop_pc);
     
-    pool.resize(count);
-    
     // Index the strings.
     for (int ct = 0; ct < count; ct++) {
         // Point into the current action buffer.
-        pool[ct] = reinterpret_cast<const char*>(&m_buffer[3 + i]);
+        const char* str = reinterpret_cast<const char*>(&m_buffer[3 + i]);
 
         // TODO: rework this "safety" thing here (doesn't look all that safe)
         while (m_buffer[3 + i]) {
@@ -131,13 +141,14 @@ action_buffer::readConstantPool(size_t start_pc, size_t stop_pc) const
                 log_error(_("action buffer dict length exceeded"));
                 // Jam something into the remaining (invalid) entries.
                 while (ct < count) {
-                    pool[ct] = "<invalid>";
+                    pool.push_back("<invalid>");
                     ct++;
                 }
                 return pool;
             }
             i++;
         }
+        pool.push_back(str);
         i++;
     }
 
@@ -22,6 +22,7 @@
 #include <string>
 #include <vector> 
 #include <map> 
+#include <memory>
 #include <boost/noncopyable.hpp>
 #include <cstdint>
 
@@ -34,6 +35,7 @@ namespace gnash {
 	class as_value;
 	class movie_definition;
 	class SWFStream; // for read signature
+	class DecodedActions;
 }
 
 namespace gnash {
@@ -52,6 +54,8 @@ public:
 
 	action_buffer(const movie_definition& md);
 
+	~action_buffer();
+
 	/// Read action bytes from input stream up to but not including endPos
 	//
 	/// @param endPos
@@ -186,6 +190,14 @@ public:
         return _src;
     }
 
+	/// Return the pre-decoded form of this buffer
+	//
+	/// The buffer is decoded on first request and cached, so that
+	/// code executed repeatedly (frame scripts, event handlers)
+	/// does not re-parse opcodes and operands on every run.
+	///
+	const DecodedActions& decoded() const;
+
 private:
 
 	/// the code itself, as read from the SWF
@@ -201,6 +213,9 @@ private:
 	/// permissions to grant to the action code.
 	/// 
 	const movie_definition& _src;
+
+	/// Lazily built instruction stream, see decoded()
+	mutable std::unique_ptr<DecodedActions> _decoded;
 };
 
 
@@ -66,6 +66,7 @@ namespace gnash {
 	class CachedBitmap;
 	class Movie;
 	class MovieClip;
+	class TimelineSnapshots;
 	namespace SWF {
         class ControlTag;
     }
@@ -161,6 +162,14 @@ public:
 		return nullptr;
 	}
 
+	/// Return snapshots of the timeline's state, for jumping back
+	//
+	/// @return NULL if there is no timeline (the default implementation).
+	virtual TimelineSnapshots* snapshots() const
+	{
+		return nullptr;
+	}
+
 
 	typedef std::pair<int, std::string> ImportSpec;
 	typedef std::vector< ImportSpec > Imports;
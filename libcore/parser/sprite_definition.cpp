@@ -27,6 +27,7 @@
 #include "SWFParser.h"
 #include "namedStrings.h"
 #include "Global_as.h"
+#include "TimelineSnapshots.h"
 
 #include <vector>
 #include <string>
@@ -50,6 +51,13 @@ sprite_definition::~sprite_definition()
 {
 }
 
+TimelineSnapshots*
+sprite_definition::snapshots() const
+{
+    if (!_snapshots) _snapshots.reset(new TimelineSnapshots(*this));
+    return _snapshots.get();
+}
+
 /*private*/
 // only called from constructors
 void
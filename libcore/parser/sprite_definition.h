@@ -25,6 +25,7 @@
 #include <cstdint>
 #include <string>
 #include <map>
+#include <memory>
 #include "movie_definition.h" // for inheritance
 #include "log.h"
 #include "SWFRect.h"
@@ -226,6 +227,9 @@ private:
 	/// movie control events for each frame.
 	PlayListMap m_playlist;
 
+	/// Created on the first jump back.
+	mutable std::unique_ptr<TimelineSnapshots> _snapshots;
+
 	// stores 0-based frame #'s
 	typedef std::map<std::string, size_t, StringNoCaseLessThan> NamedFrameMap;
 	NamedFrameMap _namedFrames;
@@ -254,6 +258,8 @@ private:
 		else return &(it->second);
 	}
 
+	TimelineSnapshots* snapshots() const;
+
 	virtual const std::string& get_url() const
 	{
 		return m_movie_def.get_url();
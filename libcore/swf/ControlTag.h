@@ -72,6 +72,13 @@ public:
 	{
 	}
 
+    /// Whether executeState() does anything.
+    //
+    /// Tags that override executeState() must return true.
+    virtual bool hasState() const {
+        return false;
+    }
+
 };
 
 } // namespace SWF
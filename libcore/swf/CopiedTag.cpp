@@ -0,0 +1,114 @@
+// CopiedTag.cpp:  SWF tags copied out of a stream, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+//
+
+#include "CopiedTag.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "IOChannel.h"
+#include "SWFStream.h"
+
+namespace gnash {
+namespace SWF {
+
+namespace {
+
+/// Provide an IOChannel interface around the data of a CopiedTag.
+class BufferAdapter : public IOChannel
+{
+public:
+
+    explicit BufferAdapter(const std::vector<std::uint8_t>& data)
+        :
+        _data(data),
+        _pos(0)
+    {}
+
+    virtual std::streamsize read(void* dst, std::streamsize bytes) {
+        const size_t n = std::min<size_t>(bytes, _data.size() - _pos);
+        std::memcpy(dst, _data.data() + _pos, n);
+        _pos += n;
+        return n;
+    }
+
+    virtual void go_to_end() {
+        _pos = _data.size();
+    }
+
+    virtual bool eof() const {
+        return _pos == _data.size();
+    }
+
+    virtual bool seek(std::streampos pos) {
+        if (pos < 0 || static_cast<size_t>(pos) > _data.size()) return false;
+        _pos = pos;
+        return true;
+    }
+
+    virtual size_t size() const {
+        return _data.size();
+    }
+
+    virtual std::streampos tell() const {
+        return _pos;
+    }
+
+    virtual bool bad() const {
+        return false;
+    }
+
+private:
+    const std::vector<std::uint8_t>& _data;
+    size_t _pos;
+};
+
+} // anonymous namespace
+
+CopiedTag::CopiedTag(SWFStream& in, TagType tag)
+    :
+    _type(tag)
+{
+    const size_t headerSize = 6;
+    const size_t length = in.get_tag_end_position() - in.tell();
+
+    _data.resize(headerSize + length);
+
+    const size_t got = in.read(reinterpret_cast<char*>(&_data[headerSize]),
+            length);
+    _data.resize(headerSize + got);
+
+    // Always use the long header format.
+    const std::uint16_t header = (tag << 6) | 0x3f;
+    _data[0] = header & 0xff;
+    _data[1] = header >> 8;
+    for (size_t i = 0; i < 4; ++i) {
+        _data[2 + i] = (got >> (i * 8)) & 0xff;
+    }
+}
+
+std::unique_ptr<IOChannel>
+CopiedTag::read() const
+{
+    return std::unique_ptr<IOChannel>(new BufferAdapter(_data));
+}
+
+} // namespace SWF
+} // namespace gnash
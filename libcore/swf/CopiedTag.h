@@ -0,0 +1,71 @@
+// CopiedTag.h:  SWF tags copied out of a stream, for Gnash.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_SWF_COPIEDTAG_H
+#define GNASH_SWF_COPIEDTAG_H
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <boost/noncopyable.hpp>
+
+#include "SWF.h"
+
+// Forward declarations
+namespace gnash {
+    class SWFStream;
+    class IOChannel;
+}
+
+namespace gnash {
+namespace SWF {
+
+/// A copy of the rest of a tag, for parsing later or on another thread.
+//
+/// The copy is read back as a complete tag of the same type, so the
+/// same code can parse it as the original.
+class CopiedTag : boost::noncopyable
+{
+public:
+
+    /// Copy the unread part of the tag open in a SWFStream.
+    CopiedTag(SWFStream& in, TagType tag);
+
+    TagType type() const {
+        return _type;
+    }
+
+    /// Read the copy.
+    //
+    /// The copy must be opened with SWFStream::open_tag() before it is
+    /// parsed, and must outlive the returned IOChannel.
+    std::unique_ptr<IOChannel> read() const;
+
+private:
+
+    const TagType _type;
+
+    /// The tag data, after a long tag header.
+    std::vector<std::uint8_t> _data;
+};
+
+} // namespace SWF
+} // namespace gnash
+
+#endif
@@ -26,6 +26,10 @@
 
 #include <limits>
 #include <cassert>
+#include <vector>
+#include <cstring>
+#include <memory>
+#include <algorithm>
 
 #include "IOChannel.h"
 #include "utility.h"
@@ -41,6 +45,8 @@
 #include "CachedBitmap.h"
 #include "GnashImage.h"
 #include "GnashImageJpeg.h"
+#include "LazyBitmap.h"
+#include "CopiedTag.h"
 
 #ifdef HAVE_ZLIB_H
 #include <zlib.h>
@@ -60,6 +66,7 @@ namespace {
     std::unique_ptr<image::GnashImage> readDefineBitsJpeg3(SWFStream& in, TagType tag);
     std::unique_ptr<image::GnashImage> readLossless(SWFStream& in, TagType tag);
 
+    std::unique_ptr<image::GnashImage> decodeBitmap(const CopiedTag& tag);
 }
 
 namespace {
@@ -207,32 +214,20 @@ DefineBitsTag::loader(SWFStream& in, TagType tag, movie_definition& m,
         return;
     }
 
+    // DefineBits data is read with the JPEG tables held by the movie's
+    // JpegInput, so it must be decoded now. Other bitmaps are copied and
+    // decoded when they are first drawn.
     std::unique_ptr<image::GnashImage> im;
 
-    switch (tag) {
-        case SWF::DEFINEBITS:
-            im = readDefineBitsJpeg(in, m);
-            break;
-        case SWF::DEFINEBITSJPEG2:
-            im = readDefineBitsJpeg2(in);
-            break;
-        case SWF::DEFINEBITSJPEG3:
-        case SWF::DEFINEBITSJPEG4:
-            im = readDefineBitsJpeg3(in, tag);
-            break;
-        case SWF::DEFINELOSSLESS:
-        case SWF::DEFINELOSSLESS2:
-            im = readLossless(in, tag);
-            break;
-        default:
-            std::abort();
-    }
-
-    if (!im.get()) {
-        IF_VERBOSE_MALFORMED_SWF(
-            log_swferror(_("Failed to parse bitmap for character %1%"), id);
-        );
-        return;
+    if (tag == SWF::DEFINEBITS) {
+        im = readDefineBitsJpeg(in, m);
+        if (!im.get()) {
+            IF_VERBOSE_MALFORMED_SWF(
+                log_swferror(_("Failed to parse bitmap for character %1%"),
+                    id);
+            );
+            return;
+        }
     }
 
     Renderer* renderer = r.renderer();
@@ -242,7 +237,18 @@ DefineBitsTag::loader(SWFStream& in, TagType tag, movie_definition& m,
         );
         return;
     }    
-    boost::intrusive_ptr<CachedBitmap> bi = renderer->createCachedBitmap(std::move(im));
+
+    boost::intrusive_ptr<CachedBitmap> bi;
+    if (im.get()) {
+        bi = renderer->createStaticBitmap(std::move(im));
+    }
+    else {
+        std::shared_ptr<const CopiedTag> data =
+            std::make_shared<CopiedTag>(in, tag);
+        bi = new LazyBitmap([data]() {
+                    return decodeBitmap(*data);
+                }, *renderer);
+    }
 
     IF_VERBOSE_PARSE(
         log_parse(_("Adding bitmap id %1%"), id);
@@ -253,6 +259,37 @@ DefineBitsTag::loader(SWFStream& in, TagType tag, movie_definition& m,
 
 namespace {
 
+/// Decode a bitmap tag copied when it was loaded.
+std::unique_ptr<image::GnashImage>
+decodeBitmap(const CopiedTag& tag)
+{
+    const std::unique_ptr<IOChannel> buf = tag.read();
+    SWFStream in(buf.get());
+
+    try {
+        in.open_tag();
+
+        switch (tag.type()) {
+            case SWF::DEFINEBITSJPEG2:
+                return readDefineBitsJpeg2(in);
+            case SWF::DEFINEBITSJPEG3:
+            case SWF::DEFINEBITSJPEG4:
+                return readDefineBitsJpeg3(in, tag.type());
+            case SWF::DEFINELOSSLESS:
+            case SWF::DEFINELOSSLESS2:
+                return readLossless(in, tag.type());
+            default:
+                std::abort();
+        }
+    }
+    catch (const std::exception& e) {
+        IF_VERBOSE_MALFORMED_SWF(
+            log_swferror(_("Error decoding bitmap: %s"), e.what());
+        );
+    }
+    return std::unique_ptr<image::GnashImage>();
+}
+
 // A JPEG image without included tables; those should be in an
 // existing image::JpegInput object stored in the movie.
 std::unique_ptr<image::GnashImage>
@@ -64,6 +64,10 @@ public:
 	virtual DisplayObject* createDisplayObject(Global_as& gl,
             DisplayObject* parent) const = 0;
 
+	virtual bool hasState() const {
+		return true;
+	}
+
     /// Executing a DefinitionTag adds its id to list of known characters
     //
     /// The process is different for imported DefinitionTags, which are added
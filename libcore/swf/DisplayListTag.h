@@ -49,6 +49,10 @@ public:
 
 	virtual ~DisplayListTag() {}
 
+	virtual bool hasState() const {
+		return true;
+	}
+
     /// All DisplayList tags are state tags.
 	virtual void executeState(MovieClip* m, DisplayList& dlist) const = 0;
 
@@ -58,6 +62,9 @@ public:
 	///       static depth zone (DisplayObject::staticDepthOffset .. -1)
 	int getDepth() const { return _depth; }
 
+	/// Whether this tag removes the DisplayObject at its depth.
+	virtual bool removes() const = 0;
+
 protected:
 
 	int _depth;
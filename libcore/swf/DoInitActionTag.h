@@ -49,6 +49,10 @@ public:
         read(in);
     }
 
+    virtual bool hasState() const {
+        return true;
+    }
+
     /// Execute 'state' tags.
     //
     /// State tags change the current state of a MovieClip. They are executed
@@ -50,6 +50,10 @@ public:
     }
 
 
+    virtual bool hasState() const {
+        return true;
+    }
+
     // TODO: use Movie to store the actual exports.
     virtual void executeState(MovieClip* m, DisplayList& /*l*/) const {
         Movie* mov = m->get_root();
@@ -52,6 +52,10 @@ public:
     }
 
 
+    virtual bool hasState() const {
+        return true;
+    }
+
     /// Execute an ImportAssetsTag.
     //
     /// Executing this tag adds the imported definition with an id to the 
@@ -51,6 +51,7 @@ PlaceObject2Tag::PlaceObject2Tag(const movie_definition& def)
     _ratio(0),
     m_clip_depth(0),
     _blendMode(0),
+    _bitmapCaching(false),
     _movie_def(def)
 {
 }
@@ -399,7 +400,6 @@ PlaceObject2Tag::readPlaceObject3(SWFStream& in)
         LOG_ONCE(log_unimpl("Blend mode in PlaceObject tag"));
     }
 
-    std::uint8_t bitmask = 0;
     if (hasBitmapCaching()) {
         // cacheAsBitmap is a boolean value, so the flag itself ought to be
         // enough. Alexis' SWF reference is unsure about this, but suggests
@@ -409,12 +409,10 @@ PlaceObject2Tag::readPlaceObject3(SWFStream& in)
         // However, the movie the-last-stand.swf has one PlaceObject3 tag
         // with both PlaceActions and bitmap caching, and the reserved bytes
         // of the PlaceActions (see readPlaceActions) are not 0 if this byte
-        // isn't read.
-        // TODO: set object property
+        // isn't read. Later versions of the spec call it BitmapCache,
+        // with 0 meaning disabled.
         in.ensureBytes(1);
-        bitmask = in.read_u8();
-	    LOG_ONCE(log_unimpl("Bitmap caching"));
-        UNUSED(bitmask);
+        _bitmapCaching = in.read_u8();
     }
 
     if (hasClipActions()) {
@@ -99,6 +99,8 @@ public:
     /// Place/move/whatever our object in the given movie.
     void executeState(MovieClip* m, DisplayList& dlist) const;
 
+    bool removes() const { return getPlaceType() == REMOVE; }
+
     static void loader(SWFStream& in, TagType tag, movie_definition& m,
             const RunResources& r);
 
@@ -148,6 +150,13 @@ public:
         return _blendMode;
     }
 
+    /// Whether the object should be cached as a bitmap.
+    //
+    /// Only meaningful if hasBitmapCaching() is true.
+    bool getBitmapCaching() const {
+        return _bitmapCaching;
+    }
+
 private:
 
     // read SWF::PLACEOBJECT 
@@ -173,6 +182,8 @@ private:
     
     std::uint8_t _blendMode;
 
+    bool _bitmapCaching;
+
     /// NOTE: getPlaceType() is dependent on the enum values.
     enum PlaceType
     {
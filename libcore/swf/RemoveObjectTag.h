@@ -56,6 +56,8 @@ public:
 	/// Remove object at specified depth from MovieClip DisplayList.
 	void executeState(MovieClip* m, DisplayList& dlist) const;
 
+	bool removes() const { return true; }
+
 	static void loader(SWFStream& in, TagType tag, movie_definition& m,
             const RunResources& r);
 
@@ -39,6 +39,10 @@ public:
 
     virtual ~ScriptLimitsTag() {}
 
+    virtual bool hasState() const {
+        return true;
+    }
+
     virtual void executeState(MovieClip* m, DisplayList& /*dl*/) const {
 
         LOG_ONCE( // movie_root will always log on change
@@ -78,6 +78,10 @@ public:
 		read(in);
 	}
 
+	virtual bool hasState() const {
+		return true;
+	}
+
 	void executeState(MovieClip* m, DisplayList& /*dlist*/) const {
 		m->set_background_color(m_color);
 	}
@@ -73,11 +73,15 @@ private:
 
 ShapeRecord::ShapeRecord(SWFStream& in, SWF::TagType tag, movie_definition& m,
         const RunResources& r)
+    :
+    _fingerprint(0)
 {
     read(in, tag, m, r);
 }
 
 ShapeRecord::ShapeRecord()
+    :
+    _fingerprint(0)
 {
 }
 
@@ -90,6 +94,7 @@ ShapeRecord::clear()
 {
     _bounds.set_null();
     _subshapes.clear();
+    _fingerprint = 0;
 }
 
 void
@@ -136,6 +141,8 @@ ShapeRecord::setLerp(const ShapeRecord& aa, const ShapeRecord& bb,
        return;
     }
 
+    _fingerprint = 0;
+
     // Update current bounds.
     _bounds.set_lerp(aa.getBounds(), bb.getBounds(), ratio);
     const Subshape& a = aa.subshapes().front();
@@ -199,6 +206,31 @@ ShapeRecord::setLerp(const ShapeRecord& aa, const ShapeRecord& bb,
     }
 }
 
+std::uint64_t
+ShapeRecord::computeFingerprint() const
+{
+    // FNV-1a
+    std::uint64_t h = 14695981039346656037ULL;
+    const auto mix = [&h](std::int64_t v) {
+        h = (h ^ static_cast<std::uint64_t>(v)) * 1099511628211ULL;
+    };
+    for (const Subshape& sub : _subshapes) {
+        for (const Path& p : sub.paths()) {
+            mix(p.m_fill0);
+            mix(p.m_fill1);
+            mix(p.ap.x);
+            mix(p.ap.y);
+            for (const Edge& e : p.m_edges) {
+                mix(e.cp.x);
+                mix(e.cp.y);
+                mix(e.ap.x);
+                mix(e.ap.y);
+            }
+        }
+    }
+    return h ? h : 1;
+}
+
 unsigned
 ShapeRecord::readStyleChange(SWFStream& in, size_t num_style_bits, size_t numStyles)
 {
@@ -225,6 +257,7 @@ void
 ShapeRecord::read(SWFStream& in, SWF::TagType tag, movie_definition& m,
         const RunResources& r)
 {
+    _fingerprint = 0;
 
     /// TODO: is this correct?
     const bool styleInfo = (tag == SWF::DEFINESHAPE ||
@@ -26,6 +26,7 @@
 #include "SWFRect.h"
 
 #include <vector>
+#include <cstdint>
 
 
 namespace gnash {
@@ -161,6 +162,17 @@ public:
 
     void addSubshape(const Subshape& subshape) {
     	_subshapes.push_back(subshape);
+        _fingerprint = 0;
+    }
+
+    /// Return a hash of the outline.
+    //
+    /// This is for caches that identify shapes by address, which can be
+    /// reused. It is computed the first time it is needed after the
+    /// shape changes.
+    std::uint64_t fingerprint() const {
+        if (!_fingerprint) _fingerprint = computeFingerprint();
+        return _fingerprint;
     }
 
     const SWFRect& getBounds() const {
@@ -195,6 +207,9 @@ private:
 
     unsigned readStyleChange(SWFStream& in, size_t num_fill_bits, size_t numStyles);
 
+    /// Hash the paths, never returning 0.
+    std::uint64_t computeFingerprint() const;
+
     /// Shape record flags for use in parsing.
     enum ShapeRecordFlags {
         SHAPE_END = 0x00,
@@ -207,6 +222,9 @@ private:
 
     SWFRect _bounds;
     Subshapes _subshapes;
+
+    /// 0 until computed.
+    mutable std::uint64_t _fingerprint;
 };
 
 std::ostream& operator<<(std::ostream& o, const ShapeRecord& sh);
@@ -57,6 +57,7 @@
 #include "as_value.h"
 #include "RunResources.h"
 #include "ObjectURI.h"
+#include "DecodedActions.h"
 
 // GNASH_PARANOIA_LEVEL:
 // 0 : no assertions
@@ -78,6 +79,21 @@ namespace {
     /// @return     null if the value cannot be converted to an object.
     as_object* safeToObject(VM& vm, const as_value& val);
 
+    /// Get the ObjectURI for a value used as a property name.
+    //
+    /// Interned strings (ActionPush literals and constants) are only
+    /// looked up once: the constant pool or decoded push item keeps the
+    /// ObjectURI, and the call site's cache, if there is one, remembers
+    /// the last of them. Other names are looked up each time.
+    ObjectURI nameURI(ActionExec& thread, const as_value& name,
+            PropertyCache* cache);
+
+    /// Get the ObjectURI for a name already converted to a string.
+    //
+    /// This saves converting the name again when it is not interned.
+    ObjectURI nameURI(ActionExec& thread, const as_value& name,
+            const std::string& str, PropertyCache* cache);
+
     /// Common code for ActionGetUrl and ActionGetUrl2
     //
     /// @param target         the target window or _level1 to _level10
@@ -205,6 +221,7 @@ class Enumerator : public KeyVisitor
 public:
     explicit Enumerator(as_environment& env) : _env(env) {}
     virtual void operator()(const ObjectURI& uri) {
+        _env.reserveStack(1);
         _env.push(uri.toString(getStringTable(_env)));
     }
 private:
@@ -426,9 +443,15 @@ SWFHandlers::instance()
 
 void
 SWFHandlers::execute(ActionType type, ActionExec& thread) const
+{
+    execute(_handlers[type], thread);
+}
+
+void
+SWFHandlers::execute(const ActionHandler& handler, ActionExec& thread) const
 {
     try {
-        _handlers[type].execute(thread);
+        handler.execute(thread);
     }
     catch (const ActionParserException& e) {
         log_swferror(_("Malformed action code: %s"), e.what());
@@ -955,7 +978,17 @@ ActionGetVariable(ActionExec& thread)
         return;
     }
 
-    top_value = thread.getVariable(var_string);
+    const DecodedAction* act = thread.currentAction();
+    PropertyCache* cache = act ? act->cache.get() : nullptr;
+
+    // Interned names are only resolved once for the call site.
+    const SharedString* name = top_value.sharedString();
+    const bool interned = cache && name && name->interned();
+    const ObjectURI uri = interned ?
+        nameURI(thread, top_value, var_string, cache) : ObjectURI();
+
+    top_value = thread.getVariable(var_string, nullptr, cache,
+            interned ? &uri : nullptr);
     if (env.get_version() < 5 && top_value.is_sprite()) {
         // See http://www.ferryhalim.com/orisinal/g2/penguin.htm
         IF_VERBOSE_ASCODING_ERRORS(
@@ -1738,7 +1771,7 @@ pushConstant(ActionExec& thread, unsigned int id)
         return;
     }
 
-    env.push( (*pool)[id] );
+    env.push(pool->value(id));
 }
 
 void
@@ -1773,12 +1806,51 @@ ActionPushData(ActionExec& thread)
 
     const action_buffer& code = thread.code;
 
+    size_t count = 0;
+
+    // Operands already parsed at decode time.
+    const DecodedAction* act = thread.currentAction();
+    if (act && act->pushDecoded) {
+        typedef DecodedAction::PushItem PushItem;
+        for (const PushItem& item : act->push) {
+            switch (item.kind)
+            {
+                case PushItem::LITERAL:
+                    env.push(item.value);
+                    break;
+
+                case PushItem::REGISTER:
+                {
+                    const as_value* v = getVM(env).getRegister(item.index);
+                    if (!v) {
+                        IF_VERBOSE_MALFORMED_SWF(
+                            log_swferror(_("Invalid register %d in "
+                                    "ActionPush"), item.index);
+                        );
+                        env.push(as_value());
+                    }
+                    else env.push(*v);
+                    break;
+                }
+
+                case PushItem::CONSTANT:
+                    pushConstant(thread, item.index);
+                    break;
+            }
+
+            IF_VERBOSE_ACTION(
+                log_action(_("\t%d) value=%s"), count, env.top(0));
+                ++count;
+            );
+        }
+        return;
+    }
+
     const size_t pc = thread.getCurrentPC();
     const std::uint16_t length = code.read_uint16(pc + 1);
 
     //---------------
     size_t i = pc;
-    size_t count = 0;
     while (i - pc < length) {
 
         const std::uint8_t type = code[3 + i];
@@ -1893,7 +1965,9 @@ ActionPushData(ActionExec& thread)
 void
 ActionBranchAlways(ActionExec& thread)
 {
-    std::int16_t offset = thread.code.read_int16(thread.getCurrentPC()+3);
+    const DecodedAction* act = thread.currentAction();
+    std::int16_t offset = act ? act->branchOffset :
+        thread.code.read_int16(thread.getCurrentPC()+3);
     thread.adjustNextPC(offset);
     // @@ TODO range checks
 }
@@ -1936,7 +2010,8 @@ ActionBranchIfTrue(ActionExec& thread)
     //assert(thread.atActionTag(SWF::ACTION_BRANCHIFTRUE));
 #endif
 
-    std::int16_t offset = code.read_int16(pc+3);
+    const DecodedAction* act = thread.currentAction();
+    std::int16_t offset = act ? act->branchOffset : code.read_int16(pc+3);
 
     const bool test = toBool(env.pop(), getVM(env));
     if (test) {
@@ -2601,9 +2676,14 @@ ActionGetMember(ActionExec& thread)
                    target, static_cast<void*>(obj));
     );
 
-    const ObjectURI& k = getURI(getVM(env), member_name.to_string());
+    const DecodedAction* act = thread.currentAction();
+    PropertyCache* cache = act ? act->cache.get() : nullptr;
+
+    const ObjectURI k = nameURI(thread, member_name, cache);
 
-    if (!obj->get_member(k, &env.top(1))) {
+    const bool found = cache ? obj->get_member(k, &env.top(1), *cache) :
+                               obj->get_member(k, &env.top(1));
+    if (!found) {
         IF_VERBOSE_ASCODING_ERRORS(
             log_aserror("Reference to undefined member %s of object %s",
                 member_name, target);
@@ -2637,7 +2717,12 @@ ActionSetMember(ActionExec& thread)
         );
     }
     else if (obj) {
-        obj->set_member(getURI(getVM(env), member_name), member_value);
+        const DecodedAction* act = thread.currentAction();
+        PropertyCache* cache = act ? act->cache.get() : nullptr;
+        const ObjectURI k = nameURI(thread, env.top(1), member_name,
+                cache);
+        if (cache) obj->set_member(k, member_value, *cache);
+        else obj->set_member(k, member_value);
 
         IF_VERBOSE_ACTION (
             log_action(_("-- set_member %s.%s=%s"),
@@ -2758,7 +2843,7 @@ ActionCallMethod(ActionExec& thread)
     }
     else {
 
-        methURI = getURI(getVM(env), method_string);
+        methURI = nameURI(thread, method_name, method_string, nullptr);
 
         // The method value
         as_value method_value; 
@@ -2804,7 +2889,7 @@ ActionCallMethod(ActionExec& thread)
 
     as_object* super;
     as_function* func = method_obj->to_function();
-    if (func && func->isBuiltin()) {
+    if (func && (func->isBuiltin() || !func->usesSuper())) {
         // Do not construct super if method is a builtin
         // TODO: check if this is correct!!
         super = nullptr;
@@ -2876,7 +2961,8 @@ ActionNewMethod(ActionExec& thread)
         method_val = obj_val;
     }
     else {
-        const ObjectURI& k = getURI(getVM(env), method_string);
+        const ObjectURI k = nameURI(thread, method_name, method_string,
+                nullptr);
         if (!obj->get_member(k, &method_val)) {
             IF_VERBOSE_ASCODING_ERRORS(
                 log_aserror(_("ActionNewMethod: can't find method %s of "
@@ -3465,6 +3551,39 @@ safeToObject(VM& vm, const as_value& val)
     }
 }
 
+ObjectURI
+nameURI(ActionExec& thread, const as_value& name, PropertyCache* cache)
+{
+    const SharedString* str = name.sharedString();
+    if (str && str->interned()) {
+        return nameURI(thread, name, str->str(), cache);
+    }
+    return nameURI(thread, name, name.to_string(), cache);
+}
+
+ObjectURI
+nameURI(ActionExec& thread, const as_value& name, const std::string& str,
+        PropertyCache* cache)
+{
+    const VM& vm = getVM(thread.env);
+
+    const SharedString* shared = name.sharedString();
+    if (!shared || !shared->interned()) return getURI(vm, str);
+
+    if (cache) {
+        if (const ObjectURI* uri = cache->uri(*shared)) return *uri;
+    }
+
+    // Constants and literals keep their ObjectURI once looked up.
+    const ConstantPool* pool = vm.getConstantPool();
+    const ObjectURI* known = pool ? pool->uri(vm, *shared) : nullptr;
+    if (!known) known = thread.code.decoded().uri(vm, *shared);
+
+    const ObjectURI uri = known ? *known : getURI(vm, str);
+    if (cache) cache->setURI(*shared, uri);
+    return uri;
+}
+
 // Utility: construct an object using given constructor.
 // This is used by both ActionNew and ActionNewMethod and
 // hides differences between builtin and actionscript-defined
@@ -34,6 +34,7 @@
 #include "as_environment.h"
 #include "SystemClock.h"
 #include "CallStack.h"
+#include "DecodedActions.h"
 
 #include <sstream>
 #include <string>
@@ -58,6 +59,13 @@
 
 namespace gnash {
 
+namespace {
+
+/// The most values an action other than PushData pushes on the stack.
+const size_t maxActionPushes = 4;
+
+}
+
 ActionExec::ActionExec(const Function& func, as_environment& newEnv,
         as_value* nRetVal, as_object* this_ptr)
     :
@@ -75,7 +83,9 @@ ActionExec::ActionExec(const Function& func, as_environment& newEnv,
     _abortOnUnload(false),
     pc(func.getStartPC()),
     next_pc(pc),
-    stop_pc(pc + func.getLength())
+    stop_pc(pc + func.getLength()),
+    _decoded(code.decoded()),
+    _current(nullptr)
 {
     //assert(stop_pc < code.size());
 
@@ -117,7 +127,9 @@ ActionExec::ActionExec(const action_buffer& abuf, as_environment& newEnv,
     _abortOnUnload(abortOnUnloaded),
     pc(0),
     next_pc(0),
-    stop_pc(abuf.size())
+    stop_pc(abuf.size()),
+    _decoded(abuf.decoded()),
+    _current(nullptr)
 {
 }
 
@@ -213,8 +225,14 @@ ActionExec::operator()()
                 _scopeStack.pop_back();
             }
 
+            // Use the pre-decoded action if one starts here, or fall
+            // back to reading the raw buffer (e.g. for jumps into the
+            // middle of an instruction).
+            _current = _decoded.find(pc, _current);
+
             // Get the opcode.
-            std::uint8_t action_id = code[pc];
+            std::uint8_t action_id = _current ?
+                static_cast<std::uint8_t>(_current->type) : code[pc];
 
             IF_VERBOSE_ACTION (
                 log_action(_("PC:%d - EX: %s"), pc, code.disasm(pc));
@@ -229,7 +247,8 @@ ActionExec::operator()()
             else {
                 // action with extra data
                 // Note this converts from int to uint!
-                std::uint16_t length(code.read_int16(pc + 1));
+                std::uint16_t length = _current ?
+                    _current->nextPC - pc - 3 : code.read_int16(pc + 1);
 
                 next_pc = pc + length + 3;
                 if (next_pc > stop_pc) {
@@ -255,7 +274,13 @@ ActionExec::operator()()
                 break;
             }
 
-            ash.execute(static_cast<SWF::ActionType>(action_id), *this);
+            // Handlers push without checking, so make room first. A
+            // PushData can't push more values than it has bytes.
+            env.reserveStack(action_id == SWF::ACTION_PUSHDATA ?
+                    next_pc - pc : maxActionPushes);
+
+            if (_current) ash.execute(*_current->handler, *this);
+            else ash.execute(static_cast<SWF::ActionType>(action_id), *this);
 
             // Code round here has to do with bugs: #20974, #21069, #20996,
             // but since there is so much disabled code it's not clear exactly
@@ -496,6 +521,7 @@ ActionExec::processExceptions(TryBlock& t)
                       "uncaught one (%s) back on stack", ex);
 #endif                   
 
+                env.reserveStack(1);
                 env.push(t._lastThrow);
  
 
@@ -531,6 +557,10 @@ ActionExec::cleanupAfterRun()
     env.set_target(_originalTarget);
     _originalTarget = nullptr;
 
+    // Code run from an action handler may leave values on the stack;
+    // keep room for the handler's own pushes.
+    env.reserveStack(maxActionPushes);
+
     vm.setSWFVersion(_origExecSWFVersion);
 
     IF_VERBOSE_MALFORMED_SWF(
@@ -618,9 +648,10 @@ ActionExec::setVariable(const std::string& name, const as_value& val)
 }
 
 as_value
-ActionExec::getVariable(const std::string& name, as_object** target)
+ActionExec::getVariable(const std::string& name, as_object** target,
+        PropertyCache* cache, const ObjectURI* uri)
 {
-    return gnash::getVariable(env, name, getScopeStack(), target);
+    return gnash::getVariable(env, name, getScopeStack(), target, cache, uri);
 }
 
 void
@@ -33,6 +33,9 @@ namespace gnash {
 	class as_value;
 	class Function;
 	class ActionExec;
+	class DecodedActions;
+	struct DecodedAction;
+	class PropertyCache;
 }
 
 namespace gnash {
@@ -205,7 +208,10 @@ public:
 	///	                containing any found variable. If you aren't interested,
     ///                 pass null (default). If the variable does not belong
     ///                 to an object, target will be set to null.
-	as_value getVariable(const std::string& name, as_object** target = nullptr);
+	/// @param cache    If not null, a lookup cache for the calling site.
+	/// @param uri      If not null, the ObjectURI of name.
+	as_value getVariable(const std::string& name, as_object** target = nullptr,
+            PropertyCache* cache = nullptr, const ObjectURI* uri = nullptr);
 
 	/// Get current target.
 	//
@@ -236,6 +242,12 @@ public:
 	void setNextPC(size_t pc) { next_pc = pc; }
 	
 	size_t getStopPC() const { return stop_pc; }
+
+	/// The pre-decoded form of the action being executed
+	//
+	/// @return     null if the current action could not be pre-decoded,
+	///             in which case handlers must read the raw buffer.
+	const DecodedAction* currentAction() const { return _current; }
 	
 private: 
 
@@ -328,6 +340,12 @@ private:
 	/// Used for try/throw/catch blocks.
 	size_t stop_pc;
 
+	/// The pre-decoded instruction stream of the action buffer
+	const DecodedActions& _decoded;
+
+	/// The pre-decoded action at pc, or null
+	const DecodedAction* _current;
+
 };
 
 } // namespace gnash
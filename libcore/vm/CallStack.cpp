@@ -27,13 +27,16 @@
 
 namespace gnash {
 
-CallFrame::CallFrame(UserFunction* f)
+CallFrame::CallFrame(UserFunction* f, Registers& registers)
     :
     _locals(new as_object(getGlobal(*f))),
     _func(f),
-    _registers(_func->registers())
+    _registers(&registers),
+    _registerBase(registers.size()),
+    _registerCount(_func->registers())
 {
     //assert(_func);
+    registers.resize(_registerBase + _registerCount);
 }
 
 /// Mark all reachable resources
@@ -46,7 +49,9 @@ CallFrame::markReachableResources() const
     //assert(_func);
     _func->setReachable();
 
-    std::for_each(_registers.begin(), _registers.end(),
+    const Registers::const_iterator regs =
+        _registers->begin() + _registerBase;
+    std::for_each(regs, regs + _registerCount,
             std::mem_fun_ref(&as_value::setReachable));
 
     //assert(_locals);
@@ -56,9 +61,9 @@ CallFrame::markReachableResources() const
 void
 CallFrame::setLocalRegister(size_t i, const as_value& val)
 {
-    if (i >= _registers.size()) return;
+    if (i >= _registerCount) return;
 
-    _registers[i] = val;
+    (*_registers)[_registerBase + i] = val;
 
     IF_VERBOSE_ACTION(
         log_action(_("-------------- local register[%d] = '%s'"),
@@ -95,11 +100,9 @@ setLocal(CallFrame& c, const ObjectURI& name, const as_value& val)
 std::ostream&
 operator<<(std::ostream& o, const CallFrame& fr)
 {
-    CallFrame::Registers r = fr._registers;
-
-    for (size_t i = 0; i < r.size(); ++i) {
+    for (size_t i = 0; i < fr._registerCount; ++i) {
         if (i) o << ", ";
-        o << i << ':' << '"' << r[i] << '"';
+        o << i << ':' << '"' << *fr.getLocalRegister(i) << '"';
     }
     return o;
     
@@ -48,17 +48,23 @@ public:
 
     /// Construct a CallFrame for a specific UserFunction
     //
-    /// @param func     The UserFunction to create the CallFrame for. This
-    ///                 must provide information about the amount of registers
-    ///                 to allocate.
-    CallFrame(UserFunction* func);
-    
+    /// @param func         The UserFunction to create the CallFrame for.
+    ///                     This must provide information about the amount
+    ///                     of registers to allocate.
+    /// @param registers    The local registers of all frames in the call
+    ///                     stack. The registers of the new frame are added
+    ///                     on top, and must be removed by the owner of the
+    ///                     call stack when the frame is.
+    CallFrame(UserFunction* func, Registers& registers);
+
     /// Copy constructor for containers
     CallFrame(const CallFrame& other)
         :
         _locals(other._locals),
         _func(other._func),
-        _registers(other._registers)
+        _registers(other._registers),
+        _registerBase(other._registerBase),
+        _registerCount(other._registerCount)
     {}
 
     /// Assignment operator for containers.
@@ -66,6 +72,8 @@ public:
         _locals = other._locals;
         _func = other._func;
         _registers = other._registers;
+        _registerBase = other._registerBase;
+        _registerCount = other._registerCount;
         return *this;
     }
 
@@ -83,10 +91,12 @@ public:
     //
     /// @param i    The index of the register to return.
     /// @return     A pointer to the value in the register or 0 if no such
-    ///             register exists.
+    ///             register exists. Registers of all frames share one
+    ///             stack, so the pointer is only valid until the next
+    ///             function call.
     const as_value* getLocalRegister(size_t i) const {
-        if (i >= _registers.size()) return nullptr;
-        return &_registers[i];
+        if (i >= _registerCount) return nullptr;
+        return &(*_registers)[_registerBase + i];
     }
 
     /// Set a specific register in this CallFrame
@@ -97,12 +107,14 @@ public:
     /// @param val  The value to set the register to.
     void setLocalRegister(size_t i, const as_value& val);
 
-    /// Set the number of registers for this CallFrame.
-    //
-    /// The number of registers may only be set once! This is to ensure
-    /// that pointers to the register values are always valid.
+    /// Whether this CallFrame has its own registers.
     bool hasRegisters() const {
-        return !_registers.empty();
+        return _registerCount;
+    }
+
+    /// The position of this frame's first register in the register stack.
+    size_t registerBase() const {
+        return _registerBase;
     }
 
     /// Mark all reachable resources
@@ -121,8 +133,14 @@ private:
 
     UserFunction* _func;
     
-    /// Local registers.
-    Registers _registers;
+    /// The register stack holding the local registers.
+    //
+    /// The registers are kept by index, as the stack may move when it grows.
+    Registers* _registers;
+
+    size_t _registerBase;
+
+    size_t _registerCount;
 
 };
 
@@ -0,0 +1,201 @@
+// OperandStack.h  The AVM1 operand stack, for Gnash.
+//
+//   Copyright (C) 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc.
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_OPERANDSTACK_H
+#define GNASH_OPERANDSTACK_H
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <boost/noncopyable.hpp>
+
+namespace gnash {
+
+/// A stack of operands with unchecked push and pop.
+//
+/// Values are kept in contiguous segments, so push(), pop() and top()
+/// are pointer operations on the current segment. Space must be
+/// reserved before pushing: the interpreter does this once per action.
+//
+/// Segments are never moved or freed while the stack lives, so
+/// references to values remain valid when the stack grows, as with
+/// SafeStack. Values are not destroyed when they are popped; they are
+/// overwritten by later pushes.
+template<typename T>
+class OperandStack : boost::noncopyable
+{
+public:
+
+    typedef std::size_t StackSize;
+
+    OperandStack()
+        :
+        _current(0),
+        _below(0)
+    {
+        _segments.push_back(Segment(initialCapacity));
+        enter(0);
+    }
+
+    /// Make sure at least n values can be pushed.
+    void reserve(StackSize n) {
+        if (static_cast<StackSize>(_end - _top) < n) nextSegment(n);
+    }
+
+    /// Push a value. Space must have been reserved.
+    void push(const T& t) {
+        assert(_top != _end);
+        *_top++ = t;
+    }
+
+    /// Pop the top value. The stack must not be empty.
+    //
+    /// The returned reference remains valid until the next push.
+    T& pop() {
+        assert(!empty());
+        T& ret = *--_top;
+        if (_top == _base) leaveEmpty();
+        return ret;
+    }
+
+    /// From the top of the stack, get the i'th value down.
+    //
+    /// 0 is the topmost value. i must be less than size().
+    T& top(StackSize i) const {
+        if (i < static_cast<StackSize>(_top - _base)) return _top[-1 - i];
+        return deep(i - (_top - _base));
+    }
+
+    /// From the bottom of the stack, get the i'th value up.
+    //
+    /// 0 is the bottommost value. i must be less than size().
+    T& value(StackSize i) const {
+        assert(i < size());
+        for (StackSize s = 0; s < _current; ++s) {
+            const Segment& seg = _segments[s];
+            if (i < seg.used) return seg.data[i];
+            i -= seg.used;
+        }
+        return _base[i];
+    }
+
+    /// Drop n values from the top. n must not be more than size().
+    void drop(StackSize n) {
+        assert(n <= size());
+        while (n >= static_cast<StackSize>(_top - _base) && _current) {
+            n -= _top - _base;
+            _top = _base;
+            leaveEmpty();
+        }
+        _top -= n;
+    }
+
+    /// Drop all values, keeping the memory for reuse.
+    void clear() {
+        _below = 0;
+        enter(0);
+    }
+
+    StackSize size() const {
+        return _below + (_top - _base);
+    }
+
+    bool empty() const {
+        return _top == _base && !_below;
+    }
+
+private:
+
+    /// The number of values in the first segment.
+    static const StackSize initialCapacity = 1024;
+
+    struct Segment
+    {
+        explicit Segment(StackSize n) : data(new T[n]), capacity(n), used(0) {}
+        std::unique_ptr<T[]> data;
+        StackSize capacity;
+
+        /// The number of values in use, saved when leaving the segment.
+        StackSize used;
+    };
+
+    /// Start using the given segment, with no values in it.
+    void enter(StackSize s) {
+        _current = s;
+        Segment& seg = _segments[s];
+        _base = _top = seg.data.get();
+        _end = _base + seg.capacity;
+    }
+
+    /// Continue on a segment with room for at least n values.
+    void nextSegment(StackSize n) {
+        Segment& seg = _segments[_current];
+        seg.used = _top - _base;
+        _below += seg.used;
+
+        const StackSize next = _current + 1;
+        if (next == _segments.size() || _segments[next].capacity < n) {
+            const StackSize capacity = std::max(n, seg.capacity * 2);
+            _segments.insert(_segments.begin() + next, Segment(capacity));
+        }
+        enter(next);
+    }
+
+    /// Return to the last segment with values in it, if any.
+    //
+    /// The stack is then back where it was when the segments were
+    /// entered, and any space reserved then is still available.
+    void leaveEmpty() {
+        while (_top == _base && _current) {
+            const Segment& seg = _segments[--_current];
+            _below -= seg.used;
+            _base = seg.data.get();
+            _top = _base + seg.used;
+            _end = _base + seg.capacity;
+        }
+    }
+
+    /// Get the i'th value down from the top of the previous segments.
+    T& deep(StackSize i) const {
+        assert(i < _below);
+        StackSize s = _current;
+        while (i >= _segments[--s].used) i -= _segments[s].used;
+        const Segment& seg = _segments[s];
+        return seg.data[seg.used - 1 - i];
+    }
+
+    std::vector<Segment> _segments;
+
+    /// The segment values are pushed to.
+    StackSize _current;
+
+    /// The number of values in the segments before the current one.
+    StackSize _below;
+
+    /// The bottom, top and end of the current segment.
+    T* _base;
+    T* _top;
+    T* _end;
+};
+
+} // namespace gnash
+
+#endif
@@ -168,10 +168,10 @@ VM::markReachableResources() const
     if (_shLib.get()) _shLib->markReachableResources();
 
 #ifdef ALLOW_GC_RUN_DURING_ACTIONS_EXECUTION
-    /// Mark all (including unreachable) stack elements
-    for (SafeStack<as_value>::StackSize i=0, n=_stack.totalSize(); i<n; ++i)
+    /// Mark all stack elements
+    for (OperandStack<as_value>::StackSize i=0, n=_stack.size(); i<n; ++i)
     {
-        _stack.at(i).setReachable();
+        _stack.value(i).setReachable();
     }
 
     /// Mark call stack 
@@ -182,7 +182,7 @@ VM::markReachableResources() const
 
 #else
     assert (_callStack.empty());
-    assert (_stack.totalSize() == 0);
+    assert (_stack.empty());
 #endif
 
 }
@@ -253,7 +253,7 @@ VM::pushCallFrame(UserFunction& func)
         throw ActionLimitException(ss.str()); 
     }
 
-    _callStack.emplace_back(&func);
+    _callStack.emplace_back(&func, _localRegisters);
     return _callStack.back();
 }
 
@@ -261,6 +261,7 @@ void
 VM::popCallFrame()
 {
     //assert(!_callStack.empty());
+    _localRegisters.resize(_callStack.back().registerBase());
     _callStack.pop_back();
 }
 
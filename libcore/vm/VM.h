@@ -32,7 +32,7 @@
 #include <boost/noncopyable.hpp>
 
 #include "string_table.h"
-#include "SafeStack.h"
+#include "OperandStack.h"
 #include "CallStack.h"
 #include "as_value.h"
 #include "namedStrings.h"
@@ -85,7 +85,7 @@ public:
     /// Accessor for the VM's stack
     //
     /// TODO: drop
-	SafeStack<as_value>& getStack() {
+	OperandStack<as_value>& getStack() {
 		return _stack;
 	}
 
@@ -195,7 +195,9 @@ public:
     //
     /// @param index    The index of the register to retrieve.
     /// @return         A pointer to the as_value at the specified position, or
-    ///                 0 if the index is invalid
+    ///                 0 if the index is invalid. It must not be kept
+    ///                 across a function call, which may move the
+    ///                 registers.
     const as_value* getRegister(size_t index);
 
     /// Set value of a register (local or global).
@@ -268,13 +270,19 @@ private:
 
 	VirtualClock& _clock;
 
-	SafeStack<as_value>	_stack;
+	OperandStack<as_value> _stack;
 
     typedef std::array<as_value, 4> GlobalRegisters;
     GlobalRegisters _globalRegisters;
 
 	CallStack _callStack;
 
+    /// The local registers of all frames in the call stack.
+    //
+    /// Frames take their registers from the top, so that calls don't
+    /// allocate memory once the stack has grown.
+    CallFrame::Registers _localRegisters;
+
 	/// Library of SharedObjects. Owned by the VM.
     std::unique_ptr<SharedObjectLibrary> _shLib;
 
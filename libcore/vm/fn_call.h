@@ -24,6 +24,7 @@
 #include <cassert> 
 #include <ostream>
 #include <algorithm>
+#include <boost/container/small_vector.hpp>
 
 #include "utility.h" // for typeName
 #include "as_object.h"
@@ -52,13 +53,19 @@ namespace gnash {
 /// The arguments can be moved to another container, and this happens when
 /// the FunctionArgs object is passed to fn_call. It will still be valid
 /// afterwards, but will contain no arguments.
+//
+/// Most calls have only a few arguments, so these are stored in the
+/// object itself and only longer lists allocate memory.
 template<typename T>
 class FunctionArgs
 {
 public:
 
-    typedef typename std::vector<T>::size_type size_type;
-    typedef std::vector<T> container_type;
+    /// The number of arguments stored without allocating.
+    static const size_t inlineArgs = 6;
+
+    typedef boost::container::small_vector<T, inlineArgs> container_type;
+    typedef typename container_type::size_type size_type;
     typedef T value_type;
 
     FunctionArgs() = default;
@@ -98,8 +105,8 @@ public:
                       std::mem_fun_ref(&as_value::setReachable));
     }
 
-    void swap(std::vector<T>& to) {
-        std::swap(_v, to);
+    void swap(container_type& to) {
+        _v.swap(to);
     }
 
     size_type size() const {
@@ -107,7 +114,7 @@ public:
     }
 
 private:
-    std::vector<T> _v;
+    container_type _v;
 };
 
 
@@ -461,19 +461,7 @@ AudioDecoderSimple::decode(const std::uint8_t* input, std::uint32_t inputSize,
 	// If we need to convert samplerate or/and from mono to stereo...
 	if (outsize > 0 && (_sampleRate != 44100 || !_stereo)) {
 
-		std::int16_t* adjusted_data = nullptr;
-		int	adjusted_size = 0;
-		int sample_count = outsize / (_stereo ? 4 : 2); // samples are of size 2
-
-		// Convert to needed samplerate - this converter only support standard flash samplerates
-		AudioResampler::convert_raw_data(&adjusted_data, &adjusted_size,
-                tmp_raw_buffer,
-                sample_count, 2,  // input sample size is 2 !
-				_sampleRate, _stereo,
-				44100,  true /* stereo */);
-
-		// Hopefully this wont happen
-		if (!adjusted_data) {
+		if (!_sampleRate) {
 			log_error(_("Error in sound sample conversion"));
 			delete[] tmp_raw_buffer;
 			outputSize = 0;
@@ -481,10 +469,24 @@ AudioDecoderSimple::decode(const std::uint8_t* input, std::uint32_t inputSize,
 			return nullptr;
 		}
 
+		// The resampler keeps state between blocks, so it is made once.
+		if (!_resampler) {
+			_resampler.reset(new AudioResampler(_sampleRate, _stereo));
+		}
+
+		const size_t frames = outsize / (_stereo ? 4 : 2); // samples are of size 2
+
+		std::int16_t* adjusted_data =
+			new std::int16_t[_resampler->maxOutputSamples(frames)];
+
+		const size_t adjusted_samples = _resampler->process(
+				reinterpret_cast<const std::int16_t*>(tmp_raw_buffer),
+				frames, adjusted_data);
+
 		// Move the new data to the sound-struct
 		delete[] tmp_raw_buffer;
 		tmp_raw_buffer = reinterpret_cast<std::uint8_t*>(adjusted_data);
-		tmp_raw_buffer_size = adjusted_size;
+		tmp_raw_buffer_size = adjusted_samples * sizeof(std::int16_t);
 
 	} else {
 		tmp_raw_buffer_size = outsize;
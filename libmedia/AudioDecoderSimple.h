@@ -21,7 +21,10 @@
 #ifndef GNASH_AUDIODECODERSIMPLE_H
 #define GNASH_AUDIODECODERSIMPLE_H
 
+#include <memory>
+
 #include "AudioDecoder.h" // for inheritance
+#include "AudioResampler.h" // for composition
 #include "MediaParser.h" // for audioCodecType enum (composition)
 
 // Forward declarations
@@ -86,6 +89,8 @@ private:
 	// samplesize: 8 or 16 bit
 	bool _is16bit;
 
+	// Converts to 44100 Hz stereo, created on first use
+	std::unique_ptr<AudioResampler> _resampler;
 
 	// 
 };
@@ -17,141 +17,179 @@
 // along with this program; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+
 #include "AudioResampler.h"
 
-#include <cstring>
+#include <algorithm>
+#include <cmath>
 #include <cassert>
 
 namespace gnash {
 namespace media {
 
-void 
-AudioResampler::convert_raw_data(
-    std::int16_t** adjusted_data,
-    int* adjusted_size,
-    void* data,
-    int sample_count,	// A stereo pair counts as one
-    int sample_size,	// Should now always == 2
-    // sample_rate and stereo are those of the incoming sample
-    int sample_rate, 
-    bool stereo,
-    // m_sample_rate, m_stereo are the format we must convert to.
-    int m_sample_rate,
-    bool m_stereo)
+namespace {
+
+/// Number of taps of each phase of the filter.
+const int taps = 16;
+
+/// Number of phases, i.e. positions between two input samples.
+const int phaseBits = 8;
+const int phases = 1 << phaseBits;
+
+/// Coefficients are 2.14 fixed point.
+const int coeffShift = 14;
+
+/// Input frames before the output position the filter looks at.
+const int before = taps / 2 - 1;
+
+inline std::int16_t
+clamp16(std::int32_t v)
 {
+    return std::max<std::int32_t>(-32768, std::min<std::int32_t>(32767, v));
+}
 
-    //assert(sample_size == 2); // at least it seems the code relies on this...
+}
 
-    // simple hack to handle dup'ing mono to stereo
-    if ( !stereo && m_stereo)
-    {
-	sample_rate >>= 1;
-    }
+AudioResampler::AudioResampler(int inRate, bool inStereo, int outRate)
+    :
+    _inRate(inRate),
+    _outRate(outRate),
+    _channels(inStereo ? 2 : 1),
+    // Rounded up, so that a block never gives more than
+    // maxOutputSamples() even after a long time.
+    _step(((static_cast<std::uint64_t>(inRate) << 32) + outRate - 1) /
+            outRate),
+    _pos(0)
+{
+    assert(inRate > 0 && outRate > 0);
 
-    // simple hack to lose half the samples to get mono from stereo
-    if ( stereo && !m_stereo)
-    {
-	sample_rate <<= 1;
-    }
+    // Below the lower of the two Nyquist frequencies, with some room
+    // for the filter to roll off.
+    const double cutoff = 0.9 * std::min(1.0,
+            static_cast<double>(outRate) / inRate);
+    makeFilter(cutoff);
 
-    // Brain-dead sample-rate conversion: duplicate or
-    // skip input samples an integral number of times.
-    int	inc = 1;	// increment
-    int	dup = 1;	// duplicate
-    if (sample_rate > m_sample_rate)
-    {
-	inc = sample_rate / m_sample_rate;
-    }
-    else if (sample_rate < m_sample_rate)
-    {
-	dup = m_sample_rate / sample_rate;
-    }
+    reset();
+}
 
-    int	output_sample_count = (sample_count * dup * (stereo ? 2 : 1)) / inc;
-    std::int16_t*	out_data = new std::int16_t[output_sample_count];
-    *adjusted_data = out_data;
-    *adjusted_size = output_sample_count * sizeof(std::int16_t); // in bytes
-
-    // Either inc > 1 (decimate the audio)
-    // or dup > 1 (repeat samples)
-    // or both == 1 (no transformation required)
-    if (inc == 1 && dup == 1)
-    {
-	    // No tranformation required
-	    std::memcpy(out_data, data, output_sample_count * sizeof(std::int16_t));
+void
+AudioResampler::makeFilter(double cutoff)
+{
+    _filter.resize(phases * taps);
+
+    for (int p = 0; p < phases; ++p) {
+
+        std::vector<double> h(taps);
+        double sum = 0;
+
+        for (int t = 0; t < taps; ++t) {
+            // Distance of this tap from the output position, in input frames.
+            const double d = t - before - static_cast<double>(p) / phases;
+            const double x = M_PI * cutoff * d;
+            const double sinc = d ? std::sin(x) / x : 1.0;
+            // Blackman window over the filter span.
+            const double w = M_PI * d / (taps / 2);
+            const double window = 0.42 + 0.5 * std::cos(w) +
+                0.08 * std::cos(2 * w);
+            h[t] = sinc * std::max(0.0, window);
+            sum += h[t];
+        }
+
+        // Normalize each phase to unity gain, so that rounding doesn't
+        // make the output ripple at the phase rate.
+        std::int16_t* coeffs = &_filter[p * taps];
+        int total = 0;
+        int largest = 0;
+        for (int t = 0; t < taps; ++t) {
+            coeffs[t] = std::lround(h[t] / sum * (1 << coeffShift));
+            total += coeffs[t];
+            if (coeffs[t] > coeffs[largest]) largest = t;
+        }
+        coeffs[largest] += (1 << coeffShift) - total;
     }
-    else if (inc > 1)
-    {
-	// Downsample by skipping samples from the input
-	std::int16_t*	in = (std::int16_t*) data;
-	for (int i = output_sample_count; i > 0; i--)
-	{
-	    *out_data++ = *in;
-	    in += inc;
-	}
+}
+
+void
+AudioResampler::reset()
+{
+    // Start with silence before the first sample.
+    _input.assign(before * _channels, 0);
+    _pos = static_cast<std::uint64_t>(before) << 32;
+}
+
+size_t
+AudioResampler::maxOutputSamples(size_t inFrames) const
+{
+    if (_inRate == _outRate) return inFrames * 2;
+    return (static_cast<std::uint64_t>(inFrames) * _outRate / _inRate + 2) * 2;
+}
+
+size_t
+AudioResampler::process(const std::int16_t* in, size_t inFrames,
+        std::int16_t* out)
+{
+    if (_inRate == _outRate) {
+        if (_channels == 2) {
+            std::copy(in, in + inFrames * 2, out);
+        }
+        else {
+            for (size_t i = 0; i < inFrames; ++i) {
+                out[i * 2] = out[i * 2 + 1] = in[i];
+            }
+        }
+        return inFrames * 2;
     }
-    else if (dup > 1)
-    {
-	// Upsample by duplicating input samples in the output.
-
-	// The straight sample-replication code handles mono-to-stereo (sort of)
-	// and upsampling of mono but would make a botch of stereo-to-stereo
-	// upsampling, giving the left sample in both channels
-	// then the right sample in both channels alternately.
-	// So for stereo-stereo transforms we have a stereo routine.
-
-	std::int16_t*	in = (std::int16_t*) data;
-
-	if (stereo && m_stereo) {
-	    // Stereo-to-stereo upsampling: Replicate pairs of samples
-	    for (int i = output_sample_count / dup / 2; i > 0; i--)
-	    {
-		for (int j = dup; j > 0; j--)
-		{
-			out_data[0] = in[0];
-			out_data[1] = in[1];
-			out_data += 2;
-		}
-		in += 2;
-	    }
-	} else {
-
-	    // Linear upsampling, either to increase a sample rate
-	    // or to convert a mono file to stereo or both:
-	    // replicate each sample several times.
-	    switch (dup)
-	    {
-	    case 2:
-		for (int i = output_sample_count / dup; i > 0; i--)
-		{
-		    *out_data++ = *in;
-		    *out_data++ = *in;
-		    in++;
-		}
-		break;
-	    case 4:
-		for (int i = output_sample_count / dup; i > 0; i--)
-		{
-		    *out_data++ = *in;
-		    *out_data++ = *in;
-		    *out_data++ = *in;
-		    *out_data++ = *in;
-		    in++;
-		}
-		break;
-	    default:
-		for (int i = output_sample_count / dup; i > 0; i--)
-		{
-		    for (int j = dup; j > 0; j--)
-		    {
-			    *out_data++ = *in;
-		    }
-		    in++;
-		}
-		break;
-	    }
-	}
+
+    _input.insert(_input.end(), in, in + inFrames * _channels);
+
+    const size_t written = _channels == 2 ? filter<2>(out) : filter<1>(out);
+
+    // Keep what the next output frame still needs.
+    const size_t keep = static_cast<size_t>(_pos >> 32) - before;
+    _input.erase(_input.begin(), _input.begin() + keep * _channels);
+    _pos -= static_cast<std::uint64_t>(keep) << 32;
+
+    return written;
+}
+
+template<int Channels>
+size_t
+AudioResampler::filter(std::int16_t* out)
+{
+    const size_t frames = _input.size() / Channels;
+    const std::int32_t round = 1 << (coeffShift - 1);
+
+    std::int16_t* const start = out;
+
+    while ((_pos >> 32) + taps - before <= frames) {
+
+        const size_t i = _pos >> 32;
+        const int phase = (_pos >> (32 - phaseBits)) & (phases - 1);
+
+        const std::int16_t* h = &_filter[phase * taps];
+        const std::int16_t* x = &_input[(i - before) * Channels];
+
+        if (Channels == 2) {
+            std::int32_t left = round;
+            std::int32_t right = round;
+            for (int t = 0; t < taps; ++t) {
+                left += h[t] * x[t * 2];
+                right += h[t] * x[t * 2 + 1];
+            }
+            out[0] = clamp16(left >> coeffShift);
+            out[1] = clamp16(right >> coeffShift);
+        }
+        else {
+            std::int32_t acc = round;
+            for (int t = 0; t < taps; ++t) acc += h[t] * x[t];
+            out[0] = out[1] = clamp16(acc >> coeffShift);
+        }
+
+        out += 2;
+        _pos += _step;
     }
+
+    return out - start;
 }
 
 } // namespace media
@@ -159,5 +197,4 @@ AudioResampler::convert_raw_data(
 
 // Local Variables:
 // mode: C++
-// indent-tabs-mode: t
 // End:
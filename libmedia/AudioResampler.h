@@ -18,67 +18,84 @@
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 
-#ifndef __GNASH_UTIL_H
-#define __GNASH_UTIL_H
+#ifndef GNASH_AUDIORESAMPLER_H
+#define GNASH_AUDIORESAMPLER_H
 
+#include <vector>
 #include <cstdint> // for std::int16_t
+#include <cstddef>
+#include <boost/noncopyable.hpp>
 
 namespace gnash {
 namespace media {
 
+/// Streaming sample-rate converter to 16-bit stereo.
+//
+/// This is a polyphase windowed-sinc filter in fixed point. It keeps
+/// the end of each block to filter the start of the next one, so a
+/// sound converted block by block has no seams. The internal buffer
+/// is reused, so converting doesn't allocate once it has grown to the
+/// block size.
+///
+/// Input that is already at the output rate is copied, or duplicated
+/// to both channels if mono.
+class AudioResampler : boost::noncopyable
+{
+public:
 
-/// VERY crude audio resampler
-class AudioResampler {
+    /// @param inRate       The sample rate of the input.
+    /// @param inStereo     Whether the input is stereo.
+    /// @param outRate      The sample rate to convert to.
+    AudioResampler(int inRate, bool inStereo, int outRate = 44100);
 
-public:
+    /// The most samples process() can output for a given input.
+    //
+    /// @param inFrames     Number of input frames (a stereo pair is one).
+    /// @return             Number of 16-bit output samples (two per frame).
+    size_t maxOutputSamples(size_t inFrames) const;
+
+    /// Convert a block of samples.
+    //
+    /// @param in           The input samples, interleaved if stereo.
+    /// @param inFrames     Number of input frames (a stereo pair is one).
+    /// @param out          Where to write the stereo output. It must hold
+    ///                     maxOutputSamples(inFrames) samples.
+    /// @return             Number of 16-bit samples written.
+    size_t process(const std::int16_t* in, size_t inFrames,
+            std::int16_t* out);
+
+    /// Forget any input kept from previous blocks.
+    void reset();
+
+private:
+
+    void makeFilter(double cutoff);
 
-	/// VERY crude sample-rate and stereo conversion.
-	//
-	/// Converts input data to output format.
-	//
-	/// @param adjusted_data
-	/// Where the converted data is placed (output). WARNING: even though
-	/// the type of the output data is int16, the adjusted_size output
-	/// parameter is in bytes.
-	///
-	/// @param adjusted_size
-	/// The size of the converted data (output) in bytes.
-	///
-	/// @param data
-	/// Data that needs to be converted (input).
-	///
-	/// @param sample_count
-	/// The datas current sample count (input).
-	/// 
-	/// @param sample_size
-	/// The datas current sample size (input) in bytes.
-	///
-	/// @param sample_rate
-	/// The datas current sample rate (input).
-	///
-	/// @param stereo
-	/// Whether the current data is in stereo (input).
-	///
-	/// @param m_sample_rate
-	/// The samplerate we which to convert to (output).
-	///
-	/// @param m_stereo
-	/// Do we want the output data to be in stereo (output)?
-	static void convert_raw_data(std::int16_t** adjusted_data,
-		  int* adjusted_size, void* data, int sample_count,
-		  int sample_size, int sample_rate, bool stereo,
-		  int m_sample_rate, bool m_stereo);
+    template<int Channels>
+    size_t filter(std::int16_t* out);
+
+    const int _inRate;
+    const int _outRate;
+    const int _channels;
+
+    /// Input frames per output frame, in 32.32 fixed point.
+    const std::uint64_t _step;
+
+    /// Position of the next output frame in _input, in 32.32 fixed point.
+    std::uint64_t _pos;
+
+    /// Coefficients of each phase, in 2.14 fixed point.
+    std::vector<std::int16_t> _filter;
+
+    /// Input not consumed yet, including the history the filter needs.
+    std::vector<std::int16_t> _input;
 };
 
 } // namespace media
 } // namespace gnash
 
-#endif // __GNASH_UTIL_H
-
+#endif // GNASH_AUDIORESAMPLER_H
 
 // Local Variables:
 // mode: C++
-// c-basic-offset: 8 
-// tab-width: 8
-// indent-tabs-mode: t
 // End:
@@ -398,8 +398,7 @@ AudioDecoderFfmpeg::decode(const std::uint8_t* input,
         // Now, decode the frame. We use the ::decodeFrame specialized function
         // here so resampling is done appropriately
         std::uint32_t outSize = 0;
-        std::unique_ptr<std::uint8_t[]> outBuf(
-                decodeFrame(frame, framesize, outSize));
+        const std::uint8_t* outBuf = decodeFrame(frame, framesize, outSize);
 
         if (!outBuf)
         {
@@ -442,7 +441,7 @@ AudioDecoderFfmpeg::decode(const std::uint8_t* input,
             if ( retBufSize ) std::copy(tmp, tmp+retBufSize, retBuf);
             delete [] tmp;
         }
-        std::copy(outBuf.get(), outBuf.get()+outSize, retBuf+retBufSize);
+        std::copy(outBuf, outBuf+outSize, retBuf+retBufSize);
         retBufSize += static_cast<unsigned int>(outSize);
     }
 
@@ -456,10 +455,16 @@ std::uint8_t*
 AudioDecoderFfmpeg::decode(const EncodedAudioFrame& ef,
         std::uint32_t& outputSize)
 {
-    return decodeFrame(ef.data.get(), ef.dataSize, outputSize);
+    const std::uint8_t* frame =
+        decodeFrame(ef.data.get(), ef.dataSize, outputSize);
+    if (!frame) return nullptr;
+
+    std::uint8_t* ret = new std::uint8_t[outputSize];
+    std::copy(frame, frame + outputSize, ret);
+    return ret;
 }
 
-std::uint8_t*
+const std::uint8_t*
 AudioDecoderFfmpeg::decodeFrame(const std::uint8_t* input,
         std::uint32_t inputSize, std::uint32_t& outputSize)
 {
@@ -467,18 +472,7 @@ AudioDecoderFfmpeg::decodeFrame(const std::uint8_t* input,
 
     //assert(inputSize);
 	int plane_size;
-    size_t outSize = MAX_AUDIO_FRAME_SIZE;
-
-    // TODO: make this a private member, to reuse (see NetStreamFfmpeg in 0.8.3)
-    std::unique_ptr<std::int16_t, decltype(av_free)*> output(
-        reinterpret_cast<std::int16_t*>(av_malloc(outSize)), av_free );
-    if (!output.get()) {
-        log_error(_("failed to allocate audio buffer."));
-        outputSize = 0;
-        return nullptr;
-    }
-
-    std::int16_t* outPtr = output.get();
+    size_t outSize = 0;
 
 
 #ifdef GNASH_DEBUG_AUDIO_DECODING
@@ -530,30 +524,16 @@ AudioDecoderFfmpeg::decodeFrame(const std::uint8_t* input,
         int data_size = av_samples_get_buffer_size( &plane_size,
             _audioCodecCtx->channels, frm->nb_samples,
             _audioCodecCtx->sample_fmt, 1);
-        if (static_cast<int>(outSize) < data_size) {
-            log_error(_("output buffer size is too small for the current frame "
-                "(%d < %d)"), outSize, data_size);
+        if (data_size < 0) {
+            log_error(_("invalid audio frame size (%d)"), data_size);
             return nullptr;
         }
 
-        memcpy(outPtr, frm->extended_data[0], plane_size);
-
-#if !(defined(HAVE_SWRESAMPLE_H) || defined(HAVE_AVRESAMPLE_H))
-        int planar = av_sample_fmt_is_planar(_audioCodecCtx->sample_fmt);
-        if (planar && _audioCodecCtx->channels > 1) {
-            uint8_t *out = ((uint8_t *)outPtr) + plane_size;
-            for (int ch = 1; ch < _audioCodecCtx->channels; ch++) {
-                memcpy(out, frm->extended_data[ch], plane_size);
-                out += plane_size;
-            }
-        }
-#endif
-
         outSize = data_size;
 #ifdef GNASH_DEBUG_AUDIO_DECODING
-        log_debug(" decodeFrame | fmt: %d | fmt_name: %s | planar: %d | "
+        log_debug(" decodeFrame | fmt: %d | fmt_name: %s | "
             "plane_size: %d | outSize: %d",
-            _audioCodecCtx->sample_fmt, fmtname, planar, plane_size, outSize);
+            _audioCodecCtx->sample_fmt, fmtname, plane_size, outSize);
 #endif
     } else {
         if (tmp < 0)
@@ -586,16 +566,18 @@ AudioDecoderFfmpeg::decodeFrame(const std::uint8_t* input,
             inSamples = inSamples >> 1;
         }
 
-        // Compute total number of output samples
-        int expectedMaxOutSamples = std::ceil(inSamples*resampleFactor);
+        // Compute total number of output samples, allowing for the
+        // resampler's filter position to carry over between frames.
+        int expectedMaxOutSamples = std::ceil(inSamples*resampleFactor) + 2;
 
         // Compute output buffer size (in bytes); by multiplying
         // output samples count with output sample format's frame size,
         // which is number of bytes per sample (2) times channels (2).
         int resampledFrameSize = expectedMaxOutSamples*2*2;
 
-        // Allocate just the required amount of bytes
-        std::uint8_t* resampledOutput = new std::uint8_t[resampledFrameSize];
+        // The frame buffer is reused, so this only allocates while it grows.
+        _frameBuffer.resize(resampledFrameSize);
+        std::uint8_t* resampledOutput = _frameBuffer.data();
 
 #ifdef GNASH_DEBUG_AUDIO_DECODING
         log_debug(" decodeFrame | Calling the resampler, resampleFactor: %d | "
@@ -611,9 +593,6 @@ AudioDecoderFfmpeg::decodeFrame(const std::uint8_t* input,
             frm->nb_samples, // input
             &resampledOutput); // output
 
-        // make sure to set outPtr *after* we use it as input to the resampler
-        outPtr = reinterpret_cast<std::int16_t*>(resampledOutput);
-
 #ifdef GNASH_DEBUG_AUDIO_DECODING
         log_debug("resampler returned %d samples ", outSamples);
 #endif
@@ -642,13 +621,13 @@ AudioDecoderFfmpeg::decodeFrame(const std::uint8_t* input,
 
     }
     else {
-        std::uint8_t* newOutput = new std::uint8_t[outSize];
-        std::memcpy(newOutput, outPtr, outSize);
-        outPtr = reinterpret_cast<std::int16_t*>(newOutput);
+        // Already 44100 Hz interleaved 16-bit stereo.
+        _frameBuffer.assign(frm->extended_data[0],
+                frm->extended_data[0] + outSize);
     }
 
     outputSize = outSize;
-    return reinterpret_cast<uint8_t*>(outPtr);
+    return _frameBuffer.data();
 }
 
 int
@@ -22,6 +22,8 @@
 
 #include "ffmpegHeaders.h"
 
+#include <vector>
+
 #include "log.h"
 #include "AudioDecoder.h" // for inheritance
 #include "AudioResamplerFfmpeg.h" // for composition
@@ -68,9 +70,16 @@ private:
 	void setup(const AudioInfo& info);
 	void setup(SoundInfo& info);
 
-	std::uint8_t* decodeFrame(const std::uint8_t* input,
+	/// Decode a frame to 44100 Hz 16-bit stereo.
+	//
+	/// @return the decoded samples, valid until the next call,
+	///         or null on error.
+	const std::uint8_t* decodeFrame(const std::uint8_t* input,
             std::uint32_t inputSize, std::uint32_t& outputSize);
 
+	/// The samples of the last decoded frame, reused between frames.
+	std::vector<std::uint8_t> _frameBuffer;
+
 	AVCodec* _audioCodec;
 	AVCodecContext* _audioCodecCtx;
 	AVCodecParserContext* _parser;
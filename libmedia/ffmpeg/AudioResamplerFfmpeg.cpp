@@ -21,29 +21,65 @@
 #include "AudioResamplerFfmpeg.h"
 #include "utility.h"
 #include "log.h"
+#include "GnashNumeric.h"
 
 #include <cmath>
 #include <vector>
+#include <algorithm>
 
 namespace gnash {
 namespace media {
 namespace ffmpeg {
 
+namespace {
+
+#if !(defined(HAVE_SWRESAMPLE_H) || defined(HAVE_AVRESAMPLE_H))
+/// Convert one sample of any supported format to 16 bits.
+inline std::int16_t
+toS16(const std::uint8_t* plane, size_t i, AVSampleFormat fmt)
+{
+    switch (fmt) {
+        case AV_SAMPLE_FMT_S16:
+        case AV_SAMPLE_FMT_S16P:
+            return reinterpret_cast<const std::int16_t*>(plane)[i];
+        case AV_SAMPLE_FMT_S32:
+        case AV_SAMPLE_FMT_S32P:
+            return reinterpret_cast<const std::int32_t*>(plane)[i] >> 16;
+        case AV_SAMPLE_FMT_FLT:
+        case AV_SAMPLE_FMT_FLTP:
+        {
+            const float f = reinterpret_cast<const float*>(plane)[i];
+            return clamp<float>(f * 32768.0f, -32768.0f, 32767.0f);
+        }
+        default:
+            return 0;
+    }
+}
+#endif
+
+}
+
 AudioResamplerFfmpeg::AudioResamplerFfmpeg()
+#if defined(HAVE_SWRESAMPLE_H) || defined(HAVE_AVRESAMPLE_H)
 	:_context(nullptr)
+#else
+	:
+    _format(AV_SAMPLE_FMT_NONE),
+    _channels(0)
+#endif
 {
 }
 AudioResamplerFfmpeg::~AudioResamplerFfmpeg() {
+#if defined(HAVE_SWRESAMPLE_H) || defined(HAVE_AVRESAMPLE_H)
     if (_context) {
 #ifdef HAVE_SWRESAMPLE_H
         swr_free(&_context);
 #elif HAVE_AVRESAMPLE_H
         avresample_close(_context);
         avresample_free(&_context);
-#else
-        audio_resample_close(_context);
 #endif
     }
+#endif
 }
 
 bool
@@ -57,10 +93,10 @@ AudioResamplerFfmpeg::init(AVCodecContext* ctx) {
 #elif HAVE_AVRESAMPLE_H
             _context = avresample_alloc_context();
 #else
-            _context = av_audio_resample_init(2, ctx->channels,
-                44100, ctx->sample_rate,
-                AV_SAMPLE_FMT_S16, ctx->sample_fmt,
-                16, 10, 0, 0.8);
+            _context.reset(new AudioResampler(ctx->sample_rate,
+                        ctx->channels > 1));
+            _format = ctx->sample_fmt;
+            _channels = ctx->channels;
 #endif
 #if defined(HAVE_SWRESAMPLE_H) || defined(HAVE_AVRESAMPLE_H)
             av_opt_set_int(_context, "in_channel_layout",
@@ -95,8 +131,35 @@ AudioResamplerFfmpeg::resample(std::uint8_t** input, int plane_size,
         output, 0, MAX_AUDIO_FRAME_SIZE,
         input, plane_size, samples);
 #else
-    return audio_resample(_context, reinterpret_cast<short*>(*output),
-        reinterpret_cast<short*>(*input), samples); 
+    switch (_format) {
+        case AV_SAMPLE_FMT_S16:
+        case AV_SAMPLE_FMT_S16P:
+        case AV_SAMPLE_FMT_S32:
+        case AV_SAMPLE_FMT_S32P:
+        case AV_SAMPLE_FMT_FLT:
+        case AV_SAMPLE_FMT_FLTP:
+            break;
+        default:
+            log_error(_("Unsupported audio sample format %d"), _format);
+            return 0;
+    }
+
+    // Only the first two channels are kept.
+    const int used = std::min(_channels, 2);
+    const bool planar = av_sample_fmt_is_planar(_format);
+
+    _interleaved.resize(samples * used);
+    std::int16_t* to = _interleaved.data();
+    for (int i = 0; i < samples; ++i) {
+        for (int ch = 0; ch < used; ++ch) {
+            *to++ = planar ? toS16(input[ch], i, _format) :
+                toS16(input[0], i * _channels + ch, _format);
+        }
+    }
+
+    const size_t written = _context->process(_interleaved.data(), samples,
+            reinterpret_cast<std::int16_t*>(*output));
+    return written / 2;
 #endif
 }
 
@@ -27,6 +27,12 @@
 
 #include <cstdint>
 
+#if !(defined(HAVE_SWRESAMPLE_H) || defined(HAVE_AVRESAMPLE_H))
+#include <memory>
+#include <vector>
+#include "AudioResampler.h"
+#endif
+
 namespace gnash {
 namespace media {
 namespace ffmpeg {
@@ -34,6 +40,8 @@ namespace ffmpeg {
 /// FFMPEG based AudioResampler
 //
 /// This class is used to provide an easy interface to libavcodecs audio resampler.
+/// When neither libswresample nor libavresample is available, Gnash's own
+/// AudioResampler is used instead.
 ///
 class AudioResamplerFfmpeg
 {
@@ -77,7 +85,14 @@ private:
 #elif HAVE_AVRESAMPLE_H
     AVAudioResampleContext* _context;
 #else
-    ReSampleContext* _context;
+    std::unique_ptr<AudioResampler> _context;
+
+    /// The input format, which is converted to interleaved 16-bit samples.
+    AVSampleFormat _format;
+    int _channels;
+
+    /// Interleaved input for _context, reused between frames.
+    std::vector<std::int16_t> _interleaved;
 #endif
 };
 
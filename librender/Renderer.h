@@ -153,6 +153,7 @@
 #include "log.h"
 #include "snappingrange.h"
 #include "SWFRect.h"
+#include "GnashImage.h"
 
 // Forward declarations.
 namespace gnash {
@@ -172,9 +173,6 @@ namespace gnash {
     namespace SWF {
         class ShapeRecord;
     }
-    namespace image {
-        class GnashImage;
-    }
 }
 
 namespace gnash {
@@ -221,6 +219,16 @@ public:
     virtual CachedBitmap *
         createCachedBitmap(std::unique_ptr<image::GnashImage> im) = 0;
 
+    /// Create a CachedBitmap for an image that will never be changed.
+    //
+    /// This is used for bitmaps from SWF definitions and image files.
+    /// Renderers may store these in their own pixel format; image() may
+    /// then return a copy that has lost precision.
+    virtual CachedBitmap*
+        createStaticBitmap(std::unique_ptr<image::GnashImage> im) {
+        return createCachedBitmap(std::move(im));
+    }
+
 
     /// ==================================================================
     /// Rendering Interface.
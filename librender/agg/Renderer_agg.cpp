@@ -115,6 +115,11 @@ AGG resources
 #include <math.h> // We use round()!
 #include <climits>
 #include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdlib>
+#include <type_traits>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-parameter"
@@ -157,6 +162,7 @@ AGG resources
 #include "FillStyle.h"
 #include "Transform.h"
 #include "IOChannel.h"
+#include "rc.h"
 
 #ifdef HAVE_VA_VA_H
 #include "GnashVaapiImage.h"
@@ -164,6 +170,7 @@ AGG resources
 #endif
 
 #include "Renderer_agg_bitmap.h"
+#include "Renderer_agg_glyphs.h"
 
 // Print a debugging warning when rendering of a whole character
 // is skipped 
@@ -172,6 +179,7 @@ AGG resources
 
 #include <boost/numeric/conversion/converter.hpp>
 #include <boost/ptr_container/ptr_vector.hpp>
+#include <boost/noncopyable.hpp>
 
 namespace gnash {
 
@@ -183,6 +191,19 @@ typedef std::vector<agg::path_storage> AggPaths;
 typedef std::vector<geometry::Range2d<int> > ClipBounds;
 typedef boost::ptr_vector<AlphaMask> AlphaMasks;
 typedef std::vector<Path> GnashPaths;
+typedef std::function<void(StyleHandler&)> StyleBuilder;
+
+/// Shapes covering fewer pixels than this are rasterized in one piece.
+const int minParallelPixels = 128 * 128;
+
+/// The minimum height of a band rasterized by one thread.
+const int minBandRows = 16;
+
+/// Bytes of glyph coverage kept for reuse.
+const size_t glyphCacheBytes = 1024 * 1024;
+
+/// The quality shape fills are drawn with.
+const Quality fillQuality = QUALITY_LOW;
 
 // Note: this is here in case ::round doesn't exist. However, it's not
 // advisable to check using ifdefs (as previously), because ::round is
@@ -204,6 +225,126 @@ inline void applyClipBox(Rasterizer& ras, const geometry::Range2d<int>& bounds)
             );  
 }
 
+/// Whether bitmaps can be stored in the pixel format of a framebuffer.
+template<typename PixelFormat>
+struct NativeBitmaps : std::false_type {};
+
+template<>
+struct NativeBitmaps<agg::pixfmt_rgb565_pre> : std::true_type {};
+
+/// Find the pixels covered by paths that form a single rectangle.
+//
+/// @param paths    Paths in TWIPS, as from apply_matrix_to_path().
+/// @param rect     Receives the pixels inside the rectangle.
+/// @return         false unless the paths are a single rectangle with
+///                 its sides on pixel boundaries.
+bool
+pixelRectangle(const GnashPaths& paths, geometry::Range2d<int>& rect)
+{
+    if (paths.size() != 1) return false;
+
+    const Path& path = paths.front();
+    if (path.m_edges.size() != 4 || !path.isClosed()) return false;
+
+    point prev = path.ap;
+    for (const Edge& e : path.m_edges) {
+        if (!e.straight()) return false;
+        if (e.ap.x != prev.x && e.ap.y != prev.y) return false;
+        prev = e.ap;
+    }
+
+    std::int32_t x0 = prev.x, x1 = prev.x, y0 = prev.y, y1 = prev.y;
+    for (const Edge& e : path.m_edges) {
+        x0 = std::min(x0, e.ap.x);
+        x1 = std::max(x1, e.ap.x);
+        y0 = std::min(y0, e.ap.y);
+        y1 = std::max(y1, e.ap.y);
+    }
+    if (x0 == x1 || y0 == y1) return false;
+
+    // Axis-aligned sides through all four corners make a rectangle.
+    unsigned corners = 0;
+    for (const Edge& e : path.m_edges) {
+        if ((e.ap.x != x0 && e.ap.x != x1) || (e.ap.y != y0 && e.ap.y != y1)) {
+            return false;
+        }
+        corners |= 1 << ((e.ap.x == x1) + (e.ap.y == y1) * 2);
+    }
+    if (corners != 0xf) return false;
+
+    if (x0 % 20 || x1 % 20 || y0 % 20 || y1 % 20) return false;
+
+    rect.setTo(x0 / 20, y0 / 20, x1 / 20 - 1, y1 / 20 - 1);
+    return true;
+}
+
+/// Find the whole number a bitmap is scaled up by along one axis.
+//
+/// @param scale    The 16.16 fixed point scale from stage pixels to
+///                 bitmap pixels.
+/// @param extent   The number of stage pixels drawn along the axis.
+/// @return         The factor, or 0 if the scale is not close enough to
+///                 a whole number for the bitmap to be drawn by repeating
+///                 pixels.
+int
+pixelFactor(std::int32_t scale, int extent)
+{
+    if (scale <= 0) return 0;
+
+    const double s = scale / 65536.0;
+    const long k = std::lround(1 / s);
+    if (k < 1) return 0;
+
+    // The error must stay well under a pixel across the drawn area.
+    if (std::abs(s - 1.0 / k) * extent > 0.25) return 0;
+    return k;
+}
+
+/// Find the stage pixel where a bitmap's first pixel lands along one axis.
+//
+/// The arguments are the scale and translation of the fill, shape and
+/// stage matrices along the axis. The position is computed in floating
+/// point, as translations of concatenated matrices are rounded to whole
+/// bitmap pixels.
+//
+/// @return         false if the position is not on a whole stage pixel.
+bool
+pixelOffset(std::int32_t fillScale, std::int32_t fillOffset,
+        std::int32_t shapeScale, std::int32_t shapeOffset,
+        std::int32_t stageScale, std::int32_t stageOffset, int& offset)
+{
+    if (!fillScale) return false;
+
+    const double shape = -fillOffset * 65536.0 / fillScale;
+    const double world = shape * shapeScale / 65536.0 + shapeOffset;
+    const double stage = world * stageScale / 65536.0 + stageOffset;
+
+    // Leave room for the precision lost by the fixed point fill matrix.
+    const long p = std::lround(stage);
+    if (std::abs(stage - p) > 0.125) return false;
+
+    offset = p;
+    return true;
+}
+
+/// Find the stage pixel where the top left corner of a bitmap fill lands.
+//
+/// @return         false if any of the matrices rotates or skews, or the
+///                 corner is not on a whole stage pixel.
+bool
+pixelOrigin(const SWFMatrix& fill, const SWFMatrix& shape,
+        const SWFMatrix& stage, int& x, int& y)
+{
+    if (fill.b() || fill.c() || shape.b() || shape.c() ||
+            stage.b() || stage.c()) {
+        return false;
+    }
+    return pixelOffset(fill.a(), fill.tx(), shape.a(), shape.tx(),
+                stage.a(), stage.tx(), x) &&
+           pixelOffset(fill.d(), fill.ty(), shape.d(), shape.ty(),
+                stage.d(), stage.ty(), y);
+}
+
 /// Analyzes a set of paths to detect real presence of fills and/or outlines
 /// TODO: This should be something the character tells us and should be 
 /// cached. 
@@ -391,6 +532,169 @@ private:
     
 };
 
+/// Reads an agg::path_storage without using its internal iterator.
+//
+/// Several threads can read the same path through their own readers.
+class PathReader
+{
+public:
+    explicit PathReader(const agg::path_storage& path)
+        :
+        _path(path),
+        _pos(0)
+    {}
+
+    void rewind(unsigned pathId) {
+        _pos = pathId;
+    }
+
+    unsigned vertex(double* x, double* y) {
+        if (_pos >= _path.total_vertices()) return agg::path_cmd_stop;
+        return _path.vertex(_pos++, x, y);
+    }
+
+private:
+    const agg::path_storage& _path;
+    unsigned _pos;
+};
+
+/// Threads that rasterize horizontal bands of the frame buffer.
+//
+/// The thread calling run() works on the bands too, so a pool of
+/// size n has n - 1 threads of its own.
+class BandWorkers : boost::noncopyable
+{
+public:
+
+    typedef std::function<void(size_t)> Job;
+
+    explicit BandWorkers(size_t threads)
+        :
+        _job(nullptr),
+        _jobs(0),
+        _next(0),
+        _pending(0),
+        _generation(0),
+        _quit(false)
+    {
+        for (size_t i = 1; i < threads; ++i) {
+            _threads.emplace_back(&BandWorkers::work, this);
+        }
+    }
+
+    ~BandWorkers()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _quit = true;
+        }
+        _wake.notify_all();
+        for (std::thread& t : _threads) t.join();
+    }
+
+    size_t size() const {
+        return _threads.size() + 1;
+    }
+
+    /// Call job(i) for each i in [0, jobs) and wait for all to finish.
+    void run(size_t jobs, const Job& job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _job = &job;
+            _jobs = jobs;
+            _next = 0;
+            _pending = jobs;
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        runJobs();
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return !_pending; });
+        _job = nullptr;
+    }
+
+private:
+
+    void runJobs()
+    {
+        for (;;) {
+            const Job* job;
+            size_t i;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_job || _next == _jobs) return;
+                job = _job;
+                i = _next++;
+            }
+
+            (*job)(i);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!--_pending) _done.notify_all();
+        }
+    }
+
+    void work()
+    {
+        size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [&] {
+                    return _quit || _generation != seen;
+                });
+                if (_quit) return;
+                seen = _generation;
+            }
+            runJobs();
+        }
+    }
+
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+
+    const Job* _job;
+    size_t _jobs;
+    size_t _next;
+    size_t _pending;
+    size_t _generation;
+    bool _quit;
+};
+
+/// Create a scanline for drawing in a band without a mask.
+inline void
+makeScanline(std::unique_ptr<agg::scanline_u8>& sl, const AlphaMasks&)
+{
+    sl.reset(new agg::scanline_u8);
+}
+
+/// Create a scanline for drawing in a band through the current mask.
+inline void
+makeScanline(std::unique_ptr<agg::scanline_u8_am<agg::alpha_mask_gray8> >& sl,
+        const AlphaMasks& masks)
+{
+    sl.reset(new agg::scanline_u8_am<agg::alpha_mask_gray8>(
+                masks.back().getMask()));
+}
+
+/// The number of threads to rasterize with.
+//
+/// This is GNASH_AGG_THREADS if set, otherwise the number of cores up to
+/// four. One means no extra threads.
+size_t
+rasterThreads()
+{
+    const char* env = std::getenv("GNASH_AGG_THREADS");
+    if (env) return std::strtoul(env, nullptr, 0);
+    return std::min(4u, std::thread::hardware_concurrency());
+}
+
 /// Class for rendering lines.
 template<typename PixelFormat>
 class LineRenderer
@@ -686,6 +990,18 @@ public:
         return new agg_bitmap_info(std::move(im));
     }
 
+    // Opaque bitmaps are stored in the framebuffer's pixel format if
+    // it is RGB565, so that blit_bitmap() can copy them.
+    gnash::CachedBitmap* createStaticBitmap(std::unique_ptr<image::GnashImage> im)
+    {
+        if (NativeBitmaps<PixelFormat>::value &&
+                RcInitFile::getDefaultInstance().useNativeBitmaps()) {
+            agg_bitmap_info* bi = agg_bitmap_info::createRGB565(*im);
+            if (bi) return bi;
+        }
+        return createCachedBitmap(std::move(im));
+    }
+
     virtual void renderToImage(std::unique_ptr<IOChannel> io,
             FileType type, int quality) const
     {
@@ -803,8 +1119,12 @@ public:
       yres(1),
       bpp(bits_per_pixel),
       scale_set(false),
-      m_drawing_mask(false)
+      m_drawing_mask(false),
+      _glyphCache(glyphCacheBytes)
   {
+    const size_t threads = rasterThreads();
+    if (threads > 1) _bandWorkers.reset(new BandWorkers(threads));
+
     // TODO: we really don't want to set the scale here as the core should
     // tell us the right values before rendering anything. However this is
     // currently difficult to implement. Removing the next call will
@@ -1029,6 +1349,12 @@ public:
     select_clipbounds(shape.getBounds(), mat);
     
     if (_clipbounds_selected.empty()) return; 
+
+    if (!m_drawing_mask && _alphaMasks.empty() &&
+            draw_cached_glyph(shape, color, mat)) {
+        _clipbounds_selected.clear();
+        return;
+    }
       
     GnashPaths paths;
     apply_matrix_to_path(shape.subshapes().front().paths(), paths, mat);
@@ -1046,10 +1372,11 @@ public:
     std::vector<FillStyle> v(1, FillStyle(SolidFill(color)));
 
     // prepare style handler
-    StyleHandler sh;
-    build_agg_styles(sh, v, mat, SWFCxForm());
+    const StyleBuilder styles = [&](StyleHandler& sh) {
+        build_agg_styles(sh, v, mat, SWFCxForm());
+    };
     
-    draw_shape(paths, agg_paths, sh, false);
+    draw_shape(paths, agg_paths, styles, false);
     
     // NOTE: Do not use even-odd filling rule for glyphs!
     
@@ -1058,6 +1385,152 @@ public:
   }
 
 
+  /// Draw a glyph from the glyph cache, rasterizing it if needed.
+  //
+  /// Only glyphs that are not rotated or skewed on the stage are cached,
+  /// keyed by scale and quarter-pixel position. The coverage is
+  /// independent of the color, which is applied when blending.
+  //
+  /// @return   false if the glyph can't be cached; it must then be drawn
+  ///           normally.
+  bool draw_cached_glyph(const SWF::ShapeRecord& shape, const rgba& color,
+          const SWFMatrix& mat)
+  {
+    // From glyph units to 1/20 pixel, as in apply_matrix_to_path().
+    SWFMatrix full;
+    full.concatenate_scale(20.0, 20.0);
+    full.concatenate(stage_matrix);
+    full.concatenate(mat);
+
+    if (full.b() || full.c()) return false;
+
+    // Nearby scales share masks; the difference is well under a pixel
+    // for any glyph small enough to be cached.
+    const auto bucket = [](std::int32_t v) {
+        const int step = std::max(1, std::abs(v) >> 7);
+        return static_cast<std::int32_t>(std::lround(
+                    static_cast<double>(v) / step)) * step;
+    };
+
+    GlyphKey key;
+    key.shape = &shape;
+    key.xScale = bucket(full.a());
+    key.yScale = bucket(full.d());
+    if (!key.xScale || !key.yScale) return false;
+
+    // Split the translation into whole pixels and quarter pixels.
+    const auto split = [](std::int32_t t, int& whole, std::uint8_t& sub) {
+        whole = (t >= 0 ? t : t - 19) / 20;
+        const int q = ((t - whole * 20) * 4 + 10) / 20;
+        if (q == 4) ++whole;
+        sub = q % 4;
+    };
+
+    int ox, oy;
+    split(full.tx(), ox, key.subX);
+    split(full.ty(), oy, key.subY);
+
+    const std::uint64_t fp = shape.fingerprint();
+    const GlyphMask* mask = _glyphCache.find(key, fp);
+
+    if (!mask) {
+      GlyphMask m;
+      if (!rasterize_glyph(shape, key, m)) return false;
+      m.fingerprint = fp;
+      mask = &_glyphCache.insert(key, std::move(m));
+    }
+
+    const agg::rgba8 c = agg::rgba8_pre(color.m_r, color.m_g, color.m_b,
+            color.m_a);
+
+    const int gx = ox + mask->x;
+    const int gy = oy + mask->y;
+
+    for (const geometry::Range2d<int>* bounds : _clipbounds_selected) {
+
+      const int x0 = std::max(gx, bounds->getMinX());
+      const int x1 = std::min(gx + mask->width - 1, bounds->getMaxX());
+      const int y0 = std::max(gy, bounds->getMinY());
+      const int y1 = std::min(gy + mask->height - 1, bounds->getMaxY());
+      if (x0 > x1) continue;
+
+      for (int y = y0; y <= y1; ++y) {
+        const std::uint8_t* covers =
+            &mask->covers[(y - gy) * mask->width + (x0 - gx)];
+        m_rbase->blend_solid_hspan(x0, y, x1 - x0 + 1, c, covers);
+      }
+    }
+    return true;
+  }
+
+  /// Rasterize the coverage of a glyph for the glyph cache.
+  //
+  /// @return   false if the glyph is too large to be worth caching.
+  bool rasterize_glyph(const SWF::ShapeRecord& shape, const GlyphKey& key,
+          GlyphMask& mask)
+  {
+    SWFMatrix local(key.xScale, 0, 0, key.yScale, key.subX * 5,
+            key.subY * 5);
+
+    SWFRect bounds;
+    bounds.set_null();
+    bounds.expand_to_transformed_rect(local, shape.getBounds());
+    if (bounds.is_null()) return false;
+
+    // Leave a pixel for antialiasing on each side.
+    mask.x = static_cast<int>(std::floor(bounds.get_x_min() / 20.0)) - 1;
+    mask.y = static_cast<int>(std::floor(bounds.get_y_min() / 20.0)) - 1;
+    mask.width = static_cast<int>(std::ceil(bounds.get_x_max() / 20.0)) + 2 -
+        mask.x;
+    mask.height = static_cast<int>(std::ceil(bounds.get_y_max() / 20.0)) + 2 -
+        mask.y;
+
+    if (!_glyphCache.fits(mask.width * mask.height)) return false;
+
+    local.set_translation(key.subX * 5 - mask.x * 20,
+            key.subY * 5 - mask.y * 20);
+
+    GnashPaths paths = shape.subshapes().front().paths();
+    for (Path& p : paths) p.transform(local);
+
+    AggPaths agg_paths;
+    buildPaths(agg_paths, paths);
+
+    // Draw in opaque white; the alpha is the coverage.
+    std::vector<std::uint8_t> pixels(mask.width * mask.height * 4);
+    agg::rendering_buffer buf(pixels.data(), mask.width, mask.height,
+            mask.width * 4);
+    agg::pixfmt_rgba32_pre pixf(buf);
+    agg::renderer_base<agg::pixfmt_rgba32_pre> rbase(pixf);
+
+    std::vector<FillStyle> v(1, FillStyle(SolidFill(rgba(255, 255, 255, 255))));
+    StyleHandler sh;
+    build_agg_styles(sh, v, SWFMatrix(), SWFCxForm());
+
+    agg::rasterizer_compound_aa<agg::rasterizer_sl_clip_int> rasc;
+    agg::scanline_u8 sl;
+    agg::span_allocator<agg::rgba8> alloc;
+
+    // NOTE: Do not use even-odd filling rule for glyphs!
+    rasc.filling_rule(agg::fill_non_zero);
+
+    for (size_t pno = 0; pno < paths.size(); ++pno) {
+      const Path& p = paths[pno];
+      if (!p.m_fill0 && !p.m_fill1) continue;
+      PathReader reader(agg_paths[pno]);
+      agg::conv_curve<PathReader> curve(reader);
+      rasc.styles(p.m_fill0 - 1, p.m_fill1 - 1);
+      rasc.add_path(curve);
+    }
+    agg::render_scanlines_compound_layered(rasc, sl, rbase, alloc, sh);
+
+    mask.covers.resize(mask.width * mask.height);
+    for (size_t i = 0; i < mask.covers.size(); ++i) {
+      mask.covers[i] = pixels[i * 4 + agg::order_rgba::A];
+    }
+    return true;
+  }
+
   /// Fills _clipbounds_selected with pointers to _clipbounds members who
   /// intersect with the given character (transformed by mat). This avoids
   /// rendering of characters outside a particular clipping range.
@@ -1071,6 +1544,7 @@ public:
   
     _clipbounds_selected.clear();
     _clipbounds_selected.reserve(_clipbounds.size());
+    _selectedRange.setNull();
 
     if (objectBounds.is_null()) {
       log_debug("Warning: select_clipbounds encountered a character "
@@ -1083,6 +1557,8 @@ public:
     bounds.expand_to_transformed_rect(mat, objectBounds);
     
     //assert(bounds.getRange().isFinite());
+
+    _selectedRange = bounds.getRange();
     
     for (const auto& clip : _clipbounds) {
 
@@ -1094,6 +1570,9 @@ public:
   
   void select_all_clipbounds() {
   
+    // Nothing is known about the extent of what is drawn.
+    _selectedRange.setNull();
+
     if (_clipbounds_selected.size() == _clipbounds.size()) return; 
   
     _clipbounds_selected.clear();
@@ -1160,6 +1639,12 @@ public:
             return;
         }
 
+        if (!have_outline && _alphaMasks.empty() &&
+                blit_bitmap(FillStyles, paths, mat, cx)) {
+            _clipbounds_selected.clear();
+            return;
+        }
+
         AggPaths agg_paths;    
         AggPaths agg_paths_rounded;    
 
@@ -1182,12 +1667,12 @@ public:
         }
 
         // prepare fill styles
-        StyleHandler sh;
-        if (have_shape) build_agg_styles(sh, FillStyles, mat, cx);
-
+        const StyleBuilder styles = [&](StyleHandler& sh) {
+            build_agg_styles(sh, FillStyles, mat, cx);
+        };
 
             if (have_shape) {
-                draw_shape(paths, agg_paths, sh, true);        
+                draw_shape(paths, agg_paths, styles, true);        
             }
             if (have_outline)            {
                 draw_outlines(paths, agg_paths_rounded,
@@ -1198,6 +1683,92 @@ public:
         _clipbounds_selected.clear();
     }
 
+    /// Copy a bitmap in the framebuffer's pixel format straight to it.
+    //
+    /// This handles the usual way of drawing a bitmap: a rectangle filled
+    /// with it, neither rotated nor color transformed, at a whole pixel
+    /// position and at its own size or scaled up by a whole number. Its
+    /// pixels are copied or repeated instead of being rasterized and
+    /// sampled. A bitmap that would be smoothed is only copied at its own
+    /// size. The edges of the rectangle get no anti-aliasing.
+    //
+    /// @return     false if the shape can't be drawn this way.
+    bool blit_bitmap(const std::vector<FillStyle>& fillStyles,
+            const GnashPaths& paths, const SWFMatrix& mat,
+            const SWFCxForm& cx)
+    {
+        if (!NativeBitmaps<PixelFormat>::value) return false;
+        if (cx != SWFCxForm()) return false;
+
+        geometry::Range2d<int> rect;
+        if (!pixelRectangle(paths, rect)) return false;
+
+        const Path& path = paths.front();
+        if (path.m_fill0 && path.m_fill1) return false;
+        const unsigned fill = path.m_fill0 + path.m_fill1;
+        if (!fill || fill > fillStyles.size()) return false;
+
+        const BitmapFill* f = boost::get<BitmapFill>(&fillStyles[fill - 1].fill);
+        if (!f) return false;
+
+        const agg_bitmap_info* bi =
+            dynamic_cast<const agg_bitmap_info*>(f->bitmap());
+        if (!bi || bi->disposed() || bi->get_bpp() != 16) return false;
+
+        // From stage pixels to bitmap pixels, as in AddStyles.
+        SWFMatrix m = f->matrix();
+        m.concatenate(SWFMatrix(mat).invert());
+        m.concatenate(SWFMatrix(stage_matrix).invert());
+        if (m.b() || m.c()) return false;
+
+        const int kx = pixelFactor(m.a(), rect.width() + 1);
+        const int ky = pixelFactor(m.d(), rect.height() + 1);
+        if (!kx || !ky) return false;
+
+        // Repeating pixels is only right without smoothing.
+        if ((kx > 1 || ky > 1) && smoothBitmap(*f, fillQuality)) return false;
+
+        // The stage pixels covered by the bitmap. The translation of m is
+        // rounded to bitmap pixels, so find it from the other direction.
+        int bx, by;
+        if (!pixelOrigin(f->matrix(), mat, stage_matrix, bx, by)) return false;
+        const geometry::Range2d<int> area(bx, by,
+                bx + kx * bi->get_width() - 1, by + ky * bi->get_height() - 1);
+        if (!area.contains(rect)) return false;
+
+        const geometry::Range2d<int> buffer(0, 0, xres - 1, yres - 1);
+        rect = geometry::Intersection(rect, buffer);
+
+        const std::uint8_t* data = bi->get_data();
+        const int rowlen = bi->get_rowlen();
+
+        for (const geometry::Range2d<int>* bounds : _clipbounds_selected) {
+
+            const geometry::Range2d<int> r = geometry::Intersection(rect,
+                    *bounds);
+            if (r.isNull()) continue;
+
+            for (int y = r.getMinY(); y <= r.getMaxY(); ++y) {
+                const std::uint16_t* from =
+                    reinterpret_cast<const std::uint16_t*>(data +
+                            rowlen * ((y - by) / ky));
+                std::uint16_t* to =
+                    reinterpret_cast<std::uint16_t*>(m_rbuf.row_ptr(y)) +
+                    r.getMinX();
+
+                if (kx == 1) {
+                    std::copy(from + r.getMinX() - bx,
+                            from + r.getMaxX() - bx + 1, to);
+                    continue;
+                }
+                for (int x = r.getMinX(); x <= r.getMaxX(); ++x) {
+                    *to++ = from[(x - bx) / kx];
+                }
+            }
+        }
+        return true;
+    }
+
     /// Takes a path and translates it using the given SWFMatrix. The new path
     /// is stored in paths_out. Both paths_in and paths_out are expected to
     /// be in TWIPS.
@@ -1386,7 +1957,7 @@ public:
 
         for (size_t fno = 0; fno < fcount; ++fno) {
             const AddStyles st(stage_matrix, fillstyle_matrix, cx, sh,
-                    QUALITY_LOW);
+                    fillQuality);
             boost::apply_visitor(st, FillStyles[fno].fill);
         } 
     } 
@@ -1409,7 +1980,7 @@ public:
   ///
   void draw_shape(const GnashPaths &paths,
     const AggPaths& agg_paths,  
-    StyleHandler& sh, bool even_odd) {
+    const StyleBuilder& styles, bool even_odd) {
     
     if (_alphaMasks.empty()) {
     
@@ -1420,7 +1991,7 @@ public:
       scanline_type sl;
       
       draw_shape_impl<scanline_type> (paths, agg_paths, 
-        sh, even_odd, sl);
+        styles, even_odd, sl);
         
     } else {
     
@@ -1431,7 +2002,7 @@ public:
       scanline_type sl(_alphaMasks.back().getMask());
       
       draw_shape_impl<scanline_type> (paths, agg_paths, 
-        sh, even_odd, sl);
+        styles, even_odd, sl);
         
     }
     
@@ -1440,10 +2011,12 @@ public:
   /// Template for draw_shape(). Two different scanline types are suppored, 
   /// one with and one without an alpha mask. This makes drawing without masks
   /// much faster.  
+  //
+  /// Large shapes are split into horizontal bands rasterized in parallel.
   template <class scanline_type>
   void draw_shape_impl(const GnashPaths &paths,
     const AggPaths& agg_paths,
-    StyleHandler& sh, bool even_odd, scanline_type& sl) {
+    const StyleBuilder& styles, bool even_odd, scanline_type& sl) {
     /*
     Fortunately, AGG provides a rasterizer that fits perfectly to the flash
     data model. So we just have to feed AGG with all data and we're done. :-)
@@ -1459,59 +2032,175 @@ public:
     
     if ( _clipbounds.empty() ) return;
 
-    // Target renderer
-    renderer_base& rbase = *m_rbase;
-
     typedef agg::rasterizer_compound_aa<agg::rasterizer_sl_clip_int> ras_type;
     ras_type rasc;  // flash-like renderer
 
-    agg::renderer_scanline_aa_solid<
-      agg::renderer_base<PixelFormat> > ren_sl(rbase); // solid fills
-    agg::span_allocator<agg::rgba8> alloc;  // span allocator (?)
+    // Built on first use, as all bounds may be split into bands.
+    std::unique_ptr<StyleHandler> sh;
+
+    ClipBounds bands;
+
+    for (const geometry::Range2d<int>* bounds : _clipbounds_selected) {
+
+      // Only the anti-aliased edges are drawn outside the bounds.
+      if (split_bands(*bounds, 1, bands)) {
+
+        // Styles keep span generator state, so each band needs its own.
+        // They are built here because building them may load shared
+        // resources such as bitmaps.
+        std::vector<std::unique_ptr<StyleHandler> > bandStyles(bands.size());
+        for (std::unique_ptr<StyleHandler>& bs : bandStyles) {
+          bs.reset(new StyleHandler);
+          styles(*bs);
+        }
+
+        _bandWorkers->run(bands.size(), [&](size_t i) {
+          ras_type bandRas;
+          std::unique_ptr<scanline_type> bandSl;
+          makeScanline(bandSl, _alphaMasks);
+          fill_band(bandRas, bands[i], paths, agg_paths, *bandStyles[i],
+                  even_odd, *bandSl);
+        });
+        continue;
+      }
+
+      if (!sh) {
+        sh.reset(new StyleHandler);
+        styles(*sh);
+      }
+      fill_band(rasc, *bounds, paths, agg_paths, *sh, even_odd, sl);
+    }
     
+  } // draw_shape_impl
+
+  /// Rasterize the fills of a shape within one clipping rectangle.
+  //
+  /// This is called from several threads at once for different bands,
+  /// so must not modify anything shared.
+  template <class ras_type, class scanline_type>
+  void fill_band(ras_type& rasc, const geometry::Range2d<int>& bounds,
+    const GnashPaths &paths, const AggPaths& agg_paths, StyleHandler& sh,
+    bool even_odd, scanline_type& sl) const {
+
+    // Target renderer
+    renderer_base& rbase = *m_rbase;
+
+    agg::span_allocator<agg::rgba8> alloc;  // span allocator (?)
 
     // activate even-odd filling rule
     if (even_odd)
       rasc.filling_rule(agg::fill_even_odd);
     else
       rasc.filling_rule(agg::fill_non_zero);
-      
-    
-    for (const geometry::Range2d<int>* bounds : _clipbounds_selected) {
 
-      applyClipBox<ras_type> (rasc, *bounds);
+    applyClipBox<ras_type> (rasc, bounds);
       
-      // push paths to AGG
-      const size_t pcount = paths.size();
+    // push paths to AGG
+    const size_t pcount = paths.size();
   
-      for (size_t pno=0; pno<pcount; ++pno) {
+    for (size_t pno=0; pno<pcount; ++pno) {
           
-        const Path &this_path_gnash = paths[pno];
-        agg::path_storage &this_path_agg = 
-          const_cast<agg::path_storage&>(agg_paths[pno]);
-        
-        agg::conv_curve<agg::path_storage> curve(this_path_agg);        
+      const Path &this_path_gnash = paths[pno];
 
-        if ((this_path_gnash.m_fill0==0) && (this_path_gnash.m_fill1==0)) {
-          // Skip this path as it contains no fill style
-          continue;
-        } 
+      if ((this_path_gnash.m_fill0==0) && (this_path_gnash.m_fill1==0)) {
+        // Skip this path as it contains no fill style
+        continue;
+      } 
+        
+      PathReader this_path_agg(agg_paths[pno]);
+      agg::conv_curve<PathReader> curve(this_path_agg);        
         
-        // Tell the rasterizer which styles the following path will use.
-        // The good thing is, that it already supports two fill styles out of
-        // the box. 
-        // Flash uses value "0" for "no fill", whereas AGG uses "-1" for that. 
-        rasc.styles(this_path_gnash.m_fill0-1, this_path_gnash.m_fill1-1);
+      // Tell the rasterizer which styles the following path will use.
+      // The good thing is, that it already supports two fill styles out of
+      // the box. 
+      // Flash uses value "0" for "no fill", whereas AGG uses "-1" for that. 
+      rasc.styles(this_path_gnash.m_fill0-1, this_path_gnash.m_fill1-1);
                 
-        // add path to the compound rasterizer
-        rasc.add_path(curve);
+      // add path to the compound rasterizer
+      rasc.add_path(curve);
       
+    }
+
+    agg::render_scanlines_compound_layered(rasc, sl, rbase, alloc, sh);
+  }
+
+  /// Return the width in pixels of a stroke drawn with a line style.
+  static float strokeWidth(const LineStyle& lstyle, float stroke_scale) {
+
+    const int thickness = lstyle.getThickness();
+    if (!thickness) return 1; // hairline
+
+    if (!lstyle.scaleThicknessVertically() &&
+            !lstyle.scaleThicknessHorizontally()) {
+      return twipsToPixels(thickness);
+    }
+
+    if ((!lstyle.scaleThicknessVertically()) ||
+            (!lstyle.scaleThicknessHorizontally()))
+    {
+       LOG_ONCE(log_unimpl(_("Unidirectionally scaled strokes in "
+               "AGG renderer (we'll scale by the "
+               "scalable one)")) );
+    }
+    return std::max(1.0f, thickness*stroke_scale);
+  }
+
+  /// Return how far strokes drawn with any of the line styles may reach
+  /// outside the object bounds, in pixels.
+  static int strokeMargin(const std::vector<LineStyle>& line_styles,
+          float stroke_scale) {
+
+    float reach = 0;
+    for (const LineStyle& lstyle : line_styles) {
+      float r = strokeWidth(lstyle, stroke_scale);
+      // Miter joins reach out to the miter limit, in half widths.
+      if (lstyle.joinStyle() == JOIN_MITER) {
+        r *= std::max(1.0f, lstyle.miterLimitFactor() / 2);
       }
+      reach = std::max(reach, r);
+    }
+    return static_cast<int>(std::ceil(reach)) + 1;
+  }
+
+  /// Split a clipping rectangle into bands for the worker threads.
+  //
+  /// Only the part covered by the selected object (see select_clipbounds())
+  /// is split. The object bounds are grown by a margin for whatever is
+  /// drawn outside them: at least the anti-aliased edge, and strokes.
+  //
+  /// @return   false if the object is too small to be worth it, or there
+  ///           are no worker threads.
+  bool split_bands(const geometry::Range2d<int>& bounds, int margin,
+          ClipBounds& bands) const {
+
+    if (!_bandWorkers || _selectedRange.isNull()) return false;
 
-      agg::render_scanlines_compound_layered(rasc, sl, rbase, alloc, sh);
+    geometry::Range2d<int> selected = _selectedRange;
+    selected.growBy(margin);
+
+    const geometry::Range2d<int> area = Intersection(bounds, selected);
+    if (area.isNull()) return false;
+
+    const int rows = area.height() + 1;
+    if (static_cast<long>(area.width() + 1) * rows < minParallelPixels) {
+      return false;
     }
-    
-  } // draw_shape_impl
+
+    const int count = std::min<int>(_bandWorkers->size(), rows / minBandRows);
+    if (count < 2) return false;
+
+    // Bands span the whole clipping rectangle horizontally; only rows
+    // the object covers are worth splitting.
+    bands.clear();
+    int y = area.getMinY();
+    for (int i = 0; i < count; ++i) {
+      const int end = area.getMinY() + rows * (i + 1) / count;
+      bands.push_back(geometry::Range2d<int>(bounds.getMinX(), y,
+                  bounds.getMaxX(), end - 1));
+      y = end;
+    }
+    return true;
+  }
 
 
 
@@ -1672,85 +2361,91 @@ public:
     typedef agg::rasterizer_scanline_aa<> ras_type; 
     ras_type ras;  // anti alias
 
+    ClipBounds bands;
+    const int margin = strokeMargin(line_styles, stroke_scale);
+    
+    for (const geometry::Range2d<int>* bounds : _clipbounds_selected) {
+
+      if (split_bands(*bounds, margin, bands)) {
+        _bandWorkers->run(bands.size(), [&](size_t i) {
+          ras_type bandRas;
+          std::unique_ptr<scanline_type> bandSl;
+          makeScanline(bandSl, _alphaMasks);
+          stroke_band(bandRas, bands[i], paths, agg_paths, line_styles, cx,
+                  stroke_scale, *bandSl);
+        });
+        continue;
+      }
+
+      stroke_band(ras, *bounds, paths, agg_paths, line_styles, cx,
+              stroke_scale, sl);
+    }
+      
+  } // draw_outlines_impl
+
+  /// Rasterize the outlines of a shape within one clipping rectangle.
+  //
+  /// Like fill_band(), this may run on several threads at once.
+  template <class ras_type, class scanline_type>
+  void stroke_band(ras_type& ras, const geometry::Range2d<int>& bounds,
+    const GnashPaths &paths, const AggPaths& agg_paths,
+    const std::vector<LineStyle> &line_styles, const SWFCxForm& cx,
+    float stroke_scale, scanline_type& sl) const {
+
     renderer_base& rbase = *m_rbase;
 
     agg::renderer_scanline_aa_solid<
       agg::renderer_base<PixelFormat> > ren_sl(rbase); // solid fills
-      
-    
-    for (const geometry::Range2d<int>* bounds : _clipbounds_selected) {
 
-      applyClipBox<ras_type> (ras, *bounds);
+    applyClipBox<ras_type> (ras, bounds);
       
-      for (size_t pno=0, pcount=paths.size(); pno<pcount; ++pno) {
+    for (size_t pno=0, pcount=paths.size(); pno<pcount; ++pno) {
 
-        const Path& this_path_gnash = paths[pno];
+      const Path& this_path_gnash = paths[pno];
 
-        agg::path_storage &this_path_agg = 
-          const_cast<agg::path_storage&>(agg_paths[pno]);
-        
-        if (this_path_gnash.m_line==0) {
-          // Skip this path as it contains no line style
-          continue;
-        } 
+      if (this_path_gnash.m_line==0) {
+        // Skip this path as it contains no line style
+        continue;
+      } 
         
-        agg::conv_curve< agg::path_storage > curve(this_path_agg); // to render curves
-        agg::conv_stroke< agg::conv_curve < agg::path_storage > > 
-          stroke(curve);  // to get an outline
+      PathReader this_path_agg(agg_paths[pno]);
+      agg::conv_curve<PathReader> curve(this_path_agg); // to render curves
+      agg::conv_stroke<agg::conv_curve<PathReader> > 
+        stroke(curve);  // to get an outline
 
-        const LineStyle& lstyle = line_styles[this_path_gnash.m_line-1];
+      const LineStyle& lstyle = line_styles[this_path_gnash.m_line-1];
           
-        int thickness = lstyle.getThickness();
-        if (!thickness) stroke.width(1); // hairline
-        else if ( (!lstyle.scaleThicknessVertically()) && (!lstyle.scaleThicknessHorizontally()) )
-        {
-          stroke.width(twipsToPixels(thickness));
-        }
-        else
-        {
-          if ((!lstyle.scaleThicknessVertically()) ||
-                  (!lstyle.scaleThicknessHorizontally()))
-          {
-             LOG_ONCE(log_unimpl(_("Unidirectionally scaled strokes in "
-				   "AGG renderer (we'll scale by the "
-				   "scalable one)")) );
-          }
-          stroke.width(std::max(1.0f, thickness*stroke_scale));
-        }
+      stroke.width(strokeWidth(lstyle, stroke_scale));
         
-        // TODO: support endCapStyle
+      // TODO: support endCapStyle
         
-        // TODO: When lstyle.noClose==0 and the start and end point matches,
-        // then render a real join instead of the caps.
+      // TODO: When lstyle.noClose==0 and the start and end point matches,
+      // then render a real join instead of the caps.
 
-        switch (lstyle.startCapStyle()) {
-          case CAP_NONE   : stroke.line_cap(agg::butt_cap); break; 
-          case CAP_SQUARE : stroke.line_cap(agg::square_cap); break;          
-          default : case CAP_ROUND : stroke.line_cap(agg::round_cap); 
-        }
+      switch (lstyle.startCapStyle()) {
+        case CAP_NONE   : stroke.line_cap(agg::butt_cap); break; 
+        case CAP_SQUARE : stroke.line_cap(agg::square_cap); break;          
+        default : case CAP_ROUND : stroke.line_cap(agg::round_cap); 
+      }
         
-        switch (lstyle.joinStyle()) {
-          case JOIN_BEVEL : stroke.line_join(agg::bevel_join); break;
-          case JOIN_MITER : stroke.line_join(agg::miter_join); break;
-          default : case JOIN_ROUND : stroke.line_join(agg::round_join);
-        }
+      switch (lstyle.joinStyle()) {
+        case JOIN_BEVEL : stroke.line_join(agg::bevel_join); break;
+        case JOIN_MITER : stroke.line_join(agg::miter_join); break;
+        default : case JOIN_ROUND : stroke.line_join(agg::round_join);
+      }
         
-        stroke.miter_limit(lstyle.miterLimitFactor());
+      stroke.miter_limit(lstyle.miterLimitFactor());
                 
-        ras.reset();
-        ras.add_path(stroke);
+      ras.reset();
+      ras.add_path(stroke);
         
-        rgba color = cx.transform(lstyle.get_color());
-        ren_sl.color(agg::rgba8_pre(color.m_r, color.m_g, color.m_b, color.m_a));       
+      rgba color = cx.transform(lstyle.get_color());
+      ren_sl.color(agg::rgba8_pre(color.m_r, color.m_g, color.m_b, color.m_a));       
                 
-        agg::render_scanlines(ras, sl, ren_sl);
+      agg::render_scanlines(ras, sl, ren_sl);
         
-      }
-    
-    
     }
-      
-  } // draw_outlines_impl
+  }
 
 
   
@@ -2011,6 +2706,12 @@ private:  // private variables
     ClipBounds _clipbounds;
     std::vector< geometry::Range2d<int> const* > _clipbounds_selected;
 
+    /// Pixel bounds of the object selected by select_clipbounds()
+    geometry::Range2d<int> _selectedRange;
+
+    /// Threads for rasterizing large shapes, or null if disabled.
+    std::unique_ptr<BandWorkers> _bandWorkers;
+
     // this flag is set while a mask is drawn
     bool m_drawing_mask; 
 
@@ -2020,6 +2721,9 @@ private:  // private variables
     /// Cached fill style list with just one entry used for font rendering
     std::vector<FillStyle> m_single_FillStyles;
 
+    /// Coverage of recently drawn glyphs.
+    GlyphCache _glyphCache;
+
 
 };
 
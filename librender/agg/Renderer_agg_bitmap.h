@@ -19,15 +19,21 @@
 #ifndef BACKEND_RENDER_HANDLER_AGG_BITMAP_H
 #define BACKEND_RENDER_HANDLER_AGG_BITMAP_H
 
-#include <memory>
 #include <memory>
 #include <cstdint>
+#include <cassert>
+#include <agg_pixfmt_rgb_packed.h>
 
 #include "GnashImage.h"
 #include "CachedBitmap.h"
 
 namespace gnash {
 
+/// A bitmap for the AGG renderer.
+//
+/// The pixels are either a GnashImage or, for opaque bitmaps that are
+/// never changed, packed RGB565 to match a 16-bit framebuffer. A packed
+/// bitmap is unpacked again if its image is requested.
 class agg_bitmap_info : public CachedBitmap
 {
 public:
@@ -35,32 +41,109 @@ public:
     agg_bitmap_info(std::unique_ptr<image::GnashImage> im)
         :
         _image(im.release()),
+        _width(_image->width()),
+        _height(_image->height()),
         _bpp(_image->type() == image::TYPE_RGB ? 24 : 32)
     {
     }
+
+    /// Store an image as RGB565 if it is opaque.
+    //
+    /// @return     The packed bitmap, or null if the image has transparent
+    ///             pixels.
+    static agg_bitmap_info* createRGB565(const image::GnashImage& im) {
+
+        const bool alpha = im.type() == image::TYPE_RGBA;
+        if (alpha) {
+            for (const std::uint8_t* p = im.begin() + 3; p < im.end(); p += 4) {
+                if (*p != 0xff) return nullptr;
+            }
+        }
+
+        const size_t channels = alpha ? 4 : 3;
+        std::unique_ptr<std::uint16_t[]> packed(
+                new std::uint16_t[im.width() * im.height()]);
+
+        std::uint16_t* to = packed.get();
+        for (size_t y = 0; y < im.height(); ++y) {
+            const std::uint8_t* from = image::scanline(im, y);
+            for (size_t x = 0; x < im.width(); ++x, from += channels) {
+                *to++ = agg::blender_rgb565_pre::make_pix(from[0], from[1],
+                        from[2]);
+            }
+        }
+        return new agg_bitmap_info(std::move(packed), im.width(),
+                im.height());
+    }
   
     image::GnashImage& image() {
         assert(!disposed());
+        if (!_image) unpack();
         return *_image;
     }
   
     void dispose() {
         _image.reset();
+        _packed.reset();
     }
 
     bool disposed() const {
-        return !_image.get();
+        return !_image.get() && !_packed.get();
     }
    
-    int get_width() const { return _image->width(); }  
-    int get_height() const { return _image->height();  }  
+    int get_width() const { return _width; }  
+    int get_height() const { return _height; }  
+
+    /// 16 for packed RGB565, 24 for RGB and 32 for RGBA.
     int get_bpp() const { return _bpp; }  
-    int get_rowlen() const { return _image->stride(); }  
-    std::uint8_t* get_data() const { return _image->begin(); }
+
+    int get_rowlen() const {
+        return _packed ? _width * 2 : _image->stride();
+    }  
+
+    std::uint8_t* get_data() const {
+        return _packed ? reinterpret_cast<std::uint8_t*>(_packed.get()) :
+            _image->begin();
+    }
     
 private:
+
+    agg_bitmap_info(std::unique_ptr<std::uint16_t[]> packed, size_t width,
+            size_t height)
+        :
+        _packed(std::move(packed)),
+        _width(width),
+        _height(height),
+        _bpp(16)
+    {
+    }
+
+    /// Replace the packed pixels with an RGB image.
+    void unpack() {
+        std::unique_ptr<image::GnashImage> im(
+                new image::ImageRGB(_width, _height));
+
+        const std::uint16_t* from = _packed.get();
+        for (size_t y = 0; y < _height; ++y) {
+            std::uint8_t* to = image::scanline(*im, y);
+            for (size_t x = 0; x < _width; ++x) {
+                const agg::rgba8 c = agg::blender_rgb565_pre::make_color(*from++);
+                *to++ = c.r;
+                *to++ = c.g;
+                *to++ = c.b;
+            }
+        }
+        _image = std::move(im);
+        _packed.reset();
+        _bpp = 24;
+    }
   
     std::unique_ptr<image::GnashImage> _image;
+
+    std::unique_ptr<std::uint16_t[]> _packed;
+
+    size_t _width;
+    size_t _height;
   
     int _bpp;
       
@@ -0,0 +1,156 @@
+// 
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+// 
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef BACKEND_RENDER_HANDLER_AGG_GLYPHS_H
+#define BACKEND_RENDER_HANDLER_AGG_GLYPHS_H
+
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <boost/noncopyable.hpp>
+
+#include "Geometry.h"
+#include "swf/ShapeRecord.h"
+
+namespace gnash {
+
+/// Identifies a rasterized glyph.
+//
+/// Glyphs are drawn in pixel space with an axis-aligned scale; the
+/// translation only matters to a quarter of a pixel.
+struct GlyphKey
+{
+    const SWF::ShapeRecord* shape;
+
+    /// The scale from glyph units to 1/20 pixel, as in SWFMatrix.
+    std::int32_t xScale;
+    std::int32_t yScale;
+
+    /// The subpixel offset, in quarter pixels.
+    std::uint8_t subX;
+    std::uint8_t subY;
+
+    bool operator==(const GlyphKey& o) const {
+        return shape == o.shape && xScale == o.xScale &&
+            yScale == o.yScale && subX == o.subX && subY == o.subY;
+    }
+};
+
+struct GlyphKeyHash
+{
+    size_t operator()(const GlyphKey& k) const {
+        size_t h = reinterpret_cast<std::uintptr_t>(k.shape);
+        h = h * 31 + static_cast<std::uint32_t>(k.xScale);
+        h = h * 31 + static_cast<std::uint32_t>(k.yScale);
+        return h * 31 + (k.subX << 8 | k.subY);
+    }
+};
+
+/// The coverage of a rasterized glyph.
+struct GlyphMask
+{
+    /// Position of the top-left pixel relative to the glyph origin.
+    int x;
+    int y;
+
+    int width;
+    int height;
+
+    /// Identifies the outline the mask was made from, see
+    /// SWF::ShapeRecord::fingerprint().
+    std::uint64_t fingerprint;
+
+    /// width * height coverage values.
+    std::vector<std::uint8_t> covers;
+};
+
+/// A least-recently-used cache of glyph coverage masks.
+//
+/// Glyphs are identified by the address of their ShapeRecord. Fonts
+/// can go away with the movie that defined them and the address be
+/// reused, so every lookup also checks a fingerprint of the outline.
+class GlyphCache : boost::noncopyable
+{
+public:
+
+    /// @param budget   The maximum number of bytes of coverage to keep.
+    explicit GlyphCache(size_t budget)
+        :
+        _budget(budget),
+        _size(0)
+    {}
+
+    /// Find a glyph mask, making it the most recently used.
+    //
+    /// @return     The mask, or null if not cached or made from another
+    ///             outline.
+    const GlyphMask* find(const GlyphKey& key, std::uint64_t fingerprint) {
+        Index::iterator it = _index.find(key);
+        if (it == _index.end()) return nullptr;
+        if (it->second->second.fingerprint != fingerprint) {
+            erase(it);
+            return nullptr;
+        }
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return &it->second->second;
+    }
+
+    /// Add a glyph mask, dropping old ones if over budget.
+    const GlyphMask& insert(const GlyphKey& key, GlyphMask mask) {
+        Index::iterator it = _index.find(key);
+        if (it != _index.end()) erase(it);
+
+        _size += mask.covers.size();
+        _entries.emplace_front(key, std::move(mask));
+        _index[key] = _entries.begin();
+
+        while (_size > _budget && _entries.size() > 1) {
+            erase(_index.find(_entries.back().first));
+        }
+        return _entries.front().second;
+    }
+
+    /// Whether a mask of this many pixels is worth caching at all.
+    bool fits(size_t pixels) const {
+        return pixels <= _budget / 16;
+    }
+
+private:
+
+    typedef std::list<std::pair<GlyphKey, GlyphMask> > Entries;
+    typedef std::unordered_map<GlyphKey, Entries::iterator, GlyphKeyHash>
+        Index;
+
+    void erase(Index::iterator it) {
+        _size -= it->second->second.covers.size();
+        _entries.erase(it->second);
+        _index.erase(it);
+    }
+
+    const size_t _budget;
+    size_t _size;
+
+    /// Most recently used first.
+    Entries _entries;
+    Index _index;
+};
+
+} // namespace gnash
+
+#endif
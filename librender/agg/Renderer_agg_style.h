@@ -39,6 +39,7 @@
 #include <agg_span_image_filter_rgba.h>
 #include <agg_pixfmt_rgb.h>
 #include <agg_pixfmt_rgba.h>
+#include <agg_pixfmt_rgb_packed.h>
 #pragma GCC diagnostic pop
 
 #include "LinearRGB.h"
@@ -55,7 +56,7 @@ class StyleHandler;
 // Forward declarations.
 namespace {
 
-    /// Creates 8 bitmap functions
+    /// Creates 12 bitmap functions
     template<typename FillMode, typename Pixel>
             void storeBitmap(StyleHandler& st, const agg_bitmap_info* bi,
             const SWFMatrix& mat, const SWFCxForm& cx,
@@ -170,6 +171,109 @@ struct RGB
     };
 };
 
+/// Nearest neighbour span generator for packed RGB565 bitmaps.
+template<typename Source, typename Interpolator>
+class SpanRGB565NN : public agg::span_image_filter<Source, Interpolator>
+{
+public:
+    typedef agg::span_image_filter<Source, Interpolator> BaseType;
+
+    SpanRGB565NN(Source& src, Interpolator& inter)
+        :
+        BaseType(src, inter, nullptr)
+    {}
+
+    void generate(agg::rgba8* span, int x, int y, unsigned len) {
+        BaseType::interpolator().begin(x + BaseType::filter_dx_dbl(),
+                y + BaseType::filter_dy_dbl(), len);
+        do {
+            BaseType::interpolator().coordinates(&x, &y);
+            *span++ = agg::blender_rgb565_pre::make_color(
+                    *pixel(BaseType::source().span(
+                            x >> agg::image_subpixel_shift,
+                            y >> agg::image_subpixel_shift, 1)));
+            ++BaseType::interpolator();
+        } while (--len);
+    }
+
+private:
+    static const agg::int16u* pixel(const agg::int8u* p) {
+        return reinterpret_cast<const agg::int16u*>(p);
+    }
+};
+
+/// Bilinear span generator for packed RGB565 bitmaps.
+template<typename Source, typename Interpolator>
+class SpanRGB565Bilinear : public agg::span_image_filter<Source, Interpolator>
+{
+public:
+    typedef agg::span_image_filter<Source, Interpolator> BaseType;
+
+    SpanRGB565Bilinear(Source& src, Interpolator& inter)
+        :
+        BaseType(src, inter, nullptr)
+    {}
+
+    void generate(agg::rgba8* span, int x, int y, unsigned len) {
+        BaseType::interpolator().begin(x + BaseType::filter_dx_dbl(),
+                y + BaseType::filter_dy_dbl(), len);
+        do {
+            int xHr, yHr;
+            BaseType::interpolator().coordinates(&xHr, &yHr);
+            xHr -= BaseType::filter_dx_int();
+            yHr -= BaseType::filter_dy_int();
+
+            const int xLr = xHr >> agg::image_subpixel_shift;
+            const int yLr = yHr >> agg::image_subpixel_shift;
+            xHr &= agg::image_subpixel_mask;
+            yHr &= agg::image_subpixel_mask;
+
+            const unsigned scale = agg::image_subpixel_scale;
+            unsigned fg[3];
+            fg[0] = fg[1] = fg[2] = scale * scale / 2;
+
+            add(fg, BaseType::source().span(xLr, yLr, 2),
+                    (scale - xHr) * (scale - yHr));
+            add(fg, BaseType::source().next_x(), xHr * (scale - yHr));
+            add(fg, BaseType::source().next_y(), (scale - xHr) * yHr);
+            add(fg, BaseType::source().next_x(), xHr * yHr);
+
+            const int shift = agg::image_subpixel_shift * 2;
+            span->r = fg[0] >> shift;
+            span->g = fg[1] >> shift;
+            span->b = fg[2] >> shift;
+            span->a = agg::rgba8::base_mask;
+            ++span;
+            ++BaseType::interpolator();
+        } while (--len);
+    }
+
+private:
+    static void add(unsigned* fg, const agg::int8u* p, unsigned weight) {
+        const agg::rgba8 c = agg::blender_rgb565_pre::make_color(
+                *reinterpret_cast<const agg::int16u*>(p));
+        fg[0] += weight * c.r;
+        fg[1] += weight * c.g;
+        fg[2] += weight * c.b;
+    }
+};
+
+/// Class with typedefs for packed RGB565 operations.
+struct RGB565
+{
+    typedef agg::pixfmt_rgb565_pre PixelFormat;
+
+    template<typename SourceType, typename Interpolator>
+    struct Simple {
+        typedef SpanRGB565NN<SourceType, Interpolator> type;
+    };
+
+    template<typename SourceType, typename Interpolator>
+    struct AntiAlias {
+        typedef SpanRGB565Bilinear<SourceType, Interpolator> type;
+    };
+};
+
 /// Nearest Neighbour filter type for quick, lower quality scaling.
 template<typename P, typename W>
 struct NN : public FilterType<P, W>
@@ -586,6 +690,31 @@ private:
   
 };  // class agg_mask_style_handler
 
+/// Whether a bitmap fill is smoothed at a render quality.
+//
+/// - If unspecified, smooth when quality >= BEST
+/// - If ON or forced, smooth when quality > LOW
+/// - If OFF, don't smooth
+//
+/// TODO: take a forceBitmapSmoothing parameter.
+///       which should be computed by the VM looking
+///       at MovieClip.forceSmoothing.
+inline bool
+smoothBitmap(const BitmapFill& f, Quality quality)
+{
+    if (quality <= QUALITY_LOW) return false;
+
+    // TODO: if forceSmoothing is true, smooth !
+    switch (f.smoothingPolicy()) {
+        case BitmapFill::SMOOTHING_UNSPECIFIED:
+            return quality >= QUALITY_BEST;
+        case BitmapFill::SMOOTHING_ON:
+            return true;
+        default:
+            return false;
+    }
+}
+
 /// Style handler
 //
 /// Transfer FillStyles to agg styles.
@@ -623,28 +752,7 @@ struct AddStyles : boost::static_visitor<>
         m.concatenate(_fillMatrix);
         m.concatenate(_stageMatrix);
 
-        // Smoothing policy:
-        //
-        // - If unspecified, smooth when _quality >= BEST
-        // - If ON or forced, smooth when _quality > LOW
-        // - If OFF, don't smooth
-        //
-        // TODO: take a forceBitmapSmoothing parameter.
-        //       which should be computed by the VM looking
-        //       at MovieClip.forceSmoothing.
-        bool smooth = false;
-        if (_quality > QUALITY_LOW) {
-            // TODO: if forceSmoothing is true, smooth !
-            switch (f.smoothingPolicy()) {
-                case BitmapFill::SMOOTHING_UNSPECIFIED:
-                    if (_quality >= QUALITY_BEST) smooth = true;
-                    break;
-                case BitmapFill::SMOOTHING_ON:
-                    smooth = true;
-                    break;
-                default: break;
-            }
-        }
+        const bool smooth = smoothBitmap(f, _quality);
 
         const bool tiled = (f.type() == BitmapFill::TILED);
 
@@ -696,11 +804,16 @@ storeBitmap(StyleHandler& st, const agg_bitmap_info* bi,
         const SWFMatrix& mat, const SWFCxForm& cx, bool smooth)
 {
 
-    if (bi->get_bpp() == 24) {
-        storeBitmap<FillMode, RGB>(st, bi, mat, cx, smooth);
-        return;
+    switch (bi->get_bpp()) {
+        case 16:
+            storeBitmap<FillMode, RGB565>(st, bi, mat, cx, smooth);
+            return;
+        case 24:
+            storeBitmap<FillMode, RGB>(st, bi, mat, cx, smooth);
+            return;
+        default:
+            storeBitmap<FillMode, RGBA>(st, bi, mat, cx, smooth);
     }
-    storeBitmap<FillMode, RGBA>(st, bi, mat, cx, smooth);
 }
 
 template<typename Spread, typename Interpolation>
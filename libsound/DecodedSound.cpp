@@ -0,0 +1,100 @@
+// DecodedSound.cpp - decoded samples of an embedded sound, for gnash
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "DecodedSound.h"
+
+#include <cstdint>
+
+#include "EmbedSound.h"
+#include "SoundInfo.h"
+#include "MediaHandler.h"
+#include "AudioDecoder.h"
+#include "log.h"
+
+// Debug sound decoding
+//#define GNASH_DEBUG_SOUNDS_DECODING
+
+namespace gnash {
+namespace sound {
+
+DecodedSound::DecodedSound(const EmbedSound& def, media::MediaHandler& mh)
+    :
+    _def(def),
+    _decodingPosition(0),
+    _size(0)
+{
+    const media::SoundInfo& si = def.soundinfo;
+
+    media::AudioInfo info(si.getFormat(), si.getSampleRate(), 
+        si.is16bit() ? 2 : 1, si.isStereo(), 0, media::CODEC_TYPE_FLASH);
+
+    _decoder = mh.createAudioDecoder(info);
+}
+
+DecodedSound::~DecodedSound()
+{
+}
+
+bool
+DecodedSound::complete() const
+{
+    return _decodingPosition >= _def.size();
+}
+
+void
+DecodedSound::decodeNextBlock()
+{
+    // this value is arbitrary, things would also work
+    // with a smaller value, but 2^16 seems fast enough
+    // to decode not to bother further streamlining it
+    // See https://savannah.gnu.org/bugs/?25456 for a testcase
+    // showing the benefit of chunked decoding.
+    //
+    // NOTE: it is reccommended that chunkSize is a multiple
+    //       of 4-byte (16-bit stereo), see
+    //       https://savannah.gnu.org/patch/?8736
+    const std::uint32_t chunkSize = 65536;
+
+    std::uint32_t inputSize = _def.size() - _decodingPosition;
+    if (inputSize > chunkSize) inputSize = chunkSize;
+
+#ifdef GNASH_DEBUG_SOUNDS_DECODING
+    log_debug("  decoding %d bytes", inputSize);
+#endif
+
+    const std::uint8_t* input = _def.data(_decodingPosition);
+
+    std::uint32_t consumed = 0;
+    std::uint32_t decodedDataSize = 0;
+    std::uint8_t* decodedData = _decoder->decode(input, inputSize,
+            decodedDataSize, consumed);
+
+    _decodingPosition += consumed;
+
+    // A decoder that makes no progress would have us loop forever.
+    if (!consumed) _decodingPosition = _def.size();
+
+    _data.append(decodedData, decodedDataSize);
+    delete [] decodedData;
+
+    _size.store(_data.size(), std::memory_order_relaxed);
+}
+
+} // gnash.sound namespace
+} // namespace gnash
@@ -0,0 +1,100 @@
+// DecodedSound.h - decoded samples of an embedded sound, for gnash
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef SOUND_DECODEDSOUND_H
+#define SOUND_DECODEDSOUND_H
+
+#include <memory>
+#include <atomic>
+#include <boost/noncopyable.hpp>
+
+#include "SimpleBuffer.h" // for composition
+
+// Forward declarations
+namespace gnash {
+    namespace sound {
+        class EmbedSound;
+    }
+    namespace media {
+        class MediaHandler;
+        class AudioDecoder;
+    }
+}
+
+namespace gnash {
+namespace sound {
+
+/// The samples decoded so far from an EmbedSound.
+//
+/// All instances of an EmbedSound share one DecodedSound, so the sound
+/// is decoded only once however often it is played. Samples are kept
+/// exactly as decoded: volume and envelopes are applied by each instance
+/// when it fetches them.
+///
+/// Decoding is incremental and driven by whichever instance runs out
+/// of samples first.
+class DecodedSound : boost::noncopyable
+{
+public:
+
+    /// @param def  The sound to decode. It must outlive this object.
+    /// @param mh   The MediaHandler to create a decoder with.
+    DecodedSound(const EmbedSound& def, media::MediaHandler& mh);
+
+    ~DecodedSound();
+
+    /// The samples decoded so far, 16-bit stereo at 44100Hz.
+    const SimpleBuffer& data() const {
+        return _data;
+    }
+
+    /// The number of bytes decoded so far.
+    //
+    /// Unlike data(), this may be read while another thread decodes.
+    size_t size() const {
+        return _size.load(std::memory_order_relaxed);
+    }
+
+    /// Whether all of the sound has been decoded.
+    bool complete() const;
+
+    /// Decode the next block of the sound.
+    //
+    /// It's assumed !complete()
+    void decodeNextBlock();
+
+private:
+
+    const EmbedSound& _def;
+
+    std::unique_ptr<media::AudioDecoder> _decoder;
+
+    /// Current decoding position in the encoded stream
+    size_t _decodingPosition;
+
+    SimpleBuffer _data;
+
+    /// The size of _data, updated after each block.
+    std::atomic<size_t> _size;
+};
+
+} // gnash.sound namespace
+} // namespace gnash
+
+#endif // SOUND_DECODEDSOUND_H
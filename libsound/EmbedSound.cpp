@@ -24,6 +24,7 @@
 #include <cstdint>
 
 #include "EmbedSoundInst.h" 
+#include "DecodedSound.h"
 #include "SoundInfo.h"
 #include "MediaHandler.h" 
 #include "log.h"
@@ -77,6 +78,25 @@ EmbedSound::~EmbedSound()
     clearInstances();
 }
 
+std::shared_ptr<DecodedSound>
+EmbedSound::decoded(media::MediaHandler& mh)
+{
+    if (!_decoded) _decoded.reset(new DecodedSound(*this, mh));
+    return _decoded;
+}
+
+size_t
+EmbedSound::decodedSize() const
+{
+    return _decoded ? _decoded->size() : 0;
+}
+
+void
+EmbedSound::dropDecoded()
+{
+    _decoded.reset();
+}
+
 void
 EmbedSound::eraseActiveSound(EmbedSoundInst* inst)
 {
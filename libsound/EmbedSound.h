@@ -36,6 +36,7 @@ namespace gnash {
     namespace sound {
         class EmbedSoundInst;
         class InputStream;
+        class DecodedSound;
     }
     namespace media {
         class MediaHandler;
@@ -167,6 +168,25 @@ public:
     ///
     void eraseActiveSound(EmbedSoundInst* inst);
 
+    /// The decoded samples of this sound, shared by all its instances.
+    //
+    /// Decoding starts on first use.
+    ///
+    /// @param mh
+    ///     The MediaHandler to use for on-demand decoding
+    std::shared_ptr<DecodedSound> decoded(media::MediaHandler& mh);
+
+    /// Number of bytes of decoded samples held for this sound.
+    //
+    /// This is safe to call while the sound is being decoded.
+    size_t decodedSize() const;
+
+    /// Forget the decoded samples.
+    //
+    /// Playing instances keep theirs until they are done; the next
+    /// instance will decode the sound again.
+    void dropDecoded();
+
     /// Object holding information about the sound
     media::SoundInfo soundinfo;
 
@@ -179,6 +199,9 @@ private:
     /// The undecoded data
     std::unique_ptr<SimpleBuffer> _buf;
 
+    /// The decoded data, if any.
+    std::shared_ptr<DecodedSound> _decoded;
+
     /// Playing instances of this sound definition
     //
     /// Multithread access to this member is protected
@@ -24,14 +24,10 @@
 
 #include "SoundInfo.h" // for use
 #include "MediaHandler.h" // for use
-#include "AudioDecoder.h" // for use
 #include "SoundEnvelope.h" // for use
 #include "log.h" 
 #include "SoundUtils.h"
 
-// Debug sound decoding
-//#define GNASH_DEBUG_SOUNDS_DECODING
-
 // Debug sound mixing
 //#define GNASH_DEBUG_MIXING
 
@@ -43,8 +39,7 @@ EmbedSoundInst::EmbedSoundInst(EmbedSound& soundData,
             unsigned int inPoint, unsigned int outPoint,
             const SoundEnvelopes* env, int loopCount)
         :
-        LiveSound(mediaHandler, soundData.soundinfo, inPoint),
-        decodingPosition(0),
+        LiveSound(inPoint),
         loopCount(loopCount),
         // parameters are in stereo samples (44100 per second)
         // we double to take 2 channels into account
@@ -54,7 +49,8 @@ EmbedSoundInst::EmbedSoundInst(EmbedSound& soundData,
                    : outPoint * 4),
         envelopes(env),
         current_env(0),
-        _soundDef(soundData)
+        _soundDef(soundData),
+        _decoded(soundData.decoded(mediaHandler))
 {
 }
 
@@ -75,60 +71,23 @@ EmbedSoundInst::moreData()
             // negative count is documented to mean loop forever.
             if (loopCount > 0) --loopCount;
             restart();
+            current_env = 0;
             return true;
         }
         // Nothing more to do.
         return false;
     }
 
-    // It's not clear if this happens for Embedded sounds, but it
-    // would permit incremental decoding.
-    decodeNextBlock();
+    // Decoding is shared with the other instances, and incremental.
+    _decoded->decodeNextBlock();
     return true;
 }
 
 void
-EmbedSoundInst::decodeNextBlock()
+EmbedSoundInst::processSamples(std::int16_t* samples, unsigned int nSamples)
 {
-    //assert(!decodingCompleted());
-
-    // this value is arbitrary, things would also work
-    // with a smaller value, but 2^16 seems fast enough
-    // to decode not to bother further streamlining it
-    // See https://savannah.gnu.org/bugs/?25456 for a testcase
-    // showing the benefit of chunked decoding.
-    //
-    // NOTE: it is reccommended that chunkSize is a multiple
-    //       of 4-byte (16-bit stereo), see
-    //       https://savannah.gnu.org/patch/?8736
-    const std::uint32_t chunkSize = 65536;
-
-    std::uint32_t inputSize = _soundDef.size() - decodingPosition;
-    if ( inputSize > chunkSize ) inputSize = chunkSize;
-
-#ifdef GNASH_DEBUG_SOUNDS_DECODING
-    log_debug("  decoding %d bytes", inputSize);
-#endif
-
-    //assert(inputSize);
-    const std::uint8_t* input = _soundDef.data(decodingPosition);
-
-    std::uint32_t consumed = 0;
-    std::uint32_t decodedDataSize = 0;
-    std::uint8_t* decodedData = decoder().decode(input, inputSize,
-            decodedDataSize, consumed);
-
-    decodingPosition += consumed;
-
-    //assert(!(decodedDataSize%2));
-
-    // @todo I hope there are no alignment issues in this cast from int8_t* to int16_t* !
-    std::int16_t* samples = reinterpret_cast<std::int16_t*>(decodedData);
-    unsigned int nSamples = decodedDataSize/2;
-
 #ifdef GNASH_DEBUG_MIXING
-    log_debug("  applying volume/envelope to %d bytes (%d samples)"
-              " of decoded data", decodedDataSize, nSamples);
+    log_debug("  applying volume/envelope to %d samples", nSamples);
 #endif
 
     // Adjust volume
@@ -142,14 +101,6 @@ EmbedSoundInst::decodeNextBlock()
         unsigned int firstSample = playbackPosition() / 2;
         applyEnvelopes(samples, nSamples, firstSample, *envelopes);
     }
-
-#ifdef GNASH_DEBUG_MIXING
-    log_debug("  appending %d bytes to decoded buffer", decodedDataSize);
-#endif
-
-
-    // decodedData ownership transferred here
-    appendDecodedData(decodedData, decodedDataSize);
 }
 
 void
@@ -23,10 +23,12 @@
 #include <cassert>
 #include <cstdint> // For C99 int types
 #include <limits>
+#include <memory>
 
 #include "EmbedSound.h"
 #include "LiveSound.h"
 #include "SoundEnvelope.h" 
+#include "DecodedSound.h"
 
 // Forward declarations
 namespace gnash {
@@ -86,6 +88,14 @@ private:
 
     virtual bool moreData();
 
+    /// The samples shared by all instances of the EmbedSound.
+    virtual const SimpleBuffer& decodedData() const {
+        return _decoded->data();
+    }
+
+    /// Apply volume or envelopes to the samples being fetched.
+    virtual void processSamples(std::int16_t* samples, unsigned int nSamples);
+
     /// Apply envelope-volume adjustments
     //
     /// Modified envelopes cursor (current_env)
@@ -111,17 +121,9 @@ private:
 
     /// Return true if there's nothing more to decode
     virtual bool decodingCompleted() const {
-        return (decodingPosition >= _soundDef.size());
+        return _decoded->complete();
     }
 
-    /// Decode next input block
-    //
-    /// It's assumed !decodingCompleted()
-    virtual void decodeNextBlock();
-
-    /// Current decoding position in the encoded stream
-    unsigned long decodingPosition;
-
     /// Numbers of loops: -1 means loop forever, 0 means play once.
     /// For every loop completed, it is decremented.
     long loopCount;
@@ -144,6 +146,9 @@ private:
     ///
     EmbedSound& _soundDef;
 
+    /// The decoded data, shared with other instances
+    const std::shared_ptr<DecodedSound> _decoded;
+
 };
 
 
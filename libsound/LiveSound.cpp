@@ -40,6 +40,14 @@ LiveSound::LiveSound(media::MediaHandler& mh, const media::SoundInfo& info,
     createDecoder(mh, info);
 }
 
+LiveSound::LiveSound(size_t inPoint)
+    :
+    _inPoint(inPoint * 4),
+    _playbackPosition(_inPoint),
+    _samplesFetched(0)
+{
+}
+
 void
 LiveSound::createDecoder(media::MediaHandler& mh, const media::SoundInfo& si)
 {
@@ -63,6 +71,7 @@ LiveSound::fetchSamples(std::int16_t* to, unsigned int nSamples)
 
             if (availableSamples >= nSamples) {
                 std::copy(data, data + nSamples, to);
+                processSamples(to, nSamples);
                 fetchedSamples += nSamples;
 
                 // Update playback position (samples are 16bit)
@@ -74,6 +83,7 @@ LiveSound::fetchSamples(std::int16_t* to, unsigned int nSamples)
                 // not enough decoded samples available:
                 // copy what we have and go on
                 std::copy(data, data + availableSamples, to);
+                processSamples(to, availableSamples);
                 fetchedSamples += availableSamples;
 
                 // Update playback position (samples are 16bit)
@@ -57,13 +57,36 @@ protected:
     LiveSound(media::MediaHandler& mh, const media::SoundInfo& info,
             size_t inPoint);
 
+    /// Create a %sound instance that doesn't decode by itself
+    //
+    /// The subclass must provide the decoded data by overriding
+    /// decodedData().
+    ///
+    /// @param inPoint  Offset in output samples this instance should start
+    ///                 playing from.
+    explicit LiveSound(size_t inPoint);
+
     // Pointer handling and checking functions
     const std::int16_t* getDecodedData(unsigned long int pos) const {
-        assert(pos < _decodedData.size());
-        return reinterpret_cast<const std::int16_t*>(
-                _decodedData.data() + pos);
+        const SimpleBuffer& data = decodedData();
+        assert(pos < data.size());
+        return reinterpret_cast<const std::int16_t*>(data.data() + pos);
+    }
+
+    /// The buffer holding the decoded samples.
+    //
+    /// By default this is the buffer appendDecodedData() appends to.
+    virtual const SimpleBuffer& decodedData() const {
+        return _decodedData;
     }
 
+    /// Adjust samples on their way out of fetchSamples.
+    //
+    /// The default does nothing. The position of the first sample is
+    /// playbackPosition().
+    virtual void processSamples(std::int16_t* /*samples*/,
+            unsigned int /*nSamples*/) {}
+
     /// Called when more decoded sound data is required.
     //
     /// This will be called whenever no more decoded data is available
@@ -105,7 +128,7 @@ protected:
     /// from playback position on
     unsigned int decodedSamplesAhead() const {
 
-        const unsigned int dds = _decodedData.size();
+        const unsigned int dds = decodedData().size();
         if (dds <= _playbackPosition) return 0; 
 
         size_t bytesAhead = dds - _playbackPosition;
@@ -0,0 +1,198 @@
+// MixBus.cpp     Accumulator for mixing sound streams.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#include "MixBus.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+# include <arm_neon.h>
+# define GNASH_MIX_NEON
+#elif defined(__mips_msa)
+# include <msa.h>
+# define GNASH_MIX_MSA
+#endif
+
+namespace gnash {
+namespace sound {
+
+namespace {
+
+/// Volume is applied as a 2.14 fixed point gain.
+const int gainShift = 14;
+const int unityGain = 1 << gainShift;
+
+/// Add samples at unity gain.
+void
+addUnity(std::int32_t* acc, const std::int16_t* in, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        const __m128i x =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign-extend by placing each sample in the top half of a word.
+        const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+        const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+        __m128i* a = reinterpret_cast<__m128i*>(acc + i);
+        _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), lo));
+        _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), hi));
+    }
+#elif defined(GNASH_MIX_NEON)
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t x = vld1q_s16(in + i);
+        vst1q_s32(acc + i, vaddw_s16(vld1q_s32(acc + i), vget_low_s16(x)));
+        vst1q_s32(acc + i + 4,
+                vaddw_s16(vld1q_s32(acc + i + 4), vget_high_s16(x)));
+    }
+#elif defined(GNASH_MIX_MSA)
+    for (; i + 8 <= n; i += 8) {
+        const v8i16 x = __msa_ld_h(const_cast<std::int16_t*>(in + i), 0);
+        const v8i16 sign = __msa_clti_s_h(x, 0);
+        const v4i32 lo = (v4i32)__msa_ilvr_h(sign, x);
+        const v4i32 hi = (v4i32)__msa_ilvl_h(sign, x);
+        __msa_st_w(__msa_addv_w(__msa_ld_w(acc + i, 0), lo), acc + i, 0);
+        __msa_st_w(__msa_addv_w(__msa_ld_w(acc + i + 4, 0), hi),
+                acc + i + 4, 0);
+    }
+#endif
+    for (; i < n; ++i) acc[i] += in[i];
+}
+
+/// Add samples scaled by a gain.
+void
+addScaled(std::int32_t* acc, const std::int16_t* in, size_t n,
+        std::int16_t gain)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i g = _mm_set1_epi16(gain);
+    for (; i + 8 <= n; i += 8) {
+        const __m128i x =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i pl = _mm_mullo_epi16(x, g);
+        const __m128i ph = _mm_mulhi_epi16(x, g);
+        const __m128i lo =
+            _mm_srai_epi32(_mm_unpacklo_epi16(pl, ph), gainShift);
+        const __m128i hi =
+            _mm_srai_epi32(_mm_unpackhi_epi16(pl, ph), gainShift);
+        __m128i* a = reinterpret_cast<__m128i*>(acc + i);
+        _mm_storeu_si128(a, _mm_add_epi32(_mm_loadu_si128(a), lo));
+        _mm_storeu_si128(a + 1, _mm_add_epi32(_mm_loadu_si128(a + 1), hi));
+    }
+#elif defined(GNASH_MIX_NEON)
+    for (; i + 8 <= n; i += 8) {
+        const int16x8_t x = vld1q_s16(in + i);
+        const int32x4_t lo =
+            vshrq_n_s32(vmull_n_s16(vget_low_s16(x), gain), gainShift);
+        const int32x4_t hi =
+            vshrq_n_s32(vmull_n_s16(vget_high_s16(x), gain), gainShift);
+        vst1q_s32(acc + i, vaddq_s32(vld1q_s32(acc + i), lo));
+        vst1q_s32(acc + i + 4, vaddq_s32(vld1q_s32(acc + i + 4), hi));
+    }
+#elif defined(GNASH_MIX_MSA)
+    const v4i32 g = __msa_fill_w(gain);
+    for (; i + 8 <= n; i += 8) {
+        const v8i16 x = __msa_ld_h(const_cast<std::int16_t*>(in + i), 0);
+        const v8i16 sign = __msa_clti_s_h(x, 0);
+        v4i32 lo = (v4i32)__msa_ilvr_h(sign, x);
+        v4i32 hi = (v4i32)__msa_ilvl_h(sign, x);
+        lo = __msa_srai_w(__msa_mulv_w(lo, g), gainShift);
+        hi = __msa_srai_w(__msa_mulv_w(hi, g), gainShift);
+        __msa_st_w(__msa_addv_w(__msa_ld_w(acc + i, 0), lo), acc + i, 0);
+        __msa_st_w(__msa_addv_w(__msa_ld_w(acc + i + 4, 0), hi),
+                acc + i + 4, 0);
+    }
+#endif
+    for (; i < n; ++i) acc[i] += (in[i] * gain) >> gainShift;
+}
+
+/// Clip the accumulator to 16 bits.
+void
+clip(std::int16_t* to, const std::int32_t* acc, size_t n)
+{
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        const __m128i* a = reinterpret_cast<const __m128i*>(acc + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(to + i),
+                _mm_packs_epi32(_mm_loadu_si128(a), _mm_loadu_si128(a + 1)));
+    }
+#elif defined(GNASH_MIX_NEON)
+    for (; i + 8 <= n; i += 8) {
+        vst1q_s16(to + i, vcombine_s16(vqmovn_s32(vld1q_s32(acc + i)),
+                    vqmovn_s32(vld1q_s32(acc + i + 4))));
+    }
+#elif defined(GNASH_MIX_MSA)
+    for (; i + 8 <= n; i += 8) {
+        const v4i32 lo = __msa_sat_s_w(__msa_ld_w(
+                    const_cast<std::int32_t*>(acc + i), 0), 15);
+        const v4i32 hi = __msa_sat_s_w(__msa_ld_w(
+                    const_cast<std::int32_t*>(acc + i + 4), 0), 15);
+        __msa_st_h(__msa_pckev_h((v8i16)hi,
+                    (v8i16)lo), to + i, 0);
+    }
+#endif
+    for (; i < n; ++i) {
+        to[i] = std::max<std::int32_t>(-32768,
+                std::min<std::int32_t>(32767, acc[i]));
+    }
+}
+
+} // anonymous namespace
+
+MixBus::MixBus(size_t capacity)
+    :
+    _capacity(capacity),
+    _size(0),
+    _acc(new std::int32_t[capacity])
+{
+}
+
+void
+MixBus::clear(size_t nSamples)
+{
+    assert(nSamples <= _capacity);
+    _size = nSamples;
+    std::fill(_acc.get(), _acc.get() + _size, 0);
+}
+
+void
+MixBus::add(const std::int16_t* samples, size_t nSamples, float volume)
+{
+    nSamples = std::min(nSamples, _size);
+
+    const int gain = std::min<int>(32767, volume * unityGain + 0.5f);
+    if (gain <= 0 || !nSamples) return;
+
+    if (gain == unityGain) addUnity(_acc.get(), samples, nSamples);
+    else addScaled(_acc.get(), samples, nSamples, gain);
+}
+
+void
+MixBus::output(std::int16_t* to) const
+{
+    clip(to, _acc.get(), _size);
+}
+
+} // namespace sound
+} // namespace gnash
@@ -0,0 +1,79 @@
+// MixBus.h     Accumulator for mixing sound streams.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_SOUND_MIXBUS_H
+#define GNASH_SOUND_MIXBUS_H
+
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <boost/noncopyable.hpp>
+
+namespace gnash {
+namespace sound {
+
+/// Mixes 16-bit sample streams into a 32-bit accumulator.
+//
+/// Streams are summed without clipping, which happens once when the
+/// mix is output. The accumulator is allocated once, so mixing never
+/// allocates; use it from one thread only.
+///
+/// The kernels use SSE2, NEON or MSA when the compiler targets them.
+class MixBus : boost::noncopyable
+{
+public:
+
+    /// @param capacity     The most samples that can be mixed at once.
+    explicit MixBus(size_t capacity);
+
+    size_t capacity() const { return _capacity; }
+
+    /// Start a new, silent mix.
+    //
+    /// @param nSamples     The length of the mix, at most capacity().
+    void clear(size_t nSamples);
+
+    /// Add samples to the mix.
+    //
+    /// @param samples      The samples to add.
+    /// @param nSamples     How many; at most the length of the mix. Any
+    ///                     shortfall leaves the end of the mix alone.
+    /// @param volume       The volume to add the samples at, as a
+    ///                     fraction (0..1).
+    void add(const std::int16_t* samples, size_t nSamples, float volume);
+
+    /// Write the mix out, clipped to 16 bits.
+    //
+    /// @param to   Receives as many samples as were passed to clear().
+    void output(std::int16_t* to) const;
+
+private:
+
+    const size_t _capacity;
+
+    /// The length of the current mix.
+    size_t _size;
+
+    const std::unique_ptr<std::int32_t[]> _acc;
+};
+
+} // namespace sound
+} // namespace gnash
+
+#endif
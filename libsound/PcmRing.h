@@ -0,0 +1,115 @@
+// PcmRing.h     A lock-free ring of decoded samples.
+//
+//   Copyright (C) 2005, 2006, 2007, 2008, 2009, 2010, 2011, 2012
+//   Free Software Foundation, Inc
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+#ifndef GNASH_SOUND_PCMRING_H
+#define GNASH_SOUND_PCMRING_H
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <boost/noncopyable.hpp>
+
+namespace gnash {
+namespace sound {
+
+/// A fixed-size ring of 16-bit samples for one producer and one consumer.
+//
+/// One thread may write() while another thread read()s without any
+/// locking. Neither side ever blocks or allocates.
+class PcmRing : boost::noncopyable
+{
+public:
+
+    /// @param capacity     The number of samples the ring can hold. This
+    ///                     is rounded up to a power of two.
+    explicit PcmRing(size_t capacity)
+        :
+        _mask(roundUp(capacity) - 1),
+        _data(new std::int16_t[_mask + 1]),
+        _readPos(0),
+        _writePos(0)
+    {}
+
+    size_t capacity() const { return _mask + 1; }
+
+    /// The number of samples ready to read.
+    size_t available() const {
+        return _writePos.load(std::memory_order_acquire) -
+            _readPos.load(std::memory_order_relaxed);
+    }
+
+    /// The number of samples that can be written.
+    size_t space() const {
+        return capacity() - (_writePos.load(std::memory_order_relaxed) -
+            _readPos.load(std::memory_order_acquire));
+    }
+
+    /// Append samples. Only the producer may call this.
+    //
+    /// @return     The number of samples written, which is less than
+    ///             nSamples if the ring is full.
+    size_t write(const std::int16_t* from, size_t nSamples) {
+        const size_t w = _writePos.load(std::memory_order_relaxed);
+        const size_t n = std::min(nSamples, space());
+        const size_t start = w & _mask;
+        const size_t first = std::min(n, capacity() - start);
+        std::copy(from, from + first, _data.get() + start);
+        std::copy(from + first, from + n, _data.get());
+        _writePos.store(w + n, std::memory_order_release);
+        return n;
+    }
+
+    /// Remove samples. Only the consumer may call this.
+    //
+    /// @return     The number of samples read, which is less than
+    ///             nSamples if the ring ran dry.
+    size_t read(std::int16_t* to, size_t nSamples) {
+        const size_t r = _readPos.load(std::memory_order_relaxed);
+        const size_t n = std::min(nSamples, available());
+        const size_t start = r & _mask;
+        const size_t first = std::min(n, capacity() - start);
+        std::copy(_data.get() + start, _data.get() + start + first, to);
+        std::copy(_data.get(), _data.get() + (n - first), to + first);
+        _readPos.store(r + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+
+    static size_t roundUp(size_t n) {
+        size_t ret = 1;
+        while (ret < n) ret <<= 1;
+        return ret;
+    }
+
+    const size_t _mask;
+
+    const std::unique_ptr<std::int16_t[]> _data;
+
+    /// Total samples ever read and written; the difference is the fill.
+    std::atomic<size_t> _readPos;
+    std::atomic<size_t> _writePos;
+};
+
+} // namespace sound
+} // namespace gnash
+
+#endif
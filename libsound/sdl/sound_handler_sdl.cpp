@@ -31,6 +31,8 @@
 #include "GnashException.h" // for SoundException
 
 #include <vector>
+#include <algorithm>
+#include <chrono>
 #include <SDL.h>
 
 // Define this to get debugging call about pausing/unpausing audio
@@ -43,6 +45,30 @@
 namespace gnash {
 namespace sound {
 
+namespace {
+
+/// How many samples to decode ahead for each InputStream.
+//
+/// This is about 90ms of 44.1kHz stereo, enough to ride out a slow
+/// decode without drifting far from the movie.
+const size_t channelSamples = 8192;
+
+/// How many samples to mix from a Channel at once.
+const size_t mixChunk = 2048;
+
+/// How often the decoder thread looks for more data from a stream that
+/// had none ready.
+const std::chrono::milliseconds decodeInterval(10);
+
+}
+
+SDL_sound_handler::Channel::Channel(InputStream* s)
+    :
+    stream(s),
+    ring(channelSamples),
+    finished(false)
+{
+}
 
 void
 SDL_sound_handler::initAudio()
@@ -106,9 +132,14 @@ SDL_sound_handler::closeAudio()
 SDL_sound_handler::SDL_sound_handler(media::MediaHandler* m)
     :
     sound_handler(m),
-    _audioOpened(false)
+    _audioOpened(false),
+    _mixBus(mixChunk),
+    _mixBuffer(new std::int16_t[mixChunk]),
+    _decodeBuffer(new std::int16_t[channelSamples]),
+    _stopDecoding(false)
 {
     initAudio();
+    _decoder = std::thread(&SDL_sound_handler::decodeLoop, this);
 }
 
 void
@@ -120,6 +151,13 @@ SDL_sound_handler::reset()
 
 SDL_sound_handler::~SDL_sound_handler()
 {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopDecoding = true;
+    }
+    _decodeCond.notify_one();
+    _decoder.join();
+
     std::lock_guard<std::mutex> lock(_mutex);
 
 #ifdef GNASH_DEBUG_SDL_AUDIO_PAUSING
@@ -239,17 +277,103 @@ create_sound_handler_sdl(media::MediaHandler* m)
 void
 SDL_sound_handler::fetchSamples(std::int16_t* to, unsigned int nSamples)
 {
-    std::lock_guard<std::mutex> lock(_mutex);
-    sound_handler::fetchSamples(to, nSamples);
+    if (isPaused()) return;
+
+    const float finalVolumeFact = getFinalVolume() / 100.0;
 
-    // If nothing is left to play there is no reason to keep polling.
-    if ( ! hasInputStreams() )
     {
+        std::lock_guard<std::mutex> lock(_mixMutex);
+
+        for (unsigned int done = 0; done < nSamples;) {
+
+            const size_t chunk = std::min<size_t>(nSamples - done, mixChunk);
+
+            _mixBus.clear(chunk);
+
+            // A Channel that ran dry contributes silence for the rest.
+            for (const std::unique_ptr<Channel>& c : _channels) {
+                const size_t got = c->ring.read(_mixBuffer.get(), chunk);
+                _mixBus.add(_mixBuffer.get(), got, finalVolumeFact);
+            }
+
+            _mixBus.output(to + done);
+            done += chunk;
+        }
+
+        // If nothing is left to play there is no reason to keep polling.
+        // This is done with the lock held, so that a stream plugged
+        // meanwhile is sure to unpause audio again.
+        if (_channels.empty()) {
 #ifdef GNASH_DEBUG_SDL_AUDIO_PAUSING
-        log_debug("Pausing SDL Audio...");
+            log_debug("Pausing SDL Audio...");
+#endif
+            SDL_PauseAudio(1);
+        }
+    }
+
+    // Refill what was just consumed.
+    _decodeCond.notify_one();
+
+    finishMix(to, nSamples);
+}
+
+void
+SDL_sound_handler::decodeLoop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stopDecoding) {
+        // Otherwise there is nothing to do until a stream is plugged in
+        // or the audio thread has mixed, and both wake us up. A wakeup
+        // missed while decoding is repeated by the next mix, long before
+        // the Channels run dry.
+        if (decodeChannels()) _decodeCond.wait_for(lock, decodeInterval);
+        else _decodeCond.wait(lock);
+    }
+}
+
+bool
+SDL_sound_handler::decodeChannels()
+{
+    bool starved = false;
+
+    for (const std::unique_ptr<Channel>& c : _channels) {
+        if (c->finished) continue;
+
+        // Whole stereo frames only.
+        const unsigned int wanted = c->ring.space() & ~1u;
+        if (!wanted) continue;
+
+        const unsigned int wrote =
+            c->stream->fetchSamples(_decodeBuffer.get(), wanted);
+        c->ring.write(_decodeBuffer.get(), wrote);
+
+        if (c->stream->eof()) c->finished = true;
+        else if (wrote < wanted) starved = true;
+    }
+
+    // Streams are only unplugged once everything they produced was mixed.
+    for (size_t i = 0; i < _channels.size();) {
+        const Channel& c = *_channels[i];
+        if (c.finished && !c.ring.available()) {
+#ifdef GNASH_DEBUG_MIXING
+            log_debug("Input stream %p reached EOF, unplugging", c.stream);
 #endif
-        SDL_PauseAudio(1);
+            // This erases the Channel through inputStreamRemoved().
+            sound_handler::unplugInputStream(c.stream);
+        }
+        else ++i;
     }
+    return starved;
+}
+
+void
+SDL_sound_handler::inputStreamRemoved(InputStream* is)
+{
+    std::lock_guard<std::mutex> lock(_mixMutex);
+    _channels.erase(std::remove_if(_channels.begin(), _channels.end(),
+                [is](const std::unique_ptr<Channel>& c) {
+                    return c->stream == is;
+                }), _channels.end());
 }
 
 // Callback invoked by the SDL audio thread.
@@ -298,8 +422,15 @@ SDL_sound_handler::plugInputStream(std::unique_ptr<InputStream> newStreamer)
 {
     std::lock_guard<std::mutex> lock(_mutex);
 
+    InputStream* stream = newStreamer.get();
     sound_handler::plugInputStream(std::move(newStreamer));
 
+    {
+        std::lock_guard<std::mutex> mixLock(_mixMutex);
+        _channels.emplace_back(new Channel(stream));
+    }
+    _decodeCond.notify_one();
+
     { // TODO: this whole block should only be executed when adding
       // the first stream. 
 
@@ -23,9 +23,16 @@
 
 
 #include "sound_handler.h" // for inheritance
+#include "PcmRing.h"
+#include "MixBus.h"
 
 #include <SDL_audio.h>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 // Forward declarations
 namespace gnash {
@@ -57,8 +64,68 @@ private:
     bool _audioOpened;
     
     /// Mutex for making sure threads doesn't mess things up
+    //
+    /// This is held by the decoder thread while it fetches samples from
+    /// the InputStreams, but never by the SDL audio thread.
     mutable std::mutex _mutex;
 
+    /// Samples decoded from a plugged InputStream, waiting to be mixed.
+    struct Channel
+    {
+        explicit Channel(InputStream* s);
+
+        /// Only touched by the decoder thread, with _mutex locked.
+        InputStream* const stream;
+
+        /// Filled by the decoder thread, drained by the audio thread.
+        PcmRing ring;
+
+        /// Set once the stream has nothing left to decode.
+        std::atomic<bool> finished;
+    };
+
+    typedef std::vector<std::unique_ptr<Channel>> Channels;
+
+    /// A Channel for each plugged InputStream.
+    //
+    /// Adding or removing Channels needs both _mutex and _mixMutex.
+    Channels _channels;
+
+    /// Held by the audio thread while mixing the Channels.
+    std::mutex _mixMutex;
+
+    /// Where the audio thread mixes the Channels.
+    MixBus _mixBus;
+
+    /// Buffer for reading a Channel, owned by the audio thread.
+    std::unique_ptr<std::int16_t[]> _mixBuffer;
+
+    /// Buffer for fetching from an InputStream, owned by the decoder.
+    std::unique_ptr<std::int16_t[]> _decodeBuffer;
+
+    /// Signalled when the Channels may need decoding.
+    std::condition_variable _decodeCond;
+
+    /// Set to stop the decoder thread, with _mutex locked.
+    bool _stopDecoding;
+
+    std::thread _decoder;
+
+    /// Body of the decoder thread.
+    void decodeLoop();
+
+    /// Top up every Channel and drop those that are finished.
+    //
+    /// Call with _mutex locked.
+    //
+    /// @return     Whether a stream had fewer samples ready than there
+    ///             was room for, so should be asked again soon.
+    bool decodeChannels();
+
+    // See dox in sound_handler.h
+    // Overridden to drop the Channel of the stream.
+    void inputStreamRemoved(InputStream* is);
+
     // See dox in sound_handler.h
     void mix(std::int16_t* outSamples, std::int16_t* inSamples,
                 unsigned int nSamples, float volume);
@@ -70,7 +137,8 @@ private:
     ///
     /// @param udata
     ///     User data pointer (SDL_sound_handler instance in our case).
-    ///     We'll lock the SDL_sound_handler::_mutex during operations.
+    ///     Only the SDL_sound_handler::_mixMutex is locked from here, so
+    ///     the audio thread never waits for sounds to be decoded.
     ///
     /// @param stream
     ///     The output stream/buffer to fill
@@ -147,6 +215,7 @@ public:
     void unplugInputStream(InputStream* id);
 
     // See dox in sound_handler.h
+    // Overridden to only mix samples decoded ahead by the decoder thread.
     void fetchSamples(std::int16_t* to, unsigned int nSamples);
 };
 
@@ -22,6 +22,7 @@
 #include <cstdint> // For C99 int types
 #include <vector> 
 #include <cmath> 
+#include <algorithm>
 
 #include "EmbedSound.h" // for use
 #include "InputStream.h" // for use
@@ -179,6 +180,7 @@ sound_handler::delete_all_sounds()
         delete sdef; 
     }
     _sounds.clear();
+    _decodedSounds.clear();
 
     for (StreamingSoundData* sdef : _streamingSounds)
     {
@@ -216,6 +218,7 @@ sound_handler::delete_sound(int handle)
     }
     
     stopEmbedSoundInstances(*def);
+    _decodedSounds.remove(def);
     delete def;
     _sounds[handle] = nullptr;
 
@@ -390,6 +393,8 @@ sound_handler::unplugInputStream(InputStream* id)
     log_debug("Unplugged InputStream %p", id);
 #endif
 
+    inputStreamRemoved(id);
+
     // Delete the InputStream (we own it..)
     delete id;
 }
@@ -602,6 +607,8 @@ sound_handler::startSound(int handle, int loops, const SoundEnvelopes* env,
                 sounddata.createInstance(*_mediaHandler, inPoint, outPoint,
                     env, loops));
         plugInputStream(std::move(sound));
+
+        touchDecodedSound(sounddata);
     }
     catch (const MediaException& e) {
         log_error(_("Could not start event sound: %s"), e.what());
@@ -609,6 +616,43 @@ sound_handler::startSound(int handle, int loops, const SoundEnvelopes* env,
 
 }
 
+void
+sound_handler::touchDecodedSound(EmbedSound& def)
+{
+    DecodedSounds::iterator it =
+        std::find(_decodedSounds.begin(), _decodedSounds.end(), &def);
+
+    if (it != _decodedSounds.end()) {
+        _decodedSounds.splice(_decodedSounds.begin(), _decodedSounds, it);
+    }
+    else _decodedSounds.push_front(&def);
+
+    trimDecodedSounds();
+}
+
+void
+sound_handler::trimDecodedSounds()
+{
+    // The most recently started sound is always kept.
+    DecodedSounds::iterator it = _decodedSounds.begin();
+    size_t total = 0;
+    for (; it != _decodedSounds.end(); ++it) {
+        total += (*it)->decodedSize();
+        if (total > _decodedSoundLimit && it != _decodedSounds.begin()) break;
+    }
+
+    // Playing instances keep their data, so this only stops it
+    // being reused.
+    while (it != _decodedSounds.end()) {
+#ifdef GNASH_DEBUG_SOUNDS_MANAGEMENT
+        log_debug("Dropping %d bytes of decoded sound %p",
+                (*it)->decodedSize(), *it);
+#endif
+        (*it)->dropDecoded();
+        it = _decodedSounds.erase(it);
+    }
+}
+
 void
 sound_handler::plugInputStream(std::unique_ptr<InputStream> newStreamer)
 {
@@ -635,8 +679,9 @@ sound_handler::plugInputStream(std::unique_ptr<InputStream> newStreamer)
 void
 sound_handler::unplugAllInputStreams()
 {
-    for (const InputStream* stream : _inputStreams)
+    for (InputStream* stream : _inputStreams)
     {
+        inputStreamRemoved(stream);
         delete stream;
     }
     _inputStreams.clear();
@@ -649,40 +694,50 @@ sound_handler::fetchSamples(std::int16_t* to, unsigned int nSamples)
 
     float finalVolumeFact = getFinalVolume()/100.0;
 
-    std::fill(to, to + nSamples, 0);
-
     // call NetStream or Sound audio callbacks
     if (!_inputStreams.empty()) {
 
-        // A buffer to fetch InputStream samples into
-        std::unique_ptr<std::int16_t[]> buf(new std::int16_t[nSamples]);
-
 #ifdef GNASH_DEBUG_SAMPLES_FETCHING 
         log_debug("Fetching %d samples from each of %d input streams", nSamples, _inputStreams.size());
 #endif
 
-        // Loop through the aux streamers sounds
-        for (InputStream* is : _inputStreams)
-        {
-            unsigned int wrote = is->fetchSamples(buf.get(), nSamples);
-            if (wrote < nSamples) {
-                // fill what wasn't written
-                std::fill(buf.get()+wrote, buf.get()+nSamples, 0);
-            }
+        // Mix as much as the bus holds at a time.
+        for (unsigned int done = 0; done < nSamples;) {
+
+            const unsigned int chunk =
+                std::min<size_t>(nSamples - done, _mixBus.capacity());
+
+            _mixBus.clear(chunk);
+
+            // Loop through the aux streamers sounds
+            for (InputStream* is : _inputStreams)
+            {
+                const unsigned int wrote =
+                    is->fetchSamples(_fetchBuffer.get(), chunk);
 
 #if GNASH_DEBUG_SAMPLES_FETCHING > 1
-            log_debug("  fetched %d/%d samples from input stream %p"
-                    " (%d samples fetchehd in total)",
-                    wrote, nSamples, is, is->samplesFetched());
+                log_debug("  fetched %d/%d samples from input stream %p"
+                        " (%d samples fetchehd in total)",
+                        wrote, chunk, is, is->samplesFetched());
 #endif
 
-            mix(to, buf.get(), nSamples, finalVolumeFact);
+                _mixBus.add(_fetchBuffer.get(), wrote, finalVolumeFact);
+            }
+
+            _mixBus.output(to + done);
+            done += chunk;
         }
 
         unplugCompletedInputStreams();
     }
+    else std::fill(to, to + nSamples, 0);
 
-    // TODO: move this to base class !
+    finishMix(to, nSamples);
+}
+
+void
+sound_handler::finishMix(std::int16_t* to, unsigned int nSamples)
+{
     if (_wavWriter.get()) {
         _wavWriter->pushSamples(to, nSamples);
 
@@ -772,6 +827,7 @@ sound_handler::unplugCompletedInputStreams()
             //          have an unplugCompletedInputStreams
             //          we may call it at heart-beating intervals
             //          and drop any threading paranoia!
+            inputStreamRemoved(is);
             delete is;
 
             // Increment number of sound stop request for the testing framework
@@ -25,6 +25,7 @@
 
 #include <atomic>
 #include <limits>
+#include <list>
 #include <memory>
 #include <set>
 #include <string>
@@ -34,6 +35,7 @@
 #include "SoundEnvelope.h" // for SoundEnvelopes typedef
 #include "AuxStream.h" // for aux_streamer_ptr typedef
 #include "WAVWriter.h"
+#include "MixBus.h"
 
 namespace gnash {
     namespace media {
@@ -455,6 +457,21 @@ public:
     /// @return true if any streaming sound is playing, false if not.
     bool streamingSound() const;
 
+    /// Set how many bytes of decoded event sounds to keep for replaying.
+    //
+    /// Event sounds are decoded once and shared by all their instances.
+    /// When the decoded sounds exceed this limit, those started least
+    /// recently are dropped and will be decoded again when next started.
+    void setDecodedSoundLimit(size_t bytes) {
+        _decodedSoundLimit = bytes;
+    }
+
+    /// Drop decoded sounds until the rest fit in the limit.
+    //
+    /// Sounds grow while they are decoded, so this should be called
+    /// regularly, not only when sounds are started.
+    void trimDecodedSounds();
+
 protected:
 
     sound_handler(media::MediaHandler* m)
@@ -464,7 +481,10 @@ protected:
         _paused(false),
         _muted(false),
         _volume(100),
-        _mediaHandler(m)
+        _mediaHandler(m),
+        _decodedSoundLimit(8 * 1024 * 1024),
+        _mixBus(mixBusSamples),
+        _fetchBuffer(new std::int16_t[mixBusSamples])
     {
     }
 
@@ -481,6 +501,17 @@ protected:
     /// Does the mixer have input streams ?
     bool hasInputStreams() const;
 
+    /// Called whenever a plugged InputStream is about to be deleted.
+    //
+    /// Subclasses keeping their own pointers to InputStreams must
+    /// forget them here.
+    virtual void inputStreamRemoved(InputStream* /*is*/) {}
+
+    /// Dump and mute mixed output as requested.
+    //
+    /// This is the last step of fetchSamples.
+    void finishMix(std::int16_t* to, unsigned int nSamples);
+
     /// Stop and delete all sounds
     //
     /// This is used only on reset.
@@ -535,8 +566,27 @@ private:
     /// Unplug any completed input stream
     void unplugCompletedInputStreams();
 
+    /// Mark a sound's decoded data as just used, and trim the others.
+    void touchDecodedSound(EmbedSound& def);
+
+    typedef std::list<EmbedSound*> DecodedSounds;
+
+    /// Sounds that may hold decoded data, most recently started first.
+    DecodedSounds _decodedSounds;
+
+    size_t _decodedSoundLimit;
+
     std::unique_ptr<WAVWriter> _wavWriter;
 
+    /// How many samples fetchSamples mixes at a time.
+    static const size_t mixBusSamples = 4096;
+
+    /// Where fetchSamples mixes the InputStreams.
+    MixBus _mixBus;
+
+    /// Buffer to fetch InputStream samples into.
+    std::unique_ptr<std::int16_t[]> _fetchBuffer;
+
 };
 
 // TODO: move to appropriate specific sound handlers